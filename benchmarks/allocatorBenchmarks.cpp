@@ -0,0 +1,173 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Allocator benchmarks
+//
+// Allocation and release throughput of the CoreLib pools against malloc,
+// single threaded and, for the thread safe pools, from several threads.
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <memory/alignment.h>
+#include <memory/arena.h>
+#include <memory/concurrentPool.h>
+#include <memory/objectPool.h>
+#include <memory/slabPool.h>
+#include <memory/staticPool.h>
+#include <memory/threadCachingPool.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+using namespace CoreLib::Memory;
+using namespace CoreLib::Benchmarks;
+
+namespace {
+
+	const size_t BATCH_SIZE = 1000;
+	const size_t MAX_BLOCK_SIZE = 256;
+
+	// deterministic mix of block sizes in [16, MAX_BLOCK_SIZE]
+	inline size_t blockSize( size_t i ) {
+		return 16 + ( ( i * 2654435761u ) >> 7 ) % ( MAX_BLOCK_SIZE - 15 );
+	}
+
+	struct MallocPool {
+		void* allocBytes( size_t bytes, size_t /*alignment*/ ) { return malloc( bytes ); }
+		void freeBytes( void* ptr, size_t /*bytes*/ ) { free( ptr ); }
+	};
+
+	struct NewPool {
+		void* allocBytes( size_t bytes, size_t /*alignment*/ ) { return ::operator new( bytes ); }
+		void freeBytes( void* ptr, size_t /*bytes*/ ) { ::operator delete( ptr ); }
+	};
+
+	// cache line aligned heap allocations
+	struct AlignedPool {
+		void* allocBytes( size_t bytes, size_t /*alignment*/ ) { return alignedAlloc( bytes, CACHE_LINE_SIZE ); }
+		void freeBytes( void* ptr, size_t /*bytes*/ ) { alignedFree( ptr, CACHE_LINE_SIZE ); }
+	};
+
+	// allocates a batch of blocks and releases them in allocation order
+	template< class Pool >
+	void allocFreeBatch( Pool& pool, size_t batches, bool fixedSize ) {
+		void* blocks[ BATCH_SIZE ];
+		for( size_t b = 0; b < batches; b++ ) {
+			for( size_t i = 0; i < BATCH_SIZE; i++ ) {
+				blocks[ i ] = pool.allocBytes( fixedSize ? MAX_BLOCK_SIZE : blockSize( i ), 16 );
+				*(char*)blocks[ i ] = (char)i;
+			}
+			doNotOptimize( blocks[ BATCH_SIZE - 1 ] );
+			for( size_t i = 0; i < BATCH_SIZE; i++ ) {
+				pool.freeBytes( blocks[ i ], fixedSize ? MAX_BLOCK_SIZE : blockSize( i ) );
+			}
+		}
+	}
+
+	template< class Pool >
+	void measureAllocFree( Context& context, const std::string& variant, Pool& pool, bool fixedSize = false ) {
+		context.measure( "allocator", "allocFree", variant, BATCH_SIZE, 1, [ & ]() {
+			allocFreeBatch( pool, 1, fixedSize );
+		} );
+	}
+
+	// bump allocators release everything at once, reset them outside the timed region
+	template< class Pool, class Reset >
+	void measureAllocReset( Context& context, const std::string& variant, Pool& pool, Reset reset ) {
+		context.measure( "allocator", "allocFree", variant, BATCH_SIZE, 1, reset, [ & ]() {
+			allocFreeBatch( pool, 1, false );
+		} );
+	}
+
+	template< class Pool >
+	void measureParallel( Context& context, const std::string& variant, Pool& pool, size_t threads, size_t batches ) {
+		context.measure( "allocator", "allocFreeParallel", variant, BATCH_SIZE * batches * threads, threads, [ & ]() {
+			std::vector< std::thread > workers;
+			for( size_t t = 0; t < threads; t++ ) {
+				workers.push_back( std::thread( [ & ]() { allocFreeBatch( pool, batches, false ); } ) );
+			}
+			for( size_t t = 0; t < threads; t++ ) {
+				workers[ t ].join();
+			}
+		} );
+	}
+
+	void runAllocatorBenchmarks( Context& context ) {
+		MallocPool mallocPool;
+		measureAllocFree( context, "malloc", mallocPool );
+
+		NewPool newPool;
+		measureAllocFree( context, "operator new", newPool );
+
+		AlignedPool alignedPool;
+		measureAllocFree( context, "alignedAlloc(64)", alignedPool );
+
+		SlabPool slabPool;
+		measureAllocFree( context, "SlabPool", slabPool );
+
+		FixedSizePool fixedPool( MAX_BLOCK_SIZE );
+		measureAllocFree( context, "FixedSizePool", fixedPool, true );
+
+		ThreadCachingPool cachingPool;
+		measureAllocFree( context, "ThreadCachingPool", cachingPool );
+
+		MemoryPool memoryPool( BATCH_SIZE * ( MAX_BLOCK_SIZE + 16 ) );
+		measureAllocReset( context, "MemoryPool", memoryPool, [ & ]() { memoryPool.clearMemory(); } );
+
+		Arena arena;
+		measureAllocReset( context, "Arena", arena, [ & ]() { arena.clearMemory(); } );
+
+		ConcurrentMemoryPool concurrentPool( BATCH_SIZE * ( MAX_BLOCK_SIZE + 16 ) );
+		measureAllocReset( context, "ConcurrentMemoryPool", concurrentPool, [ & ]() { concurrentPool.clearMemory(); } );
+
+		// thread safe pools under contention
+		const size_t batches = context.getOptions().quick ? 4 : 32;
+		for( size_t threads = 2; threads <= context.getOptions().maxThreads; threads *= 2 ) {
+			measureParallel( context, "malloc", mallocPool, threads, batches );
+			measureParallel( context, "ThreadCachingPool", cachingPool, threads, batches );
+
+			ConcurrentMemoryPool sharedPool( threads * batches * BATCH_SIZE * ( MAX_BLOCK_SIZE + 16 ) );
+			context.measure( "allocator", "allocFreeParallel", "ConcurrentMemoryPool", BATCH_SIZE * batches * threads, threads, 
+				[ & ]() { sharedPool.clearMemory(); },
+				[ & ]() {
+					std::vector< std::thread > workers;
+					for( size_t t = 0; t < threads; t++ ) {
+						workers.push_back( std::thread( [ & ]() { allocFreeBatch( sharedPool, batches, false ); } ) );
+					}
+					for( size_t t = 0; t < threads; t++ ) {
+						workers[ t ].join();
+					}
+				} );
+			sharedPool.destroy();
+		}
+
+		cachingPool.flushThreadCache();
+		memoryPool.destroy();
+		arena.destroy();
+		concurrentPool.destroy();
+		slabPool.destroy();
+		fixedPool.destroy();
+	}
+
+	SuiteRegistration allocatorSuite( "allocator", runAllocatorBenchmarks );
+}
@@ -0,0 +1,292 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+
+namespace CoreLib {
+namespace Benchmarks {
+
+	//////////////////////////////////////////////////////////////////////////
+	// Result
+	//
+	// Timing of a benchmark run, reported as one record of the output.
+	//////////////////////////////////////////////////////////////////////////
+	struct Result {
+		std::string		suite;		// e.g. "list"
+		std::string		benchmark;	// e.g. "append"
+		std::string		variant;	// e.g. "CoreLib::List<int>" or "std::vector<int>"
+		size_t			elements;	// operations per iteration
+		size_t			threads;
+		size_t			iterations;
+		double			seconds;	// average wall clock time per iteration
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Options
+	//////////////////////////////////////////////////////////////////////////
+	struct Options {
+		bool			quick;		// smaller sizes and shorter runs, for smoke testing
+		double			minTime;	// minimum time spent on each benchmark, in seconds
+		size_t			maxThreads;
+		std::string		filter;		// only run benchmarks whose "suite.benchmark" contains this
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// class Reporter
+	//
+	// Writes results as JSON lines (one object per line) or CSV, so they can
+	// be tracked over time.
+	//////////////////////////////////////////////////////////////////////////
+	class Reporter {
+	public:
+		enum Format {
+			FORMAT_JSON,
+			FORMAT_CSV
+		};
+
+		Reporter( FILE* out, Format format ) : out( out ), format( format ) {
+			if ( format == FORMAT_CSV ) {
+				fprintf( out, "suite,benchmark,variant,elements,threads,iterations,nsPerIteration,nsPerElement,elementsPerSecond\n" );
+			}
+		}
+
+		void add( const Result& result ) {
+			const double nsPerIteration = result.seconds * 1e9;
+			const double nsPerElement = nsPerIteration / (double)result.elements;
+			const double elementsPerSecond = (double)result.elements / result.seconds;
+			if ( format == FORMAT_CSV ) {
+				fprintf( out, "%s,%s,%s,%u,%u,%u,%.1f,%.3f,%.0f\n", 
+					csvField( result.suite ).c_str(), csvField( result.benchmark ).c_str(), csvField( result.variant ).c_str(), 
+					(unsigned int)result.elements, (unsigned int)result.threads, (unsigned int)result.iterations,
+					nsPerIteration, nsPerElement, elementsPerSecond );
+			} else {
+				fprintf( out, "{\"suite\":\"%s\",\"benchmark\":\"%s\",\"variant\":\"%s\",\"elements\":%u,\"threads\":%u,\"iterations\":%u,\"nsPerIteration\":%.1f,\"nsPerElement\":%.3f,\"elementsPerSecond\":%.0f}\n",
+					jsonString( result.suite ).c_str(), jsonString( result.benchmark ).c_str(), jsonString( result.variant ).c_str(), 
+					(unsigned int)result.elements, (unsigned int)result.threads, (unsigned int)result.iterations,
+					nsPerIteration, nsPerElement, elementsPerSecond );
+			}
+			fflush( out );
+		}
+
+	private:
+		// quotes the field if it holds a separator, quote or line break, 
+		// doubling any embedded quotes (RFC 4180)
+		static std::string csvField( const std::string& field ) {
+			if ( field.find_first_of( ",\"\r\n" ) == std::string::npos ) {
+				return field;
+			}
+			std::string quoted = "\"";
+			for( size_t i = 0; i < field.size(); i++ ) {
+				if ( field[ i ] == '"' ) {
+					quoted += '"';
+				}
+				quoted += field[ i ];
+			}
+			quoted += '"';
+			return quoted;
+		}
+
+		// escapes quotes, backslashes and control characters for use inside
+		// a JSON string
+		static std::string jsonString( const std::string& text ) {
+			std::string escaped;
+			for( size_t i = 0; i < text.size(); i++ ) {
+				const unsigned char c = (unsigned char)text[ i ];
+				if ( c == '"' || c == '\\' ) {
+					escaped += '\\';
+					escaped += (char)c;
+				} else if ( c < 0x20 ) {
+					char code[ 8 ];
+					snprintf( code, sizeof( code ), "\\u%04x", (unsigned int)c );
+					escaped += code;
+				} else {
+					escaped += (char)c;
+				}
+			}
+			return escaped;
+		}
+
+	private:
+		FILE*	out;
+		Format	format;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// class Context
+	//
+	// Passed to every suite: runs and reports the individual benchmarks.
+	//////////////////////////////////////////////////////////////////////////
+	class Context {
+	public:
+		Context( const Options& options, Reporter& reporter ) : options( options ), reporter( reporter ), failures( 0 ) {}
+
+		const Options& getOptions() const { return options; }
+
+		// suites checking their results report mismatches here, making the 
+		// benchmark run fail
+		void reportFailure( const std::string& message ) {
+			fprintf( stderr, "FAILED: %s\n", message.c_str() );
+			failures++;
+		}
+		size_t getFailures() const { return failures; }
+
+		bool enabled( const char* suite, const char* benchmark ) const {
+			return options.filter.empty() || ( std::string( suite ) + "." + benchmark ).find( options.filter ) != std::string::npos;
+		}
+
+		// Times run() until at least minTime has been spent (and at least 
+		// once after a warm up run). setup() is called before every run 
+		// and isn't timed.
+		template< class Setup, class Run >
+		void measure( const char* suite, const char* benchmark, const std::string& variant, size_t elements, size_t threads, Setup setup, Run run ) {
+			if ( !enabled( suite, benchmark ) ) {
+				return;
+			}
+
+			setup();
+			run();
+
+			double total = 0;
+			size_t iterations = 0;
+			while( total < options.minTime || iterations == 0 ) {
+				setup();
+				std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+				run();
+				std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+				total += std::chrono::duration< double >( end - begin ).count();
+				iterations++;
+			}
+
+			Result result;
+			result.suite = suite;
+			result.benchmark = benchmark;
+			result.variant = variant;
+			result.elements = elements;
+			result.threads = threads;
+			result.iterations = iterations;
+			result.seconds = total / (double)iterations;
+			reporter.add( result );
+		}
+
+		template< class Run >
+		void measure( const char* suite, const char* benchmark, const std::string& variant, size_t elements, size_t threads, Run run ) {
+			measure( suite, benchmark, variant, elements, threads, [](){}, run );
+		}
+
+	private:
+		const Options&	options;
+		Reporter&		reporter;
+		size_t			failures;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Suite registration
+	//
+	// Each benchmark source file registers its suite with a static 
+	// SuiteRegistration object.
+	//////////////////////////////////////////////////////////////////////////
+	typedef void SuiteFunction( Context& context );
+
+	struct SuiteRegistration {
+		SuiteRegistration( const char* name, SuiteFunction* function ) {
+			Suite suite = { name, function };
+			suites().push_back( suite );
+		}
+
+		struct Suite {
+			const char*		name;
+			SuiteFunction*	function;
+		};
+
+		static std::vector< Suite >& suites() {
+			static std::vector< Suite > registered;
+			return registered;
+		}
+	};
+
+	// keeps the optimizer from discarding a computed value
+	template< class T >
+	inline void doNotOptimize( const T& value ) {
+#if defined( __GNUC__ )
+		asm volatile( "" : : "r,m"( value ) : "memory" );
+#else
+		static volatile const T* sink;
+		sink = &value;
+#endif
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Shared helpers
+	//////////////////////////////////////////////////////////////////////////
+
+	// cheap, per thread deterministic allocation sizes in [minSize, maxSize)
+	inline size_t allocationSize( unsigned int& seed, size_t minSize, size_t maxSize ) {
+		seed = seed * 1664525u + 1013904223u;
+		return minSize + ( seed >> 16 ) % ( maxSize - minSize );
+	}
+
+	// runs job( thread ) on numThreads threads at once
+	template< class Job >
+	void runThreads( size_t numThreads, Job job ) {
+		std::vector< std::thread > threads;
+		for( size_t i = 0; i < numThreads; i++ ) {
+			threads.push_back( std::thread( job, i ) );
+		}
+		for( size_t i = 0; i < numThreads; i++ ) {
+			threads[ i ].join();
+		}
+	}
+
+	// runs worker( thread, begin, end ) over [0, n) split across numThreads
+	template< class Worker >
+	void runThreads( size_t numThreads, size_t n, Worker worker ) {
+		runThreads( numThreads, [ & ]( size_t thread ) {
+			worker( thread, n * thread / numThreads, n * ( thread + 1 ) / numThreads );
+		} );
+	}
+
+	// record written to and read from list files by the file benchmarks
+	struct FileRecord {
+		uint64_t	key;
+		float		weight;
+		int			value;
+	};
+
+	const uint32_t FILE_RECORD_VERSION = 1;
+
+	inline FileRecord makeFileRecord( size_t i ) {
+		FileRecord record;
+		record.key = i * 2654435761u;
+		record.weight = (float)i;
+		record.value = (int)i;
+		return record;
+	}
+
+} // namespace Benchmarks
+} // namespace CoreLib
@@ -0,0 +1,76 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// CoreLib benchmark suite
+//
+// usage: CoreLibBenchmarks [--csv] [--quick] [--filter=<text>] 
+//                          [--min-time=<seconds>] [--threads=<n>]
+//
+// Results are written to stdout as JSON lines (or CSV with --csv).
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+using namespace CoreLib::Benchmarks;
+
+int main( int argc, char** argv ) {
+	Options options;
+	options.quick = false;
+	options.minTime = 0.2;
+	options.maxThreads = std::thread::hardware_concurrency();
+	Reporter::Format format = Reporter::FORMAT_JSON;
+
+	for( int i = 1; i < argc; i++ ) {
+		if ( strcmp( argv[ i ], "--csv" ) == 0 ) {
+			format = Reporter::FORMAT_CSV;
+		} else if ( strcmp( argv[ i ], "--quick" ) == 0 ) {
+			options.quick = true;
+			options.minTime = 0.01;
+		} else if ( strncmp( argv[ i ], "--filter=", 9 ) == 0 ) {
+			options.filter = argv[ i ] + 9;
+		} else if ( strncmp( argv[ i ], "--min-time=", 11 ) == 0 ) {
+			options.minTime = atof( argv[ i ] + 11 );
+		} else if ( strncmp( argv[ i ], "--threads=", 10 ) == 0 ) {
+			options.maxThreads = (size_t)atoi( argv[ i ] + 10 );
+		} else {
+			fprintf( stderr, "usage: %s [--csv] [--quick] [--filter=<text>] [--min-time=<seconds>] [--threads=<n>]\n", argv[ 0 ] );
+			return 1;
+		}
+	}
+	if ( options.maxThreads == 0 ) {
+		options.maxThreads = 1;
+	}
+
+	Reporter reporter( stdout, format );
+	Context context( options, reporter );
+
+	const std::vector< SuiteRegistration::Suite >& suites = SuiteRegistration::suites();
+	for( size_t i = 0; i < suites.size(); i++ ) {
+		suites[ i ].function( context );
+	}
+
+	return context.getFailures() > 0 ? 1 : 0;
+}
@@ -0,0 +1,117 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Concurrent list benchmarks
+//
+// Collecting the results of a parallel stage into a single List: with a 
+// ConcurrentList, with per-thread lists merged under a lock, and with a 
+// single list behind a lock.
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <containers/concurrentList/concurrentList.h>
+#include <containers/list/list.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace CoreLib;
+using namespace CoreLib::Benchmarks;
+
+namespace {
+
+	typedef List< int, Memory::StandardAllocator< int >, GeometricGrowth<> > IntList;
+
+	void runCollectBenchmarks( Context& context, size_t n, size_t threads ) {
+		const char* suite = "concurrentList";
+		const size_t batch = 64;
+
+		context.measure( suite, "collect", "ConcurrentList::append", n, threads, [ & ]() {
+			ConcurrentList< int > collected;
+			runThreads( threads, n, [ & ]( size_t, size_t begin, size_t end ) {
+				for( size_t i = begin; i < end; i++ ) {
+					collected.append( (int)i );
+				}
+			} );
+			IntList result;
+			collected.moveTo( result );
+			doNotOptimize( result );
+		} );
+
+		context.measure( suite, "collect", "ConcurrentList::appendRange", n, threads, [ & ]() {
+			ConcurrentList< int > collected;
+			runThreads( threads, n, [ & ]( size_t, size_t begin, size_t end ) {
+				int values[ batch ];
+				for( size_t i = begin; i < end; i += batch ) {
+					const size_t count = end - i < batch ? end - i : batch;
+					for( size_t j = 0; j < count; j++ ) {
+						values[ j ] = (int)( i + j );
+					}
+					collected.appendRange( values, count );
+				}
+			} );
+			IntList result;
+			collected.moveTo( result );
+			doNotOptimize( result );
+		} );
+
+		context.measure( suite, "collect", "per-thread List + locked merge", n, threads, [ & ]() {
+			IntList result;
+			std::mutex mutex;
+			runThreads( threads, n, [ & ]( size_t, size_t begin, size_t end ) {
+				IntList local;
+				for( size_t i = begin; i < end; i++ ) {
+					local.append( (int)i );
+				}
+				std::lock_guard< std::mutex > lock( mutex );
+				result.append( local );
+			} );
+			doNotOptimize( result );
+		} );
+
+		context.measure( suite, "collect", "locked List::append", n, threads, [ & ]() {
+			IntList result;
+			std::mutex mutex;
+			runThreads( threads, n, [ & ]( size_t, size_t begin, size_t end ) {
+				for( size_t i = begin; i < end; i++ ) {
+					std::lock_guard< std::mutex > lock( mutex );
+					result.append( (int)i );
+				}
+			} );
+			doNotOptimize( result );
+		} );
+	}
+
+	void runConcurrentListSuite( Context& context ) {
+		const size_t n = context.getOptions().quick ? 200000 : 4000000;
+		const size_t maxThreads = context.getOptions().maxThreads;
+		for( size_t threads = 1; threads <= maxThreads; threads = threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2 ) {
+			runCollectBenchmarks( context, n, threads );
+			if ( threads == maxThreads ) {
+				break;
+			}
+		}
+	}
+
+	SuiteRegistration concurrentListSuite( "concurrentList", runConcurrentListSuite );
+}
@@ -0,0 +1,142 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Job system benchmarks
+//
+// Cost of starting and waiting on small jobs, and the List algorithms 
+// running on the JobSystem against sequential loops and against the same 
+// work on a ThreadExecutor, which starts its threads on every call, as the
+// number of threads grows.
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <algorithms/parallel.h>
+#include <algorithms/parallelSort.h>
+#include <containers/list/list.h>
+#include <jobs/jobSystem.h>
+#include <math.h>
+#include <atomic>
+#include <string>
+
+using namespace CoreLib;
+using namespace CoreLib::Benchmarks;
+
+namespace {
+
+	typedef List< float, Memory::StandardAllocator< float >, GeometricGrowth<> > FloatList;
+
+	inline float work( float x ) {
+		return sqrtf( x * x + 1.0f ) * 0.5f;
+	}
+
+	void runJobBenchmarks( Context& context, size_t n, size_t threads ) {
+		const char* suite = "jobs";
+		Jobs::JobSystem jobs( threads );
+		Algorithms::ThreadExecutor executor( threads );
+
+		FloatList input;
+		for( size_t i = 0; i < n; i++ ) {
+			input.append( (float)( i % 1000 ) );
+		}
+		FloatList output;
+
+		const size_t numJobs = n / 64;
+		context.measure( suite, "run", "JobSystem::run + wait", numJobs, threads, [ & ]() {
+			std::atomic< size_t > done( 0 );
+			Jobs::JobCounter counter;
+			for( size_t i = 0; i < numJobs; i++ ) {
+				jobs.run( [ &done ]() { done.fetch_add( 1, std::memory_order_relaxed ); }, counter );
+			}
+			jobs.wait( counter );
+			doNotOptimize( done );
+		} );
+
+		context.measure( suite, "parallelFor", "JobSystem::parallelFor(64)", 64, threads, [ & ]() {
+			std::atomic< size_t > done( 0 );
+			jobs.parallelFor( 64, [ &done ]( size_t ) { done.fetch_add( 1, std::memory_order_relaxed ); } );
+			doNotOptimize( done );
+		} );
+
+		context.measure( suite, "parallelFor", "ThreadExecutor::parallelFor(64)", 64, threads, [ & ]() {
+			std::atomic< size_t > done( 0 );
+			executor.parallelFor( 64, [ &done ]( size_t ) { done.fetch_add( 1, std::memory_order_relaxed ); } );
+			doNotOptimize( done );
+		} );
+
+		context.measure( suite, "transform", "sequential", n, 1, [ & ]() {
+			output.resize( n );
+			for( size_t i = 0; i < n; i++ ) {
+				output[ i ] = work( input[ i ] );
+			}
+			doNotOptimize( output );
+		} );
+
+		context.measure( suite, "transform", "Algorithms::parallelTransform", n, threads, [ & ]() {
+			Algorithms::parallelTransform( jobs, input, output, work );
+			doNotOptimize( output );
+		} );
+
+		context.measure( suite, "reduce", "sequential", n, 1, [ & ]() {
+			double sum = 0;
+			for( size_t i = 0; i < n; i++ ) {
+				sum += work( input[ i ] );
+			}
+			doNotOptimize( sum );
+		} );
+
+		context.measure( suite, "reduce", "Algorithms::parallelReduce", n, threads, [ & ]() {
+			doNotOptimize( Algorithms::parallelReduce( jobs, input, 0.0, []( double sum, float x ) { return sum + work( x ); }, []( double a, double b ) { return a + b; } ) );
+		} );
+
+		FloatList unsorted;
+		for( size_t i = 0; i < n; i++ ) {
+			unsorted.append( (float)( ( i * 2654435761u ) % 1000003 ) );
+		}
+		FloatList sorted;
+		auto reset = [ & ]() { sorted = unsorted; };
+		auto less = []( float a, float b ) { return a < b; };
+
+		context.measure( suite, "parallelSort", "ThreadExecutor", n, threads, reset, [ & ]() {
+			Algorithms::parallelSort( sorted, less, executor );
+			doNotOptimize( sorted );
+		} );
+
+		context.measure( suite, "parallelSort", "JobSystem", n, threads, reset, [ & ]() {
+			Algorithms::parallelSort( sorted, less, jobs );
+			doNotOptimize( sorted );
+		} );
+	}
+
+	void runJobSuite( Context& context ) {
+		const size_t n = context.getOptions().quick ? 100000 : 4000000;
+		const size_t maxThreads = context.getOptions().maxThreads;
+		for( size_t threads = 1; threads <= maxThreads; threads = threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2 ) {
+			runJobBenchmarks( context, n, threads );
+			if ( threads == maxThreads ) {
+				break;
+			}
+		}
+	}
+
+	SuiteRegistration jobSuite( "jobs", runJobSuite );
+}
@@ -0,0 +1,106 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Kernel benchmarks
+//
+// Times the search and reduction kernels for every instruction set the 
+// CPU supports. Their results are checked against the scalar ones by the
+// kernel tests (tests/kernelTests.cpp).
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <algorithms/kernels.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace CoreLib;
+using namespace CoreLib::Algorithms;
+using namespace CoreLib::Benchmarks;
+
+namespace {
+
+	const char* instructionSetName( Simd::InstructionSet instructionSet ) {
+		switch( instructionSet ) {
+			case Simd::INSTRUCTIONS_AVX2: return "avx2";
+			case Simd::INSTRUCTIONS_SSE2: return "sse2";
+			default: return "scalar";
+		}
+	}
+
+	// values within a small range, so that searches find duplicates
+	template< class T >
+	std::vector< T > makeData( size_t n, std::mt19937& random ) {
+		std::vector< T > data( n );
+		for( size_t i = 0; i < n; i++ ) {
+			data[ i ] = (T)( (int)( random() % 2001 ) - 1000 ) / (T)( std::is_floating_point< T >::value ? 8 : 1 );
+		}
+		return data;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// runKernelBenchmarks
+	//////////////////////////////////////////////////////////////////////////
+	template< class T >
+	void runKernelBenchmarks( Context& context, const std::string& typeName, size_t n ) {
+		const char* suite = "kernels";
+
+		std::mt19937 random( 42 );
+		const std::vector< T > data = makeData< T >( n, random );
+		const T* p = data.data();
+		const T missing = T( 5000 ); // scans the whole array
+
+		const Simd::InstructionSet supported = Simd::getSupportedInstructionSet();
+		for( int set = Simd::INSTRUCTIONS_SCALAR; set <= supported; set++ ) {
+			Simd::setInstructionSet( (Simd::InstructionSet)set );
+			const std::string variant = typeName + " " + instructionSetName( (Simd::InstructionSet)set );
+
+			context.measure( suite, "findIndex", variant, n, 1, [ & ]() {
+				doNotOptimize( Algorithms::findIndex( p, n, missing ) );
+			} );
+			context.measure( suite, "count", variant, n, 1, [ & ]() {
+				doNotOptimize( Algorithms::count( p, n, data[ 0 ] ) );
+			} );
+			context.measure( suite, "min", variant, n, 1, [ & ]() {
+				doNotOptimize( Algorithms::min( p, n ) );
+			} );
+			context.measure( suite, "max", variant, n, 1, [ & ]() {
+				doNotOptimize( Algorithms::max( p, n ) );
+			} );
+			context.measure( suite, "sum", variant, n, 1, [ & ]() {
+				doNotOptimize( Algorithms::sum( p, n ) );
+			} );
+		}
+		Simd::setInstructionSet( supported );
+	}
+
+	void runKernelSuite( Context& context ) {
+		const size_t n = context.getOptions().quick ? 100000 : 4000000;
+		runKernelBenchmarks< int >( context, "int", n );
+		runKernelBenchmarks< unsigned int >( context, "unsigned int", n );
+		runKernelBenchmarks< float >( context, "float", n );
+		runKernelBenchmarks< double >( context, "double", n );
+	}
+
+	SuiteRegistration kernelSuite( "kernels", runKernelSuite );
+}
@@ -0,0 +1,408 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// List benchmarks
+//
+// Compares CoreLib::List against std::vector across element types and 
+// sizes.
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <containers/list/indexedList.h>
+#include <containers/list/list.h>
+#include <containers/list/smallList.h>
+#include <string.h>
+#include <stdio.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace CoreLib;
+using namespace CoreLib::Benchmarks;
+
+namespace {
+
+	// 64 byte trivially copyable record
+	struct Record {
+		int		key;
+		char	payload[ 60 ];
+
+		bool operator==( const Record& other ) const { return key == other.key; }
+		bool operator<( const Record& other ) const { return key < other.key; }
+	};
+
+	template< class T > T makeValue( size_t i );
+
+	template<> int makeValue< int >( size_t i ) {
+		return (int)i;
+	}
+
+	template<> Record makeValue< Record >( size_t i ) {
+		Record record;
+		record.key = (int)i;
+		memset( record.payload, (int)( i & 0xFF ), sizeof( record.payload ) );
+		return record;
+	}
+
+	template<> std::string makeValue< std::string >( size_t i ) {
+		// long enough to defeat the small string optimization
+		char buffer[ 64 ];
+		snprintf( buffer, sizeof( buffer ), "benchmark string value number %u", (unsigned int)i );
+		return buffer;
+	}
+
+	// n values in a pseudo random order
+	template< class T >
+	std::vector< T > makeValues( size_t n ) {
+		std::vector< T > values;
+		values.reserve( n );
+		for( size_t i = 0; i < n; i++ ) {
+			values.push_back( makeValue< T >( ( i * 2654435761u ) % n ) );
+		}
+		return values;
+	}
+
+	template< class T >
+	void fillList( List< T >& list, const std::vector< T >& values ) {
+		list.clear();
+		list.preAllocate( values.size() );
+		for( size_t i = 0; i < values.size(); i++ ) {
+			list.append( values[ i ] );
+		}
+	}
+
+	// sort key of each element type
+	inline int sortKey( int value ) { return value; }
+	inline int sortKey( const Record& record ) { return record.key; }
+	inline size_t sortKey( const std::string& value ) { return value.size(); }
+
+	// hash index keys of each element type
+	template< class T >
+	struct HasherFor {
+		typedef Hash< T > type;
+	};
+
+	struct RecordHash {
+		unsigned int operator()( const Record& record ) const { return mixHash( (uint64_t)record.key ); }
+	};
+
+	template<> struct HasherFor< Record > {
+		typedef RecordHash type;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// runTypeBenchmarks
+	//////////////////////////////////////////////////////////////////////////
+	template< class T >
+	void runTypeBenchmarks( Context& context, const std::string& typeName, size_t n ) {
+		const char* suite = "list";
+		const std::string list = "CoreLib::List<" + typeName + ">";
+		const std::string geometricList = "CoreLib::List<" + typeName + ",GeometricGrowth>";
+		const std::string vector = "std::vector<" + typeName + ">";
+		const std::string indexedList = "CoreLib::IndexedList<" + typeName + ">";
+		const std::vector< T > values = makeValues< T >( n );
+		typedef IndexedList< T, Memory::StandardAllocator< T >, GeometricGrowth<>, typename HasherFor< T >::type > IndexedListType;
+
+		// append
+		if ( n <= 100000 ) {
+			// fixed granularity growth is quadratic, keep it to reasonable sizes
+			context.measure( suite, "append", list, n, 1, [ & ]() {
+				List< T > l;
+				for( size_t i = 0; i < n; i++ ) {
+					l.append( values[ i ] );
+				}
+				doNotOptimize( l );
+			} );
+		}
+		context.measure( suite, "append", geometricList, n, 1, [ & ]() {
+			List< T, Memory::StandardAllocator< T >, GeometricGrowth<> > l;
+			for( size_t i = 0; i < n; i++ ) {
+				l.append( values[ i ] );
+			}
+			doNotOptimize( l );
+		} );
+		context.measure( suite, "appendPreallocated", list, n, 1, [ & ]() {
+			List< T > l;
+			l.preAllocate( n );
+			for( size_t i = 0; i < n; i++ ) {
+				l.append( values[ i ] );
+			}
+			doNotOptimize( l );
+		} );
+		context.measure( suite, "append", vector, n, 1, [ & ]() {
+			std::vector< T > v;
+			for( size_t i = 0; i < n; i++ ) {
+				v.push_back( values[ i ] );
+			}
+			doNotOptimize( v );
+		} );
+
+		// bulk append, in chunks of 256 elements as a batch loader would
+		const size_t chunk = 256;
+		context.measure( suite, "appendRange", list, n, 1, [ & ]() {
+			List< T > l;
+			for( size_t i = 0; i < n; i += chunk ) {
+				l.appendRange( values.data() + i, std::min( chunk, n - i ) );
+			}
+			doNotOptimize( l );
+		} );
+		context.measure( suite, "appendRange", vector, n, 1, [ & ]() {
+			std::vector< T > v;
+			for( size_t i = 0; i < n; i += chunk ) {
+				v.insert( v.end(), values.begin() + i, values.begin() + std::min( i + chunk, n ) );
+			}
+			doNotOptimize( v );
+		} );
+
+		// copy
+		List< T > sourceList;
+		fillList( sourceList, values );
+		context.measure( suite, "copy", list, n, 1, [ & ]() {
+			List< T > copy( sourceList );
+			doNotOptimize( copy );
+		} );
+		context.measure( suite, "copy", vector, n, 1, [ & ]() {
+			std::vector< T > copy( values );
+			doNotOptimize( copy );
+		} );
+
+		// findIndex, looking up values spread across the list
+		const size_t lookups = 64;
+		context.measure( suite, "findIndex", list, lookups, 1, [ & ]() {
+			int found = 0;
+			for( size_t i = 0; i < lookups; i++ ) {
+				found += sourceList.findIndex( values[ i * n / lookups ] );
+			}
+			doNotOptimize( found );
+		} );
+		context.measure( suite, "findIndex", vector, lookups, 1, [ & ]() {
+			size_t found = 0;
+			for( size_t i = 0; i < lookups; i++ ) {
+				found += std::find( values.begin(), values.end(), values[ i * n / lookups ] ) - values.begin();
+			}
+			doNotOptimize( found );
+		} );
+		IndexedListType sourceIndexedList;
+		for( size_t i = 0; i < n; i++ ) {
+			sourceIndexedList.append( values[ i ] );
+		}
+		context.measure( suite, "findIndex", indexedList, lookups, 1, [ & ]() {
+			int found = 0;
+			for( size_t i = 0; i < lookups; i++ ) {
+				found += sourceIndexedList.findIndex( values[ i * n / lookups ] );
+			}
+			doNotOptimize( found );
+		} );
+
+		// addUnique, every value is added twice
+		if ( n <= 10000 ) {
+			context.measure( suite, "addUnique", list, n, 1, [ & ]() {
+				List< T > l;
+				for( size_t i = 0; i < n; i++ ) {
+					l.addUnique( values[ i / 2 ] );
+				}
+				doNotOptimize( l );
+			} );
+			context.measure( suite, "addUnique", vector, n, 1, [ & ]() {
+				std::vector< T > v;
+				for( size_t i = 0; i < n; i++ ) {
+					if ( std::find( v.begin(), v.end(), values[ i / 2 ] ) == v.end() ) {
+						v.push_back( values[ i / 2 ] );
+					}
+				}
+				doNotOptimize( v );
+			} );
+		}
+		context.measure( suite, "addUnique", indexedList, n, 1, [ & ]() {
+			IndexedListType l;
+			for( size_t i = 0; i < n; i++ ) {
+				l.addUnique( values[ i / 2 ] );
+			}
+			doNotOptimize( l );
+		} );
+
+		// remove every element with an even key
+		List< T > compactList;
+		std::vector< T > compactVector;
+		context.measure( suite, "removeIf", list, n, 1, 
+			[ & ]() { compactList = sourceList; },
+			[ & ]() {
+				compactList.removeIf( []( const T& value ) { return ( sortKey( value ) & 1 ) == 0; } );
+				doNotOptimize( compactList );
+			} );
+		context.measure( suite, "removeIf", vector, n, 1, 
+			[ & ]() { compactVector = values; },
+			[ & ]() {
+				compactVector.erase( std::remove_if( compactVector.begin(), compactVector.end(), []( const T& value ) { return ( sortKey( value ) & 1 ) == 0; } ), compactVector.end() );
+				doNotOptimize( compactVector );
+			} );
+
+		// removeIndexFast until the list is empty
+		List< T > removeList;
+		std::vector< T > removeVector;
+		context.measure( suite, "removeIndexFast", list, n, 1, 
+			[ & ]() { removeList = sourceList; },
+			[ & ]() {
+				for( size_t i = n; i > 0; i-- ) {
+					removeList.removeIndexFast( ( i * 7919 ) % i );
+				}
+				doNotOptimize( removeList );
+			} );
+		context.measure( suite, "removeIndexFast", vector, n, 1, 
+			[ & ]() { removeVector = values; },
+			[ & ]() {
+				for( size_t i = n; i > 0; i-- ) {
+					const size_t index = ( i * 7919 ) % i;
+					if ( index != removeVector.size() - 1 ) {
+						removeVector[ index ] = std::move( removeVector.back() );
+					}
+					removeVector.pop_back();
+				}
+				doNotOptimize( removeVector );
+			} );
+
+		// sort
+		List< T > sortList;
+		std::vector< T > sortVector;
+		context.measure( suite, "sort", list + " cmp_t", n, 1, 
+			[ & ]() { sortList = sourceList; },
+			[ & ]() { 
+				sortList.sort(); 
+				doNotOptimize( sortList );
+			} );
+		context.measure( suite, "sort", list + " less", n, 1, 
+			[ & ]() { sortList = sourceList; },
+			[ & ]() { 
+				sortList.sort( std::less< T >() ); 
+				doNotOptimize( sortList );
+			} );
+		context.measure( suite, "sort", vector, n, 1, 
+			[ & ]() { sortVector = values; },
+			[ & ]() { 
+				std::sort( sortVector.begin(), sortVector.end() ); 
+				doNotOptimize( sortVector );
+			} );
+
+		// sort by an integral key, radix sorted for relocatable types
+		context.measure( suite, "sortByKey", list, n, 1, 
+			[ & ]() { sortList = sourceList; },
+			[ & ]() { 
+				sortList.sortByKey( []( const T& value ) { return sortKey( value ); } ); 
+				doNotOptimize( sortList );
+			} );
+		context.measure( suite, "sortByKey", vector, n, 1, 
+			[ & ]() { sortVector = values; },
+			[ & ]() { 
+				std::sort( sortVector.begin(), sortVector.end(), []( const T& a, const T& b ) { return sortKey( a ) < sortKey( b ); } ); 
+				doNotOptimize( sortVector );
+			} );
+
+		// swap
+		const size_t swaps = 1000;
+		List< T > otherList;
+		fillList( otherList, values );
+		context.measure( suite, "swap", list, swaps, 1, [ & ]() {
+			for( size_t i = 0; i < swaps; i++ ) {
+				sourceList.swap( otherList );
+			}
+			doNotOptimize( sourceList );
+		} );
+		std::vector< T > vectorA( values ), vectorB( values );
+		context.measure( suite, "swap", vector, swaps, 1, [ & ]() {
+			for( size_t i = 0; i < swaps; i++ ) {
+				vectorA.swap( vectorB );
+			}
+			doNotOptimize( vectorA );
+		} );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// runSmallListBenchmarks
+	//
+	// Builds and discards many short lists of up to 8 elements, which 
+	// SmallList keeps inline.
+	//////////////////////////////////////////////////////////////////////////
+	template< class T >
+	void runSmallListBenchmarks( Context& context, const std::string& typeName, size_t numLists ) {
+		const char* suite = "list";
+		const size_t maxElements = 8;
+		const std::vector< T > values = makeValues< T >( maxElements );
+
+		context.measure( suite, "smallLists", "CoreLib::List<" + typeName + ">", numLists, 1, [ & ]() {
+			size_t total = 0;
+			for( size_t i = 0; i < numLists; i++ ) {
+				List< T > l;
+				for( size_t j = 0; j <= i % maxElements; j++ ) {
+					l.append( values[ j ] );
+				}
+				total += l.size();
+				doNotOptimize( l );
+			}
+			doNotOptimize( total );
+		} );
+		context.measure( suite, "smallLists", "CoreLib::SmallList<" + typeName + ",8>", numLists, 1, [ & ]() {
+			size_t total = 0;
+			for( size_t i = 0; i < numLists; i++ ) {
+				SmallList< T, 8 > l;
+				for( size_t j = 0; j <= i % maxElements; j++ ) {
+					l.append( values[ j ] );
+				}
+				total += l.size();
+				doNotOptimize( l );
+			}
+			doNotOptimize( total );
+		} );
+		context.measure( suite, "smallLists", "std::vector<" + typeName + ">", numLists, 1, [ & ]() {
+			size_t total = 0;
+			for( size_t i = 0; i < numLists; i++ ) {
+				std::vector< T > l;
+				for( size_t j = 0; j <= i % maxElements; j++ ) {
+					l.push_back( values[ j ] );
+				}
+				total += l.size();
+				doNotOptimize( l );
+			}
+			doNotOptimize( total );
+		} );
+	}
+
+	void runListBenchmarks( Context& context ) {
+		const size_t quickSizes[] = { 100, 10000 };
+		const size_t fullSizes[] = { 100, 10000, 1000000 };
+		const size_t* sizes = context.getOptions().quick ? quickSizes : fullSizes;
+		const size_t numSizes = context.getOptions().quick ? 2 : 3;
+
+		for( size_t i = 0; i < numSizes; i++ ) {
+			runTypeBenchmarks< int >( context, "int", sizes[ i ] );
+			runTypeBenchmarks< Record >( context, "Record64", sizes[ i ] );
+			runTypeBenchmarks< std::string >( context, "std::string", sizes[ i ] );
+		}
+
+		const size_t numSmallLists = context.getOptions().quick ? 10000 : 1000000;
+		runSmallListBenchmarks< int >( context, "int", numSmallLists );
+		runSmallListBenchmarks< std::string >( context, "std::string", numSmallLists );
+	}
+
+	SuiteRegistration listSuite( "list", runListBenchmarks );
+}
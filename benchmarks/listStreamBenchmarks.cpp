@@ -0,0 +1,109 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// List stream benchmarks
+//
+// Writing and reading back a file of records as a whole List, which needs
+// the whole dataset in memory, against streaming it in chunks with 
+// ListStreamWriter and ListStreamReader, which only ever hold two chunks.
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <containers/list/list.h>
+#include <containers/list/listFile.h>
+#include <containers/list/listStream.h>
+#include <stdio.h>
+
+using namespace CoreLib;
+using namespace CoreLib::Benchmarks;
+
+namespace {
+
+	typedef FileRecord Record;
+
+	void runListStreamBenchmarks( Context& context, size_t n ) {
+		const char* suite = "listStream";
+		const char* path = "corelib_listStream.bin";
+
+		// write
+		context.measure( suite, "write", "List + writeListFile", n, 1, [ & ]() {
+			List< Record > records;
+			records.resize( n );
+			for( size_t i = 0; i < n; i++ ) {
+				records[ i ] = makeFileRecord( i );
+			}
+			bool written = writeListFile( path, records, FILE_RECORD_VERSION );
+			doNotOptimize( written );
+		} );
+		context.measure( suite, "write", "ListStreamWriter (4MB chunks)", n, 1, [ & ]() {
+			ListStreamWriter< Record > writer( path, FILE_RECORD_VERSION );
+			for( size_t i = 0; i < n; i++ ) {
+				writer.append( makeFileRecord( i ) );
+			}
+			bool written = writer.close();
+			doNotOptimize( written );
+		} );
+
+		// read back and sum the keys
+		context.measure( suite, "readAndSum", "fread into List", n, 1, [ & ]() {
+			List< Record > loaded;
+			FILE* file = fopen( path, "rb" );
+			ListFileHeader header;
+			if ( file != NULL && fread( &header, sizeof( header ), 1, file ) == 1 && fseek( file, (long)header.dataOffset, SEEK_SET ) == 0 ) {
+				loaded.resize( (size_t)header.count );
+				size_t read = fread( loaded.begin(), sizeof( Record ), loaded.size(), file );
+				doNotOptimize( read );
+			}
+			if ( file != NULL ) {
+				fclose( file );
+			}
+			uint64_t total = 0;
+			for( size_t i = 0; i < loaded.size(); i++ ) {
+				total += loaded[ i ].key;
+			}
+			doNotOptimize( total );
+		} );
+		const size_t chunkSizes[] = { 64 * 1024, 4 * 1024 * 1024 };
+		const char* chunkNames[] = { "ListStreamReader (64KB chunks)", "ListStreamReader (4MB chunks)" };
+		for( size_t c = 0; c < 2; c++ ) {
+			context.measure( suite, "readAndSum", chunkNames[ c ], n, 1, [ & ]() {
+				ListStreamReader< Record > reader( path, FILE_RECORD_VERSION, chunkSizes[ c ] );
+				uint64_t total = 0;
+				reader.forEachChunk( [ & ]( Span< const Record > records ) {
+					for( size_t i = 0; i < records.size(); i++ ) {
+						total += records[ i ].key;
+					}
+				} );
+				doNotOptimize( total );
+			} );
+		}
+
+		remove( path );
+	}
+
+	void runListStreamSuite( Context& context ) {
+		runListStreamBenchmarks( context, context.getOptions().quick ? 2000000 : 32000000 );
+	}
+
+	SuiteRegistration listStreamSuite( "listStream", runListStreamSuite );
+}
@@ -0,0 +1,126 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Mapped list benchmarks
+//
+// Loading a List of records saved with writeListFile: reading it into a 
+// List against mapping it with MappedList, with and without touching every
+// element afterwards. The file stays in the page cache between runs, so 
+// this measures the cost of copying against that of page faults.
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <containers/list/list.h>
+#include <containers/list/listFile.h>
+#include <containers/list/mappedList.h>
+#include <stdio.h>
+
+using namespace CoreLib;
+using namespace CoreLib::Benchmarks;
+
+namespace {
+
+	typedef FileRecord Record;
+
+	template< class ListType >
+	uint64_t sumKeys( const ListType& list ) {
+		uint64_t total = 0;
+		for( size_t i = 0; i < list.size(); i++ ) {
+			total += list[ i ].key;
+		}
+		return total;
+	}
+
+	void runMappedListBenchmarks( Context& context, size_t n ) {
+		const char* suite = "mappedList";
+		const char* path = "corelib_mappedList.bin";
+
+		List< Record > records;
+		records.resize( n );
+		for( size_t i = 0; i < n; i++ ) {
+			records[ i ] = makeFileRecord( i );
+		}
+
+		context.measure( suite, "write", "writeListFile", n, 1, [ & ]() {
+			bool written = writeListFile( path, records, FILE_RECORD_VERSION );
+			doNotOptimize( written );
+		} );
+
+		// reading the whole file into a List, the cheapest way to load it 
+		// short of mapping it
+		context.measure( suite, "load", "fread into List", n, 1, [ & ]() {
+			List< Record > loaded;
+			FILE* file = fopen( path, "rb" );
+			ListFileHeader header;
+			if ( file != NULL && fread( &header, sizeof( header ), 1, file ) == 1 && fseek( file, (long)header.dataOffset, SEEK_SET ) == 0 ) {
+				loaded.resize( (size_t)header.count );
+				size_t read = fread( loaded.begin(), sizeof( Record ), loaded.size(), file );
+				doNotOptimize( read );
+			}
+			if ( file != NULL ) {
+				fclose( file );
+			}
+			doNotOptimize( loaded );
+		} );
+		context.measure( suite, "load", "MappedList::open", n, 1, [ & ]() {
+			MappedList< Record > view( path, MappedList< Record >::READ_ONLY, FILE_RECORD_VERSION );
+			doNotOptimize( view );
+		} );
+
+		// load and use every element
+		context.measure( suite, "loadAndSum", "fread into List", n, 1, [ & ]() {
+			List< Record > loaded;
+			FILE* file = fopen( path, "rb" );
+			ListFileHeader header;
+			if ( file != NULL && fread( &header, sizeof( header ), 1, file ) == 1 && fseek( file, (long)header.dataOffset, SEEK_SET ) == 0 ) {
+				loaded.resize( (size_t)header.count );
+				size_t read = fread( loaded.begin(), sizeof( Record ), loaded.size(), file );
+				doNotOptimize( read );
+			}
+			if ( file != NULL ) {
+				fclose( file );
+			}
+			uint64_t total = sumKeys( loaded );
+			doNotOptimize( total );
+		} );
+		context.measure( suite, "loadAndSum", "MappedList::open", n, 1, [ & ]() {
+			MappedList< Record > view( path, MappedList< Record >::READ_ONLY, FILE_RECORD_VERSION );
+			uint64_t total = sumKeys( view.getList() );
+			doNotOptimize( total );
+		} );
+		context.measure( suite, "loadAndSum", "MappedList::open + willNeed", n, 1, [ & ]() {
+			MappedList< Record > view( path, MappedList< Record >::READ_ONLY, FILE_RECORD_VERSION );
+			view.willNeed();
+			uint64_t total = sumKeys( view.getList() );
+			doNotOptimize( total );
+		} );
+
+		remove( path );
+	}
+
+	void runMappedListSuite( Context& context ) {
+		runMappedListBenchmarks( context, context.getOptions().quick ? 1000000 : 8000000 );
+	}
+
+	SuiteRegistration mappedListSuite( "mappedList", runMappedListSuite );
+}
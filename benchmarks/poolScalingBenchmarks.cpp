@@ -0,0 +1,109 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Pool scaling benchmarks
+//
+// Allocation throughput as the number of threads grows, for:
+//	- malloc
+//	- a ConcurrentMemoryPool shared by every thread (atomic fetch-add)
+//	- per-thread chunks carved from a ConcurrentMemoryPool
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <memory/concurrentPool.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace CoreLib::Memory;
+using namespace CoreLib::Benchmarks;
+
+namespace {
+
+	const size_t MIN_ALLOCATION = 16;
+	const size_t MAX_ALLOCATION = 128;
+
+	void runPoolScalingBenchmarks( Context& context, size_t numThreads, size_t allocationsPerThread ) {
+		const char* suite = "poolScaling";
+		const size_t totalAllocations = numThreads * allocationsPerThread;
+
+		// worst case size of each allocation, including the pool padding
+		const size_t bytesPerThread = allocationsPerThread * ( MAX_ALLOCATION + 16 );
+
+		// malloc, timing the allocations only
+		std::vector< std::vector< void* > > blocks( numThreads );
+		auto freeBlocks = [ & ]() {
+			for( size_t t = 0; t < numThreads; t++ ) {
+				for( size_t i = 0; i < blocks[ t ].size(); i++ ) {
+					free( blocks[ t ][ i ] );
+				}
+				blocks[ t ].clear();
+				blocks[ t ].reserve( allocationsPerThread );
+			}
+		};
+		context.measure( suite, "alloc", "malloc", totalAllocations, numThreads, freeBlocks, [ & ]() {
+			runThreads( numThreads, [ & ]( size_t thread ) {
+				unsigned int seed = (unsigned int)thread;
+				std::vector< void* >& threadBlocks = blocks[ thread ];
+				for( size_t i = 0; i < allocationsPerThread; i++ ) {
+					threadBlocks.push_back( malloc( allocationSize( seed, MIN_ALLOCATION, MAX_ALLOCATION ) ) );
+				}
+			} );
+		} );
+		freeBlocks();
+
+		ConcurrentMemoryPool pool( numThreads * bytesPerThread );
+
+		context.measure( suite, "alloc", "ConcurrentMemoryPool (shared)", totalAllocations, numThreads, [ & ]() { pool.clearMemory(); }, [ & ]() {
+			runThreads( numThreads, [ & ]( size_t thread ) {
+				unsigned int seed = (unsigned int)thread;
+				for( size_t i = 0; i < allocationsPerThread; i++ ) {
+					doNotOptimize( pool.allocBytes( allocationSize( seed, MIN_ALLOCATION, MAX_ALLOCATION ), 8 ) );
+				}
+			} );
+		} );
+
+		context.measure( suite, "alloc", "ConcurrentMemoryPool (carved chunks)", totalAllocations, numThreads, [ & ]() { pool.clearMemory(); }, [ & ]() {
+			runThreads( numThreads, [ & ]( size_t thread ) {
+				unsigned int seed = (unsigned int)thread;
+				MemoryPool chunk;
+				pool.carve( bytesPerThread, chunk );
+				for( size_t i = 0; i < allocationsPerThread; i++ ) {
+					doNotOptimize( chunk.allocBytes( allocationSize( seed, MIN_ALLOCATION, MAX_ALLOCATION ), 8 ) );
+				}
+			} );
+		} );
+	}
+
+	void runPoolScalingSuite( Context& context ) {
+		const size_t allocationsPerThread = context.getOptions().quick ? 20000 : 1000000;
+		const size_t maxThreads = context.getOptions().maxThreads;
+		for( size_t threads = 1; threads <= maxThreads; threads = threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2 ) {
+			runPoolScalingBenchmarks( context, threads, allocationsPerThread );
+			if ( threads == maxThreads ) {
+				break;
+			}
+		}
+	}
+
+	SuiteRegistration poolScalingSuite( "poolScaling", runPoolScalingSuite );
+}
@@ -0,0 +1,217 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Queue benchmarks
+//
+// Passing elements between threads through SpscQueue, MpmcQueue and a 
+// List guarded by a mutex (popping with removeIndexFast): throughput for 
+// several producer and consumer counts, one element and batches at a 
+// time, and the latency of a round trip between two threads. Correctness
+// is covered by the queue tests (tests/queueTests.cpp).
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <containers/list/list.h>
+#include <containers/queue/mpmcQueue.h>
+#include <containers/queue/spscQueue.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CoreLib;
+using namespace CoreLib::Benchmarks;
+
+namespace {
+
+	const size_t QUEUE_CAPACITY = 1024;
+	const size_t BATCH = 32;
+
+	// The current approach, for reference: a List behind a lock, which 
+	// doesn't keep the FIFO order.
+	class LockedList {
+	public:
+		explicit LockedList( size_t ) {}
+
+		bool push( size_t value ) {
+			std::lock_guard< std::mutex > lock( mutex );
+			list.append( value );
+			return true;
+		}
+
+		size_t pushRange( const size_t* values, size_t count ) {
+			std::lock_guard< std::mutex > lock( mutex );
+			list.appendRange( values, count );
+			return count;
+		}
+
+		bool pop( size_t& value ) {
+			std::lock_guard< std::mutex > lock( mutex );
+			if ( list.empty() ) {
+				return false;
+			}
+			value = list[ 0 ];
+			list.removeIndexFast( 0 );
+			return true;
+		}
+
+		size_t popRange( size_t* values, size_t maxCount ) {
+			std::lock_guard< std::mutex > lock( mutex );
+			size_t count = 0;
+			while ( count < maxCount && !list.empty() ) {
+				values[ count++ ] = list[ 0 ];
+				list.removeIndexFast( 0 );
+			}
+			return count;
+		}
+
+	private:
+		std::mutex												mutex;
+		List< size_t, Memory::StandardAllocator< size_t >, GeometricGrowth<> >	list;
+	};
+
+	// Moves n values from the producers to the consumers, each producer 
+	// pushing its share of [0, n) and each consumer popping its share of 
+	// the values. Returns the sum of the values popped (checked by the 
+	// queue tests).
+	template< class Queue >
+	unsigned long long transfer( Queue& queue, size_t n, size_t producers, size_t consumers, bool batched ) {
+		std::atomic< unsigned long long > total( 0 );
+		std::vector< std::thread > threads;
+		for( size_t p = 0; p < producers; p++ ) {
+			threads.push_back( std::thread( [ &, p ]() {
+				const size_t end = n * ( p + 1 ) / producers;
+				size_t values[ BATCH ];
+				for( size_t i = n * p / producers; i < end; ) {
+					size_t pushed;
+					if ( batched ) {
+						const size_t count = end - i < BATCH ? end - i : BATCH;
+						for( size_t j = 0; j < count; j++ ) {
+							values[ j ] = i + j;
+						}
+						pushed = queue.pushRange( values, count );
+					} else {
+						pushed = queue.push( i ) ? 1 : 0;
+					}
+					if ( pushed == 0 ) {
+						std::this_thread::yield();
+					}
+					i += pushed;
+				}
+			} ) );
+		}
+		for( size_t c = 0; c < consumers; c++ ) {
+			threads.push_back( std::thread( [ &, c ]() {
+				const size_t quota = n * ( c + 1 ) / consumers - n * c / consumers;
+				unsigned long long sum = 0;
+				size_t values[ BATCH ];
+				for( size_t received = 0; received < quota; ) {
+					size_t popped;
+					if ( batched ) {
+						popped = queue.popRange( values, quota - received < BATCH ? quota - received : BATCH );
+					} else {
+						popped = queue.pop( values[ 0 ] ) ? 1 : 0;
+					}
+					if ( popped == 0 ) {
+						std::this_thread::yield();
+					}
+					for( size_t j = 0; j < popped; j++ ) {
+						sum += values[ j ];
+					}
+					received += popped;
+				}
+				total += sum;
+			} ) );
+		}
+		for( size_t i = 0; i < threads.size(); i++ ) {
+			threads[ i ].join();
+		}
+		return total;
+	}
+
+	template< class Queue >
+	void runThroughput( Context& context, const std::string& name, size_t n, size_t producers, size_t consumers ) {
+		const char* suite = "queue";
+		const std::string shape = " " + std::to_string( producers ) + "P" + std::to_string( consumers ) + "C";
+		for( int batched = 0; batched < 2; batched++ ) {
+			context.measure( suite, "throughput", name + ( batched ? "::pushRange/popRange" : "::push/pop" ) + shape, n, producers + consumers, [ & ]() {
+				Queue queue( QUEUE_CAPACITY );
+				doNotOptimize( transfer( queue, n, producers, consumers, batched != 0 ) );
+			} );
+		}
+	}
+
+	// Bounces a value between two threads through a pair of queues.
+	template< class Queue >
+	void runLatency( Context& context, const std::string& name, size_t roundTrips ) {
+		context.measure( "queue", "roundTrip", name, roundTrips, 2, [ & ]() {
+			Queue ping( QUEUE_CAPACITY );
+			Queue pong( QUEUE_CAPACITY );
+			std::thread echo( [ & ]() {
+				size_t value;
+				for( size_t i = 0; i < roundTrips; i++ ) {
+					while ( !ping.pop( value ) ) {
+						std::this_thread::yield();
+					}
+					pong.push( value + 1 );
+				}
+			} );
+			size_t value = 0;
+			for( size_t i = 0; i < roundTrips; i++ ) {
+				ping.push( value );
+				while ( !pong.pop( value ) ) {
+					std::this_thread::yield();
+				}
+			}
+			echo.join();
+			doNotOptimize( value );
+		} );
+	}
+
+	void runQueueSuite( Context& context ) {
+		const size_t n = context.getOptions().quick ? 100000 : 2000000;
+		const size_t roundTrips = context.getOptions().quick ? 2000 : 50000;
+		const size_t maxThreads = context.getOptions().maxThreads;
+
+		runThroughput< SpscQueue< size_t > >( context, "SpscQueue", n, 1, 1 );
+
+		std::vector< std::pair< size_t, size_t > > shapes;
+		shapes.push_back( std::make_pair( 1, 1 ) );
+		shapes.push_back( std::make_pair( 2, 1 ) );
+		shapes.push_back( std::make_pair( 1, 2 ) );
+		shapes.push_back( std::make_pair( 2, 2 ) );
+		if ( maxThreads > 4 ) {
+			shapes.push_back( std::make_pair( maxThreads / 2, maxThreads - maxThreads / 2 ) );
+		}
+		for( size_t i = 0; i < shapes.size(); i++ ) {
+			runThroughput< MpmcQueue< size_t > >( context, "MpmcQueue", n, shapes[ i ].first, shapes[ i ].second );
+			runThroughput< LockedList >( context, "locked List", n, shapes[ i ].first, shapes[ i ].second );
+		}
+
+		runLatency< SpscQueue< size_t > >( context, "SpscQueue", roundTrips );
+		runLatency< MpmcQueue< size_t > >( context, "MpmcQueue", roundTrips );
+		runLatency< LockedList >( context, "locked List", roundTrips );
+	}
+
+	SuiteRegistration queueSuite( "queue", runQueueSuite );
+}
@@ -0,0 +1,147 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Segmented list benchmarks
+//
+// Filling and walking a table of entities kept in a List, which copies 
+// every element when it grows, and in a SegmentedList, which only adds 
+// blocks.
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <containers/list/list.h>
+#include <containers/segmentedList/segmentedList.h>
+#include <memory/poolAllocator.h>
+#include <memory/staticPool.h>
+
+using namespace CoreLib;
+using namespace CoreLib::Benchmarks;
+
+namespace {
+
+	struct Entity {
+		float	transform[ 12 ];
+		int		id;
+		int		parent;
+		int		flags;
+		float	radius;
+	};
+
+	typedef List< Entity, Memory::StandardAllocator< Entity >, GeometricGrowth<> > EntityList;
+	typedef SegmentedList< Entity, 256 > EntitySegmentedList;
+	typedef SegmentedList< Entity, 256, Memory::PoolAllocator< Entity > > EntityPoolSegmentedList;
+
+	Entity makeEntity( size_t i ) {
+		Entity e;
+		for( size_t j = 0; j < 12; j++ ) {
+			e.transform[ j ] = (float)( i + j );
+		}
+		e.id = (int)i;
+		e.parent = (int)i - 1;
+		e.flags = 0;
+		e.radius = 1.0f;
+		return e;
+	}
+
+	void runSegmentedListBenchmarks( Context& context, size_t n ) {
+		const char* suite = "segmentedList";
+
+		// append, growing from empty
+		context.measure( suite, "append", "List (geometric growth)", n, 1, [ & ]() {
+			EntityList l;
+			for( size_t i = 0; i < n; i++ ) {
+				l.append( makeEntity( i ) );
+			}
+			doNotOptimize( l );
+		} );
+		context.measure( suite, "append", "List (preAllocate)", n, 1, [ & ]() {
+			EntityList l;
+			l.preAllocate( n );
+			for( size_t i = 0; i < n; i++ ) {
+				l.append( makeEntity( i ) );
+			}
+			doNotOptimize( l );
+		} );
+		context.measure( suite, "append", "SegmentedList<256>", n, 1, [ & ]() {
+			EntitySegmentedList l;
+			for( size_t i = 0; i < n; i++ ) {
+				l.append( makeEntity( i ) );
+			}
+			doNotOptimize( l );
+		} );
+		Memory::MemoryPool pool( ( n + 256 ) * sizeof( Entity ) + 4096 );
+		context.measure( suite, "append", "SegmentedList<256> (MemoryPool)", n, 1, [ & ]() {
+			pool.clearMemory();
+			EntityPoolSegmentedList l( pool );
+			for( size_t i = 0; i < n; i++ ) {
+				l.append( makeEntity( i ) );
+			}
+			doNotOptimize( l );
+		} );
+
+		EntityList list;
+		EntitySegmentedList segmented;
+		for( size_t i = 0; i < n; i++ ) {
+			list.append( makeEntity( i ) );
+			segmented.append( makeEntity( i ) );
+		}
+
+		// sum a field over every element
+		context.measure( suite, "iterate", "List", n, 1, [ & ]() {
+			float total = 0.0f;
+			for( const Entity& e : list ) {
+				total += e.radius;
+			}
+			doNotOptimize( total );
+		} );
+		context.measure( suite, "iterate", "SegmentedList::forEachBlock", n, 1, [ & ]() {
+			float total = 0.0f;
+			segmented.forEachBlock( [ & ]( const Entity* entities, size_t count ) {
+				for( size_t i = 0; i < count; i++ ) {
+					total += entities[ i ].radius;
+				}
+			} );
+			doNotOptimize( total );
+		} );
+		context.measure( suite, "iterate", "SegmentedList::Iterator", n, 1, [ & ]() {
+			float total = 0.0f;
+			for( const Entity& e : segmented ) {
+				total += e.radius;
+			}
+			doNotOptimize( total );
+		} );
+		context.measure( suite, "iterate", "SegmentedList::operator[]", n, 1, [ & ]() {
+			float total = 0.0f;
+			for( size_t i = 0; i < n; i++ ) {
+				total += segmented[ i ].radius;
+			}
+			doNotOptimize( total );
+		} );
+	}
+
+	void runSegmentedListSuite( Context& context ) {
+		runSegmentedListBenchmarks( context, context.getOptions().quick ? 100000 : 2000000 );
+	}
+
+	SuiteRegistration segmentedListSuite( "segmentedList", runSegmentedListSuite );
+}
@@ -0,0 +1,152 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Structure of arrays benchmarks
+//
+// Passes touching one or two fields of a particle, stored as a List of 
+// structs against a SoaList.
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <algorithms/kernels.h>
+#include <containers/list/list.h>
+#include <containers/soa/soaList.h>
+
+using namespace CoreLib;
+using namespace CoreLib::Benchmarks;
+
+namespace {
+
+	struct Particle {
+		float	position[ 3 ];
+		float	velocity[ 3 ];
+		float	color[ 4 ];
+		float	mass;
+		float	age;
+		int		id;
+		int		flags;
+	};
+
+	enum { POSITION_X, POSITION_Y, POSITION_Z, VELOCITY_X, VELOCITY_Y, VELOCITY_Z, COLOR, MASS, AGE, ID, FLAGS };
+	struct Color { float rgba[ 4 ]; };
+	typedef SoaList< SoaFields< float, float, float, float, float, float, Color, float, float, int, int >, Memory::StandardAllocator< unsigned char >, GeometricGrowth<> > ParticleSoa;
+	typedef List< Particle, Memory::StandardAllocator< Particle >, GeometricGrowth<> > ParticleList;
+
+	void runSoaBenchmarks( Context& context, size_t n ) {
+		const char* suite = "soa";
+		const float dt = 1.0f / 60.0f;
+
+		ParticleList aos;
+		ParticleSoa soa;
+		aos.preAllocate( n );
+		soa.preAllocate( n );
+		for( size_t i = 0; i < n; i++ ) {
+			Particle p;
+			const float f = (float)( i % 1000 );
+			p.position[ 0 ] = p.position[ 1 ] = p.position[ 2 ] = f;
+			p.velocity[ 0 ] = p.velocity[ 1 ] = p.velocity[ 2 ] = f * 0.5f;
+			p.color[ 0 ] = p.color[ 1 ] = p.color[ 2 ] = p.color[ 3 ] = 1.0f;
+			p.mass = f * 0.25f;
+			p.age = 0.0f;
+			p.id = (int)i;
+			p.flags = 0;
+			aos.append( p );
+
+			Color color = { { 1.0f, 1.0f, 1.0f, 1.0f } };
+			soa.append( p.position[ 0 ], p.position[ 1 ], p.position[ 2 ], p.velocity[ 0 ], p.velocity[ 1 ], p.velocity[ 2 ], color, p.mass, p.age, p.id, p.flags );
+		}
+
+		// append
+		context.measure( suite, "append", "List<Particle>", n, 1, [ & ]() {
+			ParticleList l;
+			for( size_t i = 0; i < n; i++ ) {
+				l.append( aos[ i ] );
+			}
+			doNotOptimize( l );
+		} );
+		context.measure( suite, "append", "SoaList<Particle>", n, 1, [ & ]() {
+			ParticleSoa l;
+			for( size_t i = 0; i < n; i++ ) {
+				const Particle& p = aos[ i ];
+				Color color = { { p.color[ 0 ], p.color[ 1 ], p.color[ 2 ], p.color[ 3 ] } };
+				l.append( p.position[ 0 ], p.position[ 1 ], p.position[ 2 ], p.velocity[ 0 ], p.velocity[ 1 ], p.velocity[ 2 ], color, p.mass, p.age, p.id, p.flags );
+			}
+			doNotOptimize( l );
+		} );
+
+		// integrate a single axis, two fields per element
+		context.measure( suite, "integrateX", "List<Particle>", n, 1, [ & ]() {
+			Particle* particles = aos.begin();
+			for( size_t i = 0; i < n; i++ ) {
+				particles[ i ].position[ 0 ] += particles[ i ].velocity[ 0 ] * dt;
+			}
+			doNotOptimize( aos );
+		} );
+		context.measure( suite, "integrateX", "SoaList<Particle>", n, 1, [ & ]() {
+			float* x = soa.field< POSITION_X >().data();
+			const float* vx = soa.field< VELOCITY_X >().data();
+			for( size_t i = 0; i < n; i++ ) {
+				x[ i ] += vx[ i ] * dt;
+			}
+			doNotOptimize( soa );
+		} );
+
+		// reduce a single field
+		context.measure( suite, "sumMass", "List<Particle>", n, 1, [ & ]() {
+			float mass = 0.0f;
+			for( size_t i = 0; i < n; i++ ) {
+				mass += aos[ i ].mass;
+			}
+			doNotOptimize( mass );
+		} );
+		context.measure( suite, "sumMass", "SoaList<Particle>", n, 1, [ & ]() {
+			Span< const float > mass = static_cast< const ParticleSoa& >( soa ).field< MASS >();
+			float total = Algorithms::sum( mass.data(), mass.size() );
+			doNotOptimize( total );
+		} );
+
+		// removeIndexFast
+		context.measure( suite, "removeIndexFast", "List<Particle>", n, 1, 
+			[ & ]() { aos.clear(); aos.preAllocate( n ); for( size_t i = 0; i < n; i++ ) aos.append( Particle() ); },
+			[ & ]() {
+				while( !aos.empty() ) {
+					aos.removeIndexFast( 0 );
+				}
+				doNotOptimize( aos );
+			} );
+		context.measure( suite, "removeIndexFast", "SoaList<Particle>", n, 1, 
+			[ & ]() { soa.resize( n ); },
+			[ & ]() {
+				while( !soa.empty() ) {
+					soa.removeIndexFast( 0 );
+				}
+				doNotOptimize( soa );
+			} );
+	}
+
+	void runSoaSuite( Context& context ) {
+		runSoaBenchmarks( context, context.getOptions().quick ? 100000 : 4000000 );
+	}
+
+	SuiteRegistration soaSuite( "soa", runSoaSuite );
+}
@@ -0,0 +1,96 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Sort benchmarks
+//
+// Sequential sorts against the parallel merge sort, as the number of 
+// threads grows.
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <algorithms/parallelSort.h>
+#include <algorithms/sort.h>
+#include <stdio.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace CoreLib;
+using namespace CoreLib::Benchmarks;
+
+namespace {
+
+	template< class T > T makeKey( size_t i );
+
+	template<> int makeKey< int >( size_t i ) {
+		return (int)( i * 2654435761u );
+	}
+
+	template<> std::string makeKey< std::string >( size_t i ) {
+		char buffer[ 32 ];
+		snprintf( buffer, sizeof( buffer ), "key%u", (unsigned int)( i * 2654435761u ) );
+		return buffer;
+	}
+
+	template< class T >
+	void runSortBenchmarks( Context& context, const std::string& typeName, size_t n ) {
+		std::vector< T > values;
+		values.reserve( n );
+		for( size_t i = 0; i < n; i++ ) {
+			values.push_back( makeKey< T >( i ) );
+		}
+
+		std::vector< T > data;
+		auto reset = [ & ]() { data = values; };
+
+		context.measure( "sort", "sort", "std::sort<" + typeName + ">", n, 1, reset, [ & ]() {
+			std::sort( data.begin(), data.end() );
+			doNotOptimize( data );
+		} );
+		context.measure( "sort", "sort", "Algorithms::sort<" + typeName + ">", n, 1, reset, [ & ]() {
+			Algorithms::sort( data.data(), data.data() + n, std::less< T >() );
+			doNotOptimize( data );
+		} );
+
+		const size_t maxThreads = context.getOptions().maxThreads;
+		for( size_t threads = 1; threads <= maxThreads; threads = threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2 ) {
+			Algorithms::ThreadExecutor executor( threads );
+			context.measure( "sort", "parallelSort", "Algorithms::parallelSort<" + typeName + ">", n, threads, reset, [ & ]() {
+				Algorithms::parallelSort( data.data(), data.data() + n, std::less< T >(), executor );
+				doNotOptimize( data );
+			} );
+			if ( threads == maxThreads ) {
+				break;
+			}
+		}
+	}
+
+	void runSortSuite( Context& context ) {
+		const bool quick = context.getOptions().quick;
+		runSortBenchmarks< int >( context, "int", quick ? 200000 : 10000000 );
+		runSortBenchmarks< std::string >( context, "std::string", quick ? 100000 : 1000000 );
+	}
+
+	SuiteRegistration sortSuite( "sort", runSortSuite );
+}
@@ -0,0 +1,193 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Thread cache benchmarks
+//
+// Producer threads allocate objects and hand them in batches to consumer 
+// threads, which free them, so that most frees are cross-thread. Compares:
+//	- malloc / free
+//	- a single SlabPool guarded by a mutex
+//	- ThreadCachingPool
+//////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+#include <memory/threadCachingPool.h>
+#include <stdlib.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CoreLib::Memory;
+using namespace CoreLib::Benchmarks;
+
+namespace {
+
+	const size_t MIN_ALLOCATION = 16;
+	const size_t MAX_ALLOCATION = 256;
+	const size_t BATCH_SIZE = 256;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Handoff
+	//
+	// Batches of allocations travelling from producers to consumers.
+	//////////////////////////////////////////////////////////////////////////
+	class Handoff {
+	public:
+		Handoff() : producersLeft( 0 ) {}
+
+		void push( std::vector< void* >& batch ) {
+			std::lock_guard< std::mutex > lock( mutex );
+			batches.push_back( std::vector< void* >() );
+			batches.back().swap( batch );
+			ready.notify_one();
+		}
+
+		// returns false once every producer is done and no batches are left
+		bool pop( std::vector< void* >& batch ) {
+			std::unique_lock< std::mutex > lock( mutex );
+			while( batches.empty() && producersLeft > 0 ) {
+				ready.wait( lock );
+			}
+			if ( batches.empty() ) {
+				return false;
+			}
+			batch.swap( batches.back() );
+			batches.pop_back();
+			return true;
+		}
+
+		void producerStarted() {
+			std::lock_guard< std::mutex > lock( mutex );
+			producersLeft++;
+		}
+
+		void producerDone() {
+			std::lock_guard< std::mutex > lock( mutex );
+			producersLeft--;
+			ready.notify_all();
+		}
+
+	private:
+		std::mutex							mutex;
+		std::condition_variable				ready;
+		std::vector< std::vector< void* > >	batches;
+		size_t								producersLeft;
+	};
+
+	struct MallocAllocator {
+		void* allocBytes( size_t bytes ) { return malloc( bytes ); }
+		void freeBytes( void* ptr, size_t ) { free( ptr ); }
+	};
+
+	struct LockedSlabAllocator {
+		std::mutex mutex;
+		SlabPool pool;
+		void* allocBytes( size_t bytes ) { std::lock_guard< std::mutex > lock( mutex ); return pool.allocBytes( bytes, 16 ); }
+		void freeBytes( void* ptr, size_t bytes ) { std::lock_guard< std::mutex > lock( mutex ); pool.freeBytes( ptr, bytes ); }
+	};
+
+	struct ThreadCachingAllocatorAdapter {
+		ThreadCachingPool pool;
+		void* allocBytes( size_t bytes ) { return pool.allocBytes( bytes, 16 ); }
+		void freeBytes( void* ptr, size_t bytes ) { pool.freeBytes( ptr, bytes ); }
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// run
+	//
+	// numProducers allocate allocationsPerProducer objects each, and 
+	// numConsumers free them. Each object stores its own size, which the 
+	// consumers need to free it.
+	//////////////////////////////////////////////////////////////////////////
+	template< class Allocator >
+	void run( Allocator& allocator, size_t numProducers, size_t numConsumers, size_t allocationsPerProducer ) {
+		Handoff handoff;
+		for( size_t i = 0; i < numProducers; i++ ) {
+			handoff.producerStarted();
+		}
+
+		std::vector< std::thread > threads;
+		for( size_t p = 0; p < numProducers; p++ ) {
+			threads.push_back( std::thread( [ &, p ]() {
+				unsigned int seed = (unsigned int)p;
+				std::vector< void* > batch;
+				for( size_t i = 0; i < allocationsPerProducer; i++ ) {
+					const size_t bytes = allocationSize( seed, MIN_ALLOCATION, MAX_ALLOCATION );
+					void* ptr = allocator.allocBytes( bytes );
+					*static_cast< size_t* >( ptr ) = bytes;
+					batch.push_back( ptr );
+					if ( batch.size() == BATCH_SIZE ) {
+						handoff.push( batch );
+					}
+				}
+				if ( !batch.empty() ) {
+					handoff.push( batch );
+				}
+				handoff.producerDone();
+			} ) );
+		}
+		for( size_t c = 0; c < numConsumers; c++ ) {
+			threads.push_back( std::thread( [ & ]() {
+				std::vector< void* > batch;
+				while( handoff.pop( batch ) ) {
+					for( size_t i = 0; i < batch.size(); i++ ) {
+						allocator.freeBytes( batch[ i ], *static_cast< size_t* >( batch[ i ] ) );
+					}
+					batch.clear();
+				}
+			} ) );
+		}
+		for( size_t i = 0; i < threads.size(); i++ ) {
+			threads[ i ].join();
+		}
+	}
+
+	void runThreadCacheSuite( Context& context ) {
+		const size_t allocationsPerProducer = context.getOptions().quick ? 20000 : 1000000;
+		const size_t maxThreads = context.getOptions().maxThreads < 2 ? 2 : context.getOptions().maxThreads;
+
+		MallocAllocator mallocAllocator;
+		LockedSlabAllocator lockedSlabAllocator;
+		ThreadCachingAllocatorAdapter threadCachingAllocator;
+
+		for( size_t numProducers = 1; numProducers * 2 <= maxThreads; numProducers *= 2 ) {
+			const size_t numConsumers = numProducers;
+			const size_t totalAllocations = numProducers * allocationsPerProducer;
+			const std::string shape = " " + std::to_string( numProducers ) + "P" + std::to_string( numConsumers ) + "C";
+
+			context.measure( "threadCache", "crossThreadFree", "malloc" + shape, totalAllocations, numProducers + numConsumers, [ & ]() {
+				run( mallocAllocator, numProducers, numConsumers, allocationsPerProducer );
+			} );
+			context.measure( "threadCache", "crossThreadFree", "locked SlabPool" + shape, totalAllocations, numProducers + numConsumers, [ & ]() {
+				run( lockedSlabAllocator, numProducers, numConsumers, allocationsPerProducer );
+			} );
+			context.measure( "threadCache", "crossThreadFree", "ThreadCachingPool" + shape, totalAllocations, numProducers + numConsumers, [ & ]() {
+				run( threadCachingAllocator, numProducers, numConsumers, allocationsPerProducer );
+			} );
+		}
+	}
+
+	SuiteRegistration threadCacheSuite( "threadCache", runThreadCacheSuite );
+}
@@ -0,0 +1,186 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <assert.h>
+
+namespace CoreLib {
+namespace Algorithms {
+
+	////////////////////////////////////////////////////////////////////////////
+	// Search and reduction kernels
+	//
+	//	int		findIndex( data, count, value )	index of the first element equal to value, or -1
+	//	size_t	count( data, count, value )		number of elements equal to value
+	//	bool	contains( data, count, value )
+	//	T		min( data, count )					smallest element, count must be > 0
+	//	T		max( data, count )					largest element, count must be > 0
+	//	SumType	sum( data, count )
+	//
+	// The generic versions (also available for every type in the Scalar 
+	// namespace) compare with == and < and add with +. For int, unsigned int,
+	// float and double they are replaced by the SSE2 / AVX2 versions in the 
+	// Simd namespace, picking the best instruction set supported by the CPU 
+	// at runtime.
+	//
+	// Both versions give identical results: integers are summed into 64 bits,
+	// and floating point sums are accumulated in 8 interleaved partial sums 
+	// added up in a fixed order, whatever the vector width. The exceptions 
+	// are min / max over floating point data holding zeros of both signs, 
+	// where the sign of the zero returned depends on the order of the 
+	// comparisons, and sums hitting a NaN, which are NaN but may differ in 
+	// sign and payload.
+	////////////////////////////////////////////////////////////////////////////
+
+	template< typename T > struct SumType { typedef T type; };
+	template<> struct SumType< int > { typedef int64_t type; };
+	template<> struct SumType< unsigned int > { typedef uint64_t type; };
+
+	namespace Scalar {
+
+		template< typename T >
+		inline int findIndex( const T* data, size_t count, const T& value ) {
+			for( size_t i = 0; i < count; i++ ) {
+				if ( data[ i ] == value ) {
+					return (int)i;
+				}
+			}
+			return -1;
+		}
+
+		template< typename T >
+		inline size_t count( const T* data, size_t count, const T& value ) {
+			size_t found = 0;
+			for( size_t i = 0; i < count; i++ ) {
+				if ( data[ i ] == value ) {
+					found++;
+				}
+			}
+			return found;
+		}
+
+		template< typename T >
+		inline bool contains( const T* data, size_t count, const T& value ) {
+			return findIndex( data, count, value ) >= 0;
+		}
+
+		template< typename T >
+		inline T min( const T* data, size_t count ) {
+			assert( count > 0 );
+			T result = data[ 0 ];
+			for( size_t i = 1; i < count; i++ ) {
+				if ( data[ i ] < result ) {
+					result = data[ i ];
+				}
+			}
+			return result;
+		}
+
+		template< typename T >
+		inline T max( const T* data, size_t count ) {
+			assert( count > 0 );
+			T result = data[ 0 ];
+			for( size_t i = 1; i < count; i++ ) {
+				if ( result < data[ i ] ) {
+					result = data[ i ];
+				}
+			}
+			return result;
+		}
+
+		// element i goes to the partial sum i % 8 while there are whole 
+		// groups of 8, the remaining elements are added in order at the end.
+		// SumType() must be the additive identity.
+		template< typename T >
+		inline typename SumType< T >::type sum( const T* data, size_t count ) {
+			typedef typename SumType< T >::type Sum;
+			Sum partial[ 8 ] = { Sum(), Sum(), Sum(), Sum(), Sum(), Sum(), Sum(), Sum() };
+			size_t i = 0;
+			for( ; i + 8 <= count; i += 8 ) {
+				for( size_t lane = 0; lane < 8; lane++ ) {
+					partial[ lane ] = partial[ lane ] + (Sum)data[ i + lane ];
+				}
+			}
+			Sum result = ( ( partial[ 0 ] + partial[ 4 ] ) + ( partial[ 2 ] + partial[ 6 ] ) ) + ( ( partial[ 1 ] + partial[ 5 ] ) + ( partial[ 3 ] + partial[ 7 ] ) );
+			for( ; i < count; i++ ) {
+				result = result + (Sum)data[ i ];
+			}
+			return result;
+		}
+	}
+
+	namespace Simd {
+
+		enum InstructionSet {
+			INSTRUCTIONS_SCALAR,
+			INSTRUCTIONS_SSE2,
+			INSTRUCTIONS_AVX2
+		};
+
+		InstructionSet getSupportedInstructionSet();	// best instruction set of the CPU which the library was built with support for
+		InstructionSet getInstructionSet();				// instruction set used by the kernels
+		void setInstructionSet( InstructionSet set );	// restricts the kernels to the given instruction set, for testing and benchmarking
+
+		#define CORELIB_DECLARE_SIMD_KERNELS( T ) \
+			int findIndex( const T* data, size_t count, T value ); \
+			size_t count( const T* data, size_t count, T value ); \
+			T min( const T* data, size_t count ); \
+			T max( const T* data, size_t count ); \
+			SumType< T >::type sum( const T* data, size_t count ); \
+			inline bool contains( const T* data, size_t count, T value ) { return findIndex( data, count, value ) >= 0; }
+
+		CORELIB_DECLARE_SIMD_KERNELS( int )
+		CORELIB_DECLARE_SIMD_KERNELS( unsigned int )
+		CORELIB_DECLARE_SIMD_KERNELS( float )
+		CORELIB_DECLARE_SIMD_KERNELS( double )
+
+		#undef CORELIB_DECLARE_SIMD_KERNELS
+	}
+
+	// generic kernels
+	template< typename T > inline int findIndex( const T* data, size_t count, const T& value ) { return Scalar::findIndex( data, count, value ); }
+	template< typename T > inline size_t count( const T* data, size_t count, const T& value ) { return Scalar::count( data, count, value ); }
+	template< typename T > inline bool contains( const T* data, size_t count, const T& value ) { return Scalar::contains( data, count, value ); }
+	template< typename T > inline T min( const T* data, size_t count ) { return Scalar::min( data, count ); }
+	template< typename T > inline T max( const T* data, size_t count ) { return Scalar::max( data, count ); }
+	template< typename T > inline typename SumType< T >::type sum( const T* data, size_t count ) { return Scalar::sum( data, count ); }
+
+	// vectorized kernels, preferred by overload resolution
+	#define CORELIB_DISPATCH_SIMD_KERNELS( T ) \
+		inline int findIndex( const T* data, size_t count, const T& value ) { return Simd::findIndex( data, count, value ); } \
+		inline size_t count( const T* data, size_t count, const T& value ) { return Simd::count( data, count, value ); } \
+		inline bool contains( const T* data, size_t count, const T& value ) { return Simd::contains( data, count, value ); } \
+		inline T min( const T* data, size_t count ) { return Simd::min( data, count ); } \
+		inline T max( const T* data, size_t count ) { return Simd::max( data, count ); } \
+		inline SumType< T >::type sum( const T* data, size_t count ) { return Simd::sum( data, count ); }
+
+	CORELIB_DISPATCH_SIMD_KERNELS( int )
+	CORELIB_DISPATCH_SIMD_KERNELS( unsigned int )
+	CORELIB_DISPATCH_SIMD_KERNELS( float )
+	CORELIB_DISPATCH_SIMD_KERNELS( double )
+
+	#undef CORELIB_DISPATCH_SIMD_KERNELS
+
+} // namespace Algorithms
+} // namespace CoreLib
@@ -0,0 +1,141 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <assert.h>
+#include <type_traits>
+#include <utility>
+#include <containers/list/list.h>
+#include <jobs/jobSystem.h>
+
+namespace CoreLib {
+namespace Algorithms {
+
+	////////////////////////////////////////////////////////////////////////////
+	// Parallel algorithms over Lists
+	//
+	// Run on a JobSystem, splitting the list in subranges of grain elements.
+	// A grain of 0 picks one giving every worker a few subranges, of at 
+	// least PARALLEL_MIN_GRAIN elements so that cheap per element work isn't
+	// swamped by the cost of the jobs. The lists must not be resized while 
+	// the algorithms run.
+	////////////////////////////////////////////////////////////////////////////
+
+	const size_t PARALLEL_MIN_GRAIN = 1024;	// smallest automatic subrange, in elements
+
+	////////////////////////////////////////////////////////////////////////////
+	// parallelFor
+	//
+	// Calls function( element ) for every element of the list.
+	////////////////////////////////////////////////////////////////////////////
+	template< typename T, class Allocator, class Growth, class Function >
+	inline void parallelFor( Jobs::JobSystem& jobs, List< T, Allocator, Growth >& list, Function function, size_t grain = 0 ) {
+		T* elements = list.begin();
+		const size_t count = list.size();
+		if ( grain == 0 ) {
+			grain = jobs.autoGrain( count, PARALLEL_MIN_GRAIN );
+		}
+		jobs.parallelForRange( 0, count, grain, [ elements, &function ]( size_t first, size_t last ) {
+			for( size_t i = first; i < last; i++ ) {
+				function( elements[ i ] );
+			}
+		} );
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// parallelReduce
+	//
+	// Folds the list into a single value: each subrange is accumulated from 
+	// identity with accumulate( result, element ), and the partial results 
+	// combined with combine( a, b ). Partial results are combined in list 
+	// order, so the result doesn't depend on the scheduling (which matters 
+	// for floating point sums), although it does depend on the grain.
+	////////////////////////////////////////////////////////////////////////////
+	template< typename T, class Allocator, class Growth, typename Result, class Accumulate, class Combine, class = typename std::enable_if< !std::is_integral< Combine >::value >::type >
+	inline Result parallelReduce( Jobs::JobSystem& jobs, const List< T, Allocator, Growth >& list, const Result& identity, Accumulate accumulate, Combine combine, size_t grain = 0 ) {
+		const T* elements = list.begin();
+		const size_t count = list.size();
+		if ( count == 0 ) {
+			return identity;
+		}
+		if ( grain == 0 ) {
+			grain = jobs.autoGrain( count, PARALLEL_MIN_GRAIN );
+		}
+
+		const size_t numPieces = ( count + grain - 1 ) / grain;
+		List< Result > partials;
+		partials.preAllocate( numPieces );
+		for( size_t i = 0; i < numPieces; i++ ) {
+			partials.append( identity );
+		}
+
+		jobs.parallelForRange( 0, numPieces, 1, [ & ]( size_t firstPiece, size_t lastPiece ) {
+			for( size_t piece = firstPiece; piece < lastPiece; piece++ ) {
+				const size_t last = count - piece * grain > grain ? ( piece + 1 ) * grain : count;
+				Result result = identity;
+				for( size_t i = piece * grain; i < last; i++ ) {
+					result = accumulate( std::move( result ), elements[ i ] );
+				}
+				partials[ piece ] = std::move( result );
+			}
+		} );
+
+		Result result = std::move( partials[ 0 ] );
+		for( size_t i = 1; i < numPieces; i++ ) {
+			result = combine( std::move( result ), partials[ i ] );
+		}
+		return result;
+	}
+
+	// Reduction where the same operation accumulates elements and combines 
+	// partial results, e.g. a sum or a maximum.
+	template< typename T, class Allocator, class Growth, typename Result, class Reduce >
+	inline Result parallelReduce( Jobs::JobSystem& jobs, const List< T, Allocator, Growth >& list, const Result& identity, Reduce reduce, size_t grain = 0 ) {
+		return parallelReduce( jobs, list, identity, reduce, reduce, grain );
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// parallelTransform
+	//
+	// Resizes output to the size of input, and sets each of its elements to 
+	// function( input element ).
+	////////////////////////////////////////////////////////////////////////////
+	template< typename T, class InAllocator, class InGrowth, typename U, class OutAllocator, class OutGrowth, class Function >
+	inline void parallelTransform( Jobs::JobSystem& jobs, const List< T, InAllocator, InGrowth >& input, List< U, OutAllocator, OutGrowth >& output, Function function, size_t grain = 0 ) {
+		assert( (const void*)&input != (const void*)&output );
+		const size_t count = input.size();
+		output.resize( count );
+		const T* source = input.begin();
+		U* destination = output.begin();
+		if ( grain == 0 ) {
+			grain = jobs.autoGrain( count, PARALLEL_MIN_GRAIN );
+		}
+		jobs.parallelForRange( 0, count, grain, [ source, destination, &function ]( size_t first, size_t last ) {
+			for( size_t i = first; i < last; i++ ) {
+				destination[ i ] = function( source[ i ] );
+			}
+		} );
+	}
+
+} // namespace Algorithms
+} // namespace CoreLib
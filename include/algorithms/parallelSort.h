@@ -0,0 +1,296 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <memory/construct.h>
+#include <memory/standardAllocator.h>
+#include <containers/list/list.h>
+#include "sort.h"
+
+namespace CoreLib {
+namespace Algorithms {
+
+	////////////////////////////////////////////////////////////////////////////
+	// Executors
+	//
+	// The parallel algorithms run their tasks on an executor, exposing:
+	//
+	//	size_t	getConcurrency() const			number of tasks it can run at once
+	//	void	parallelFor( count, function )	calls function( i ) for every i in 
+	//											[0, count), returning once all the 
+	//											calls are done
+	////////////////////////////////////////////////////////////////////////////
+
+	////////////////////////////////////////////////////////////////////////////
+	// ThreadExecutor
+	//
+	// Runs each parallelFor on freshly started threads, with the calling 
+	// thread taking part. Meant for coarse grained tasks, where the cost of 
+	// starting the threads is negligible.
+	////////////////////////////////////////////////////////////////////////////
+	class ThreadExecutor {
+	public:
+		explicit ThreadExecutor( size_t numThreads = 0 ) // 0 uses every hardware thread
+			: numThreads( numThreads > 0 ? numThreads : std::thread::hardware_concurrency() ) {
+			if ( this->numThreads == 0 ) {
+				this->numThreads = 1;
+			}
+		}
+
+		size_t getConcurrency() const { return numThreads; }
+
+		template< class Function >
+		void parallelFor( size_t count, Function function ) {
+			std::atomic< size_t > next( 0 );
+			auto worker = [ & ]() {
+				for( size_t i = next.fetch_add( 1 ); i < count; i = next.fetch_add( 1 ) ) {
+					function( i );
+				}
+			};
+
+			std::vector< std::thread > threads;
+			for( size_t i = 1; i < numThreads && i < count; i++ ) {
+				threads.push_back( std::thread( worker ) );
+			}
+			worker();
+			for( size_t i = 0; i < threads.size(); i++ ) {
+				threads[ i ].join();
+			}
+		}
+
+	private:
+		size_t numThreads;
+	};
+
+	const size_t PARALLEL_SORT_THRESHOLD = 1 << 16;	// ranges below this size are sorted sequentially
+
+	////////////////////////////////////////////////////////////////////////////
+	// mergePathSplit
+	//
+	// Number of elements of a taken by the first 'diagonal' elements of the 
+	// merge of the sorted ranges a and b, where ties are taken from a.
+	////////////////////////////////////////////////////////////////////////////
+	template< typename T, class Less >
+	inline size_t mergePathSplit( const T* a, size_t aCount, const T* b, size_t bCount, size_t diagonal, Less& less ) {
+		size_t lo = diagonal > bCount ? diagonal - bCount : 0;
+		size_t hi = diagonal < aCount ? diagonal : aCount;
+		while( lo < hi ) {
+			size_t mid = ( lo + hi ) / 2;
+			if ( less( b[ diagonal - mid - 1 ], a[ mid ] ) ) {
+				hi = mid;
+			} else {
+				lo = mid + 1;
+			}
+		}
+		return lo;
+	}
+
+	// moves src into dst, which is uninitialized storage when Construct is set
+	template< bool Construct, typename T >
+	inline void moveTo( T* dst, T& src ) {
+		if ( Construct ) {
+			new( dst ) T( std::move( src ) );
+		} else {
+			*dst = std::move( src );
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// Merge rounds
+	//
+	// Each round merges pairs of consecutive sorted runs from src into dst, 
+	// where run i spans [runs[ i ], runs[ i + 1 ]) and the last entry is the 
+	// end of the range. Every task writes a slice of the output, starting at 
+	// the merge path split of the pair the slice begins in. The splits are 
+	// found before any task starts moving elements out of src.
+	////////////////////////////////////////////////////////////////////////////
+	
+	// first run of the pair holding the output element at position 'at'
+	inline size_t pairForPosition( const std::vector< size_t >& runs, size_t at ) {
+		size_t run = 0;
+		while( run + 2 < runs.size() - 1 && runs[ run + 2 ] <= at ) {
+			run += 2;
+		}
+		return run;
+	}
+
+	// number of elements taken from the first run of the pair before position 'at'
+	template< typename T, class Less >
+	inline size_t splitForPosition( const T* src, const std::vector< size_t >& runs, size_t at, Less& less ) {
+		const size_t numRuns = runs.size() - 1;
+		const size_t run = pairForPosition( runs, at );
+		const size_t middle = runs[ run + 1 ];
+		const size_t pairEnd = run + 2 <= numRuns ? runs[ run + 2 ] : middle;
+		return mergePathSplit( src + runs[ run ], middle - runs[ run ], src + middle, pairEnd - middle, at - runs[ run ], less );
+	}
+
+	// writes the output elements [outBegin, outEnd), given the splits for both positions
+	template< bool Construct, typename T, class Less >
+	inline void mergeRuns( T* src, T* dst, const std::vector< size_t >& runs, size_t outBegin, size_t outEnd, size_t beginSplit, size_t endSplit, Less& less ) {
+		const size_t numRuns = runs.size() - 1;
+		for( size_t run = pairForPosition( runs, outBegin ); run < numRuns && outBegin < outEnd; run += 2 ) {
+			const size_t pairBegin = runs[ run ];
+			const size_t middle = runs[ run + 1 ];
+			const size_t pairEnd = run + 2 <= numRuns ? runs[ run + 2 ] : middle; // an odd run out is just moved
+
+			T* a = src + pairBegin;
+			T* b = src + middle;
+			const size_t aCount = middle - pairBegin;
+			const size_t first = outBegin - pairBegin;
+			const size_t last = ( outEnd < pairEnd ? outEnd : pairEnd ) - pairBegin;
+
+			// only the elements of this slice are read, the rest may be 
+			// moved out by other tasks at any time
+			size_t i = beginSplit;
+			size_t j = first - i;
+			const size_t aEnd = pairBegin + last < pairEnd ? endSplit : aCount;
+			const size_t bEnd = last - aEnd;
+			T* out = dst + outBegin;
+			while( i < aEnd && j < bEnd ) {
+				if ( less( b[ j ], a[ i ] ) ) {
+					moveTo< Construct >( out++, b[ j++ ] );
+				} else {
+					moveTo< Construct >( out++, a[ i++ ] );
+				}
+			}
+			for( ; i < aEnd; i++ ) {
+				moveTo< Construct >( out++, a[ i ] );
+			}
+			for( ; j < bEnd; j++ ) {
+				moveTo< Construct >( out++, b[ j ] );
+			}
+			outBegin = pairBegin + last;
+			beginSplit = 0; // following pairs are merged from their start
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// parallelSort
+	//
+	// Merge sort running on the executor. The range is split in one chunk 
+	// per task, which are sorted concurrently, and then merged in pairs until 
+	// a single run remains. Every merge round is split evenly across the 
+	// tasks using merge path partitioning, so all the tasks are kept busy up
+	// to the last merge. Ranges below PARALLEL_SORT_THRESHOLD, or with a 
+	// single task, fall back to the sequential sort. The scratch storage for 
+	// the merges is drawn from the allocator.
+	////////////////////////////////////////////////////////////////////////////
+	template< typename T, class Less, class Executor, class Allocator >
+	inline void parallelSort( T* first, T* last, Less less, Executor& executor, Allocator& allocator ) {
+		const size_t count = (size_t)( last - first );
+		size_t numTasks = executor.getConcurrency();
+		if ( count < PARALLEL_SORT_THRESHOLD || numTasks < 2 ) {
+			sort( first, last, less );
+			return;
+		}
+
+		std::vector< size_t > runs( numTasks + 1 );
+		for( size_t i = 0; i <= numTasks; i++ ) {
+			runs[ i ] = count * i / numTasks;
+		}
+
+		executor.parallelFor( numTasks, [ & ]( size_t task ) {
+			sort( first + runs[ task ], first + runs[ task + 1 ], less );
+		} );
+
+		T* scratch = allocator.allocRaw( count );
+		bool scratchConstructed = false;
+		T* src = first;
+		T* dst = scratch;
+		std::vector< size_t > splits( numTasks + 1 );
+		while( runs.size() > 2 ) {
+			executor.parallelFor( numTasks, [ & ]( size_t task ) {
+				splits[ task ] = splitForPosition( src, runs, count * task / numTasks, less );
+			} );
+			splits[ numTasks ] = 0;
+			executor.parallelFor( numTasks, [ & ]( size_t task ) {
+				size_t outBegin = count * task / numTasks;
+				size_t outEnd = count * ( task + 1 ) / numTasks;
+				if ( dst == scratch && !scratchConstructed ) {
+					mergeRuns< true >( src, dst, runs, outBegin, outEnd, splits[ task ], splits[ task + 1 ], less );
+				} else {
+					mergeRuns< false >( src, dst, runs, outBegin, outEnd, splits[ task ], splits[ task + 1 ], less );
+				}
+			} );
+			scratchConstructed = true;
+
+			std::vector< size_t > merged;
+			for( size_t run = 0; run + 1 < runs.size(); run += 2 ) {
+				merged.push_back( runs[ run ] );
+			}
+			merged.push_back( count );
+			runs.swap( merged );
+			std::swap( src, dst );
+		}
+
+		if ( src != first ) {
+			executor.parallelFor( numTasks, [ & ]( size_t task ) {
+				size_t end = count * ( task + 1 ) / numTasks;
+				for( size_t i = count * task / numTasks; i < end; i++ ) {
+					first[ i ] = std::move( scratch[ i ] );
+				}
+			} );
+		}
+		Memory::destroy( scratch, count );
+		allocator.freeRaw( scratch, count );
+	}
+
+	template< typename T, class Less, class Executor, class = typename std::enable_if< !std::is_integral< Executor >::value >::type >
+	inline void parallelSort( T* first, T* last, Less less, Executor& executor ) {
+		Memory::StandardAllocator< T > allocator;
+		parallelSort( first, last, less, executor, allocator );
+	}
+
+	template< typename T, class Less >
+	inline void parallelSort( T* first, T* last, Less less, size_t numThreads = 0 ) {
+		ThreadExecutor executor( numThreads );
+		parallelSort( first, last, less, executor );
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// parallelSort( List )
+	//
+	// Sorts the list with the parallel merge sort, on the executor or on 
+	// numThreads threads (0 for every hardware thread), using scratch storage
+	// from a copy of the list allocator.
+	////////////////////////////////////////////////////////////////////////////
+	template< typename T, class Allocator, class Growth, class Less, class Executor, class = typename std::enable_if< !std::is_integral< Executor >::value >::type >
+	inline void parallelSort( List< T, Allocator, Growth >& list, Less less, Executor& executor ) {
+		Allocator allocator( list.getAllocator() );
+		parallelSort( list.begin(), list.end(), less, executor, allocator );
+	}
+
+	template< typename T, class Allocator, class Growth, class Less >
+	inline void parallelSort( List< T, Allocator, Growth >& list, Less less, size_t numThreads = 0 ) {
+		ThreadExecutor executor( numThreads );
+		parallelSort( list, less, executor );
+	}
+
+} // namespace Algorithms
+} // namespace CoreLib
@@ -0,0 +1,320 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <memory/construct.h>
+#include <memory/standardAllocator.h>
+
+namespace CoreLib {
+namespace Algorithms {
+
+	////////////////////////////////////////////////////////////////////////////
+	// Sorting
+	//
+	// Comparison sorts take a 'less' functor, which is inlined into the 
+	// sorting loop, and move the elements with their move constructor and 
+	// assignment operator, so they're safe for any type. 
+	//
+	// Sorting by key extracts a key from each element with a functor. 
+	// Integral and floating point keys are sorted with an LSD radix sort 
+	// when the elements are relocatable and the range is large enough, 
+	// falling back to the comparison sort on the keys otherwise.
+	//
+	// None of the sorts are stable.
+	////////////////////////////////////////////////////////////////////////////
+
+	const size_t INSERTION_SORT_THRESHOLD = 16;	// ranges up to this size are insertion sorted
+	const size_t RADIX_SORT_THRESHOLD = 256;	// ranges below this size are comparison sorted
+
+	////////////////////////////////////////////////////////////////////////////
+	// RadixKey
+	//
+	// Maps a key to an unsigned integer which sorts in the same order, so 
+	// the radix sort can process it one byte at a time. Only defined for 
+	// integral and floating point keys; NaNs sort before or after every 
+	// other value depending on their sign.
+	////////////////////////////////////////////////////////////////////////////
+	template< typename Key, typename Enable = void >
+	struct RadixKey {
+		static const bool supported = false;
+	};
+
+	template< typename Key >
+	struct RadixKey< Key, typename std::enable_if< std::is_integral< Key >::value && !std::is_same< Key, bool >::value >::type > {
+		static const bool supported = true;
+		typedef typename std::make_unsigned< Key >::type Bits;
+
+		inline static Bits toBits( Key key ) {
+			const Bits signBit = (Bits)( (Bits)1 << ( sizeof( Bits ) * 8 - 1 ) );
+			// flipping the sign bit places negative values first
+			return std::is_signed< Key >::value ? (Bits)( (Bits)key ^ signBit ) : (Bits)key;
+		}
+	};
+
+	template<>
+	struct RadixKey< float > {
+		static const bool supported = true;
+		typedef uint32_t Bits;
+
+		inline static Bits toBits( float key ) {
+			Bits bits;
+			memcpy( &bits, &key, sizeof( bits ) );
+			// negative values sort in reverse magnitude order
+			return ( bits & 0x80000000u ) ? ~bits : ( bits | 0x80000000u );
+		}
+	};
+
+	template<>
+	struct RadixKey< double > {
+		static const bool supported = true;
+		typedef uint64_t Bits;
+
+		inline static Bits toBits( double key ) {
+			Bits bits;
+			memcpy( &bits, &key, sizeof( bits ) );
+			return ( bits & 0x8000000000000000ull ) ? ~bits : ( bits | 0x8000000000000000ull );
+		}
+	};
+
+	// type of the key extracted from a T by the KeyOf functor
+	template< typename T, class KeyOf >
+	struct KeyType {
+		typedef typename std::decay< decltype( std::declval< KeyOf& >()( std::declval< const T& >() ) ) >::type type;
+	};
+
+	// whether sortByKey will use the radix sort for the given element and key types
+	template< typename T, class KeyOf >
+	struct CanRadixSort {
+		static const bool value = RadixKey< typename KeyType< T, KeyOf >::type >::supported && Memory::IsRelocatable< T >::value;
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// insertionSort
+	////////////////////////////////////////////////////////////////////////////
+	template< typename T, class Less >
+	inline void insertionSort( T* first, T* last, Less& less ) {
+		if ( first == last ) {
+			return;
+		}
+		for( T* i = first + 1; i < last; i++ ) {
+			T value( std::move( *i ) );
+			if ( less( value, *first ) ) {
+				std::move_backward( first, i, i + 1 );
+				*first = std::move( value );
+			} else {
+				// *first acts as a sentinel, no need to check the range bounds
+				T* j = i;
+				for( ; less( value, *( j - 1 ) ); j-- ) {
+					*j = std::move( *( j - 1 ) );
+				}
+				*j = std::move( value );
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// introSortLoop
+	//
+	// Quicksort with a median of three pivot, which switches to heapsort 
+	// when the recursion gets too deep to guarantee O(n log n). Leaves the 
+	// ranges below INSERTION_SORT_THRESHOLD to the insertion sort.
+	////////////////////////////////////////////////////////////////////////////
+	template< typename T, class Less >
+	inline void introSortLoop( T* first, T* last, size_t depthLimit, Less& less ) {
+		using std::swap;
+		while( (size_t)( last - first ) > INSERTION_SORT_THRESHOLD ) {
+			if ( depthLimit == 0 ) {
+				std::make_heap( first, last, less );
+				std::sort_heap( first, last, less );
+				return;
+			}
+			depthLimit--;
+
+			// move the median of three elements to the front as the pivot
+			T* a = first + 1;
+			T* b = first + ( last - first ) / 2;
+			T* c = last - 1;
+			if ( less( *a, *b ) ) {
+				if ( less( *b, *c ) ) {
+					swap( *first, *b );
+				} else if ( less( *a, *c ) ) {
+					swap( *first, *c );
+				} else {
+					swap( *first, *a );
+				}
+			} else if ( less( *a, *c ) ) {
+				swap( *first, *a );
+			} else if ( less( *b, *c ) ) {
+				swap( *first, *c );
+			} else {
+				swap( *first, *b );
+			}
+
+			// Hoare partition, the median of three guarantees both scans 
+			// stop within the range
+			T* lo = first + 1;
+			T* hi = last;
+			for( ;; ) {
+				while( less( *lo, *first ) ) {
+					lo++;
+				}
+				hi--;
+				while( less( *first, *hi ) ) {
+					hi--;
+				}
+				if ( !( lo < hi ) ) {
+					break;
+				}
+				swap( *lo, *hi );
+				lo++;
+			}
+
+			introSortLoop( lo, last, depthLimit, less );
+			last = lo;
+		}
+		insertionSort( first, last, less );
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// sort
+	//
+	// Sorts [first, last) in ascending order according to less( a, b ).
+	////////////////////////////////////////////////////////////////////////////
+	template< typename T, class Less >
+	inline void sort( T* first, T* last, Less less ) {
+		if ( last - first < 2 ) {
+			return;
+		}
+		size_t depthLimit = 0;
+		for( size_t n = (size_t)( last - first ); n > 1; n >>= 1 ) {
+			depthLimit += 2;
+		}
+		introSortLoop( first, last, depthLimit, less );
+	}
+
+	template< typename T >
+	inline void sort( T* first, T* last ) {
+		sort( first, last, std::less< T >() );
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// radixSort
+	//
+	// LSD radix sort of count relocatable elements by the key returned by 
+	// the KeyOf functor, one byte per pass. The elements are bitwise moved 
+	// back and forth between data and scratch, which must be uninitialized 
+	// storage for count elements; the result is always left in data. Passes
+	// where every key shares the same byte are skipped.
+	////////////////////////////////////////////////////////////////////////////
+	template< typename T, class KeyOf >
+	inline void radixSort( T* data, T* scratch, size_t count, KeyOf key ) {
+		static_assert( Memory::IsRelocatable< T >::value, "radixSort moves the elements bitwise" );
+		typedef RadixKey< typename KeyType< T, KeyOf >::type > Radix;
+		static_assert( Radix::supported, "radixSort requires an integral or floating point key" );
+		typedef typename Radix::Bits Bits;
+		const size_t numPasses = sizeof( Bits );
+
+		if ( count < 2 ) {
+			return;
+		}
+
+		// histograms for every pass in a single read of the data
+		size_t counts[ numPasses ][ 256 ];
+		memset( counts, 0, sizeof( counts ) );
+		for( size_t i = 0; i < count; i++ ) {
+			Bits bits = Radix::toBits( key( data[ i ] ) );
+			for( size_t pass = 0; pass < numPasses; pass++ ) {
+				counts[ pass ][ ( bits >> ( pass * 8 ) ) & 0xFF ]++;
+			}
+		}
+
+		T* src = data;
+		T* dst = scratch;
+		for( size_t pass = 0; pass < numPasses; pass++ ) {
+			const size_t shift = pass * 8;
+			size_t* offsets = counts[ pass ];
+			if ( offsets[ ( Radix::toBits( key( src[ 0 ] ) ) >> shift ) & 0xFF ] == count ) {
+				continue;
+			}
+
+			size_t offset = 0;
+			for( size_t digit = 0; digit < 256; digit++ ) {
+				size_t digitCount = offsets[ digit ];
+				offsets[ digit ] = offset;
+				offset += digitCount;
+			}
+
+			for( size_t i = 0; i < count; i++ ) {
+				size_t digit = ( Radix::toBits( key( src[ i ] ) ) >> shift ) & 0xFF;
+				memcpy( (void*)( dst + offsets[ digit ]++ ), (const void*)( src + i ), sizeof( T ) );
+			}
+			std::swap( src, dst );
+		}
+
+		if ( src != data ) {
+			memcpy( (void*)data, (const void*)src, count * sizeof( T ) );
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// sortByKey
+	//
+	// Sorts [first, last) in ascending key order. The radix sort path draws 
+	// its scratch storage from the allocator's allocRaw/freeRaw.
+	////////////////////////////////////////////////////////////////////////////
+	template< typename T, class KeyOf, class Allocator >
+	inline void sortByKey( T* first, T* last, KeyOf key, Allocator& allocator, std::true_type /*canRadixSort*/ ) {
+		const size_t count = (size_t)( last - first );
+		T* scratch = allocator.allocRaw( count );
+		radixSort( first, scratch, count, key );
+		allocator.freeRaw( scratch, count );
+	}
+
+	template< typename T, class KeyOf, class Allocator >
+	inline void sortByKey( T* first, T* last, KeyOf key, Allocator& /*allocator*/, std::false_type /*canRadixSort*/ ) {
+		sort( first, last, [ &key ]( const T& a, const T& b ) { return key( a ) < key( b ); } );
+	}
+
+	template< typename T, class KeyOf, class Allocator >
+	inline void sortByKey( T* first, T* last, KeyOf key, Allocator& allocator ) {
+		if ( (size_t)( last - first ) < RADIX_SORT_THRESHOLD ) {
+			sortByKey( first, last, key, allocator, std::false_type() );
+		} else {
+			sortByKey( first, last, key, allocator, std::integral_constant< bool, CanRadixSort< T, KeyOf >::value >() );
+		}
+	}
+
+	template< typename T, class KeyOf >
+	inline void sortByKey( T* first, T* last, KeyOf key ) {
+		Memory::StandardAllocator< T > allocator;
+		sortByKey( first, last, key, allocator );
+	}
+
+} // namespace Algorithms
+} // namespace CoreLib
@@ -0,0 +1,139 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <assert.h>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <memory/alignment.h>
+#include <memory/construct.h>
+#include <memory/standardAllocator.h>
+#include <containers/list/list.h>
+
+namespace CoreLib {
+
+	//////////////////////////////////////////////////////////////////////////
+	// class ConcurrentList
+	//
+	// Append-only list which any number of threads can append to at once, 
+	// e.g. to collect the results of a parallel stage:
+	//
+	//	ConcurrentList< Hit > hits;
+	//	parallelFor( ..., [ & ]( size_t i ) { if ( test( i ) ) hits.append( Hit( i ) ); } );
+	//	List< Hit > result;
+	//	hits.moveTo( result );
+	//
+	// Appending reserves slots with an atomic fetch-add, so a batch of 
+	// elements (appendRange) costs a single atomic. The storage is a table 
+	// of segments doubling in size, allocated on demand, so elements never 
+	// move once appended and references to them remain valid until clear.
+	//
+	// Each slot carries a ready flag, set once its element is constructed, 
+	// stored after the elements of its segment in the same allocation from 
+	// the allocator policy. size() returns the number of elements in the prefix of ready slots 
+	// (advancing a shared watermark), so that any thread can read the 
+	// elements below it while others keep appending. Appending threads never
+	// wait for each other.
+	// 
+	// clear and moveTo are not thread safe, and must not be called while 
+	// other threads are appending or reading.
+	//////////////////////////////////////////////////////////////////////////
+	template< typename T, class Allocator = CoreLib::Memory::StandardAllocator< T > >
+	class ConcurrentList : private Allocator {
+	public:
+		typedef const T			ConstType;
+		typedef T				Type;
+
+		explicit ConcurrentList( size_t firstSegmentSize = DEFAULT_FIRST_SEGMENT_SIZE );
+		explicit ConcurrentList( const Allocator& allocator, size_t firstSegmentSize = DEFAULT_FIRST_SEGMENT_SIZE );
+		~ConcurrentList();
+
+		// thread safe
+		size_t		append( ConstType& obj );					// append element, returns its index
+		size_t		append( Type&& obj );						// append element, moving it into the list
+		template< typename... Args >
+		size_t		emplace( Args&&... args );					// append an element constructed in place from args
+		size_t		appendRange( ConstType* first, size_t count );	// append count elements copied from first, returns the index of the first one
+
+		size_t		size() const;								// number of published elements, those in the prefix of constructed ones
+		bool		empty() const;
+
+		Type&		operator[]( size_t index );					// index must be below size()
+		ConstType&	operator[]( size_t index ) const;
+
+		template< class Function >
+		void		forEachSegment( Function f ) const;			// calls f( const T* elements, size_t count ) over the published elements, one contiguous run at a time
+
+		// not thread safe
+		void		clear();									// destroys the elements and releases the storage
+		template< class ListAllocator, class ListGrowth >
+		void		moveTo( List< T, ListAllocator, ListGrowth >& list );	// moves the elements to the end of list, leaving this list empty
+
+		const Allocator& getAllocator() const;
+
+	private:
+		ConcurrentList( const ConcurrentList& );
+		ConcurrentList& operator=( const ConcurrentList& );
+
+		size_t		reserve( size_t count );					// reserves count slots, returns the first one
+		void		markReady( size_t first, size_t count );	// flags the given slots as constructed
+
+		size_t		segmentIndex( size_t index ) const;
+		size_t		segmentBegin( size_t segment ) const;
+		size_t		segmentSize( size_t segment ) const;
+		size_t		segmentSlots( size_t segment ) const;		// T sized slots allocated for a segment: its elements, then their ready flags
+		Type*		slot( size_t index ) const;
+		void		allocateSegment( size_t segment );
+
+		template< class ListAllocator, class ListGrowth >
+		static void	moveRun( List< T, ListAllocator, ListGrowth >& list, T* elements, size_t count, std::true_type );
+		template< class ListAllocator, class ListGrowth >
+		static void	moveRun( List< T, ListAllocator, ListGrowth >& list, T* elements, size_t count, std::false_type );
+
+		static size_t log2( size_t value );
+
+	private:
+		static const size_t DEFAULT_FIRST_SEGMENT_SIZE = 64;
+		static const size_t MAX_SEGMENTS = sizeof( size_t ) * 8;
+
+		typedef std::atomic< unsigned char > ReadyFlag;
+		static_assert( std::alignment_of< ReadyFlag >::value <= std::alignment_of< T >::value, "the ready flags are stored right after the elements" );
+
+		ReadyFlag*	readyFlags( Type* elements, size_t segment ) const;	// flags of the segment holding elements
+
+		// the counters are written by every appending (or reading) thread, 
+		// keep them away from each other and from the read-mostly tables
+		std::atomic< size_t >			reserved;
+		char							reservedPadding[ Memory::CACHE_LINE_SIZE - sizeof( std::atomic< size_t > ) ];
+		mutable std::atomic< size_t >	published;		// watermark below which every slot is known to be ready
+		char							publishedPadding[ Memory::CACHE_LINE_SIZE - sizeof( std::atomic< size_t > ) ];
+
+		size_t							firstSegmentBits;				// log2 of the size of the first segment
+		std::atomic< T* >				segments[ MAX_SEGMENTS ];		// segment k holds firstSegmentSize << k elements, followed by their ready flags
+	};
+
+	#include "concurrentList.inl"
+}
@@ -0,0 +1,398 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::ConcurrentList( size_t )
+//
+// The first segment size is rounded up to a power of two.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline ConcurrentList< type, AllocPolicy >::ConcurrentList( size_t firstSegmentSize )
+	:	reserved( 0 ),
+		published( 0 ),
+		firstSegmentBits( firstSegmentSize > 1 ? log2( firstSegmentSize - 1 ) + 1 : 0 ) {
+	for( size_t i = 0; i < MAX_SEGMENTS; i++ ) {
+		segments[ i ].store( NULL, std::memory_order_relaxed );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::ConcurrentList( const AllocPolicy &, size_t )
+//
+// Creates an empty list drawing its segments from the given allocator, 
+// which must be thread safe.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline ConcurrentList< type, AllocPolicy >::ConcurrentList( const AllocPolicy& allocator, size_t firstSegmentSize )
+	:	AllocPolicy( allocator ),
+		reserved( 0 ),
+		published( 0 ),
+		firstSegmentBits( firstSegmentSize > 1 ? log2( firstSegmentSize - 1 ) + 1 : 0 ) {
+	for( size_t i = 0; i < MAX_SEGMENTS; i++ ) {
+		segments[ i ].store( NULL, std::memory_order_relaxed );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::~ConcurrentList
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline ConcurrentList< type, AllocPolicy >::~ConcurrentList() {
+	clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::append
+//
+// Copies the element into the next free slot. Thread safe.
+// Returns the index of the new element.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t ConcurrentList< type, AllocPolicy >::append( type const & obj ) {
+	const size_t index = reserve( 1 );
+	new( slot( index ) ) type( obj );
+	markReady( index, 1 );
+	return index;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::append
+//
+// Moves the element into the next free slot. Thread safe.
+// Returns the index of the new element.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t ConcurrentList< type, AllocPolicy >::append( type&& obj ) {
+	const size_t index = reserve( 1 );
+	new( slot( index ) ) type( std::move( obj ) );
+	markReady( index, 1 );
+	return index;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::emplace
+//
+// Constructs a new element in the next free slot, forwarding the given 
+// arguments to its constructor. Thread safe.
+// Returns the index of the new element.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+template< typename... Args >
+inline size_t ConcurrentList< type, AllocPolicy >::emplace( Args&&... args ) {
+	const size_t index = reserve( 1 );
+	new( slot( index ) ) type( std::forward< Args >( args )... );
+	markReady( index, 1 );
+	return index;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::appendRange
+//
+// Reserves count consecutive slots at once and copies the elements into 
+// them, one segment at a time. Thread safe.
+// Returns the index of the first appended element.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t ConcurrentList< type, AllocPolicy >::appendRange( const type* first, size_t count ) {
+	if ( count == 0 ) {
+		return size();
+	}
+
+	const size_t begin = reserve( count );
+	size_t done = 0;
+	while( done < count ) {
+		const size_t index = begin + done;
+		const size_t segment = segmentIndex( index );
+		const size_t segmentLeft = segmentBegin( segment ) + segmentSize( segment ) - index;
+		const size_t run = count - done < segmentLeft ? count - done : segmentLeft;
+		Memory::copyConstruct( slot( index ), first + done, run );
+		done += run;
+	}
+	markReady( begin, count );
+
+	return begin;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::size
+//
+// Returns the number of published elements: the slots up to the first one
+// still being constructed by another thread. The shared watermark is moved
+// forward past the slots found ready, so each slot is only checked about 
+// once.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t ConcurrentList< type, AllocPolicy >::size() const {
+	const size_t watermark = published.load( std::memory_order_acquire );
+	const size_t limit = reserved.load( std::memory_order_relaxed );
+
+	size_t count = watermark;
+	while( count < limit ) {
+		const size_t segment = segmentIndex( count );
+		type* elements = segments[ segment ].load( std::memory_order_acquire );
+		if ( elements == NULL || readyFlags( elements, segment )[ count - segmentBegin( segment ) ].load( std::memory_order_acquire ) == 0 ) {
+			break;
+		}
+		count++;
+	}
+
+	// other readers may be advancing it too, only ever move it forward
+	size_t current = watermark;
+	while( current < count && !published.compare_exchange_weak( current, count, std::memory_order_acq_rel, std::memory_order_acquire ) ) {
+	}
+	return count > current ? count : current;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::empty
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline bool ConcurrentList< type, AllocPolicy >::empty() const {
+	return size() == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::operator[]
+//
+// Access to a published element, which never moves while the list is 
+// alive. Reading it is safe while other threads append, writing it must be 
+// synchronized by the caller.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline type& ConcurrentList< type, AllocPolicy >::operator[]( size_t index ) {
+	assert( index < published.load( std::memory_order_relaxed ) );
+	return *slot( index );
+}
+
+template< typename type, class AllocPolicy >
+inline const type& ConcurrentList< type, AllocPolicy >::operator[]( size_t index ) const {
+	assert( index < published.load( std::memory_order_relaxed ) );
+	return *slot( index );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::forEachSegment
+//
+// Calls f( const type* elements, size_t count ) for every contiguous run of
+// the elements published when called, in index order.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+template< class Function >
+inline void ConcurrentList< type, AllocPolicy >::forEachSegment( Function f ) const {
+	const size_t count = size();
+	for( size_t segment = 0; segmentBegin( segment ) < count; segment++ ) {
+		const size_t begin = segmentBegin( segment );
+		const size_t run = count - begin < segmentSize( segment ) ? count - begin : segmentSize( segment );
+		f( static_cast< const type* >( segments[ segment ].load( std::memory_order_acquire ) ), run );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::clear
+//
+// Destroys the elements and releases every segment. Not thread safe.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline void ConcurrentList< type, AllocPolicy >::clear() {
+	const size_t count = size();
+	assert( reserved.load( std::memory_order_relaxed ) == count );
+
+	for( size_t segment = 0; segment < MAX_SEGMENTS; segment++ ) {
+		type* elements = segments[ segment ].load( std::memory_order_relaxed );
+		if ( elements == NULL ) {
+			continue;
+		}
+		const size_t begin = segmentBegin( segment );
+		if ( begin < count ) {
+			Memory::destroy( elements, count - begin < segmentSize( segment ) ? count - begin : segmentSize( segment ) );
+		}
+		// the ready flags are trivially destructible
+		AllocPolicy::freeRaw( elements, segmentSlots( segment ) );
+		segments[ segment ].store( NULL, std::memory_order_relaxed );
+	}
+
+	reserved.store( 0, std::memory_order_relaxed );
+	published.store( 0, std::memory_order_release );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::moveTo
+//
+// Hands the elements over to the end of a plain List, allocating its 
+// storage once and moving the elements a segment at a time (a single 
+// memcpy per segment for trivially copyable types). This list is left 
+// empty. Not thread safe.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+template< class ListAllocator, class ListGrowth >
+inline void ConcurrentList< type, AllocPolicy >::moveTo( List< type, ListAllocator, ListGrowth >& list ) {
+	const size_t count = size();
+	list.preAllocate( list.size() + count );
+
+	for( size_t segment = 0; segmentBegin( segment ) < count; segment++ ) {
+		const size_t begin = segmentBegin( segment );
+		const size_t run = count - begin < segmentSize( segment ) ? count - begin : segmentSize( segment );
+		moveRun( list, segments[ segment ].load( std::memory_order_relaxed ), run, std::integral_constant< bool, std::is_trivially_copyable< type >::value >() );
+	}
+
+	// destroys the moved from elements
+	clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::getAllocator
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline const AllocPolicy& ConcurrentList< type, AllocPolicy >::getAllocator() const {
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::reserve
+//
+// Claims count consecutive slots with a single atomic, and makes sure the 
+// segments holding them are allocated. Returns the index of the first one.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t ConcurrentList< type, AllocPolicy >::reserve( size_t count ) {
+	assert( count > 0 );
+	const size_t first = reserved.fetch_add( count, std::memory_order_relaxed );
+	const size_t lastSegment = segmentIndex( first + count - 1 );
+	assert( lastSegment < MAX_SEGMENTS );
+	for( size_t segment = segmentIndex( first ); segment <= lastSegment; segment++ ) {
+		if ( segments[ segment ].load( std::memory_order_acquire ) == NULL ) {
+			allocateSegment( segment );
+		}
+	}
+	return first;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::markReady
+//
+// Flags the slots [first, first + count) as holding a constructed element,
+// so that size() can count them once every preceding slot is ready too. 
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline void ConcurrentList< type, AllocPolicy >::markReady( size_t first, size_t count ) {
+	size_t done = 0;
+	while( done < count ) {
+		const size_t index = first + done;
+		const size_t segment = segmentIndex( index );
+		const size_t segmentLeft = segmentBegin( segment ) + segmentSize( segment ) - index;
+		const size_t run = count - done < segmentLeft ? count - done : segmentLeft;
+		ReadyFlag* flags = readyFlags( segments[ segment ].load( std::memory_order_relaxed ), segment ) + ( index - segmentBegin( segment ) );
+		for( size_t i = 0; i < run; i++ ) {
+			flags[ i ].store( 1, std::memory_order_release );
+		}
+		done += run;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::allocateSegment
+//
+// Allocates the storage of a segment, with its ready flags cleared, unless
+// another thread beat us to it, in which case ours is released.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline void ConcurrentList< type, AllocPolicy >::allocateSegment( size_t segment ) {
+	type* storage = AllocPolicy::allocRaw( segmentSlots( segment ) );
+	ReadyFlag* flags = readyFlags( storage, segment );
+	for( size_t i = 0; i < segmentSize( segment ); i++ ) {
+		new( flags + i ) ReadyFlag( 0 );
+	}
+
+	type* expected = NULL;
+	if ( !segments[ segment ].compare_exchange_strong( expected, storage, std::memory_order_acq_rel ) ) {
+		AllocPolicy::freeRaw( storage, segmentSlots( segment ) );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::segmentIndex
+//
+// Segment k starts at index firstSegmentSize * ( 2^k - 1 ).
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t ConcurrentList< type, AllocPolicy >::segmentIndex( size_t index ) const {
+	return log2( ( index >> firstSegmentBits ) + 1 );
+}
+
+template< typename type, class AllocPolicy >
+inline size_t ConcurrentList< type, AllocPolicy >::segmentBegin( size_t segment ) const {
+	return ( ( (size_t)1 << segment ) - 1 ) << firstSegmentBits;
+}
+
+template< typename type, class AllocPolicy >
+inline size_t ConcurrentList< type, AllocPolicy >::segmentSize( size_t segment ) const {
+	return (size_t)1 << ( segment + firstSegmentBits );
+}
+
+template< typename type, class AllocPolicy >
+inline size_t ConcurrentList< type, AllocPolicy >::segmentSlots( size_t segment ) const {
+	return segmentSize( segment ) + ( segmentSize( segment ) * sizeof( ReadyFlag ) + sizeof( type ) - 1 ) / sizeof( type );
+}
+
+template< typename type, class AllocPolicy >
+inline typename ConcurrentList< type, AllocPolicy >::ReadyFlag* ConcurrentList< type, AllocPolicy >::readyFlags( type* elements, size_t segment ) const {
+	return reinterpret_cast< ReadyFlag* >( elements + segmentSize( segment ) );
+}
+
+template< typename type, class AllocPolicy >
+inline type* ConcurrentList< type, AllocPolicy >::slot( size_t index ) const {
+	const size_t segment = segmentIndex( index );
+	return segments[ segment ].load( std::memory_order_acquire ) + ( index - segmentBegin( segment ) );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::moveRun
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+template< class ListAllocator, class ListGrowth >
+inline void ConcurrentList< type, AllocPolicy >::moveRun( List< type, ListAllocator, ListGrowth >& list, type* elements, size_t count, std::true_type ) {
+	list.appendRange( elements, count );
+}
+
+template< typename type, class AllocPolicy >
+template< class ListAllocator, class ListGrowth >
+inline void ConcurrentList< type, AllocPolicy >::moveRun( List< type, ListAllocator, ListGrowth >& list, type* elements, size_t count, std::false_type ) {
+	for( size_t i = 0; i < count; i++ ) {
+		list.append( std::move( elements[ i ] ) );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ConcurrentList< type, AllocPolicy >::log2
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t ConcurrentList< type, AllocPolicy >::log2( size_t value ) {
+#if defined( __GNUC__ )
+	return sizeof( unsigned long long ) * 8 - 1 - __builtin_clzll( (unsigned long long)value );
+#else
+	size_t result = 0;
+	while( value >>= 1 ) {
+		result++;
+	}
+	return result;
+#endif
+}
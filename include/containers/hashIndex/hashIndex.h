@@ -0,0 +1,138 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <assert.h>
+#include <functional>
+
+namespace CoreLib {
+
+	//////////////////////////////////////////////////////////////////////////
+	// class HashIndex
+	//
+	// Maps integer keys to the indices of the elements of an external array,
+	// in the spirit of the idLib hash index. Buckets are singly linked 
+	// chains threaded through an array indexed by element index, so the 
+	// index itself stores no element data:
+	//
+	//	for( int i = hashIndex.first( key ); i != -1; i = hashIndex.next( i ) ) {
+	//		if ( elements[ i ] == value ) ...
+	//	}
+	//
+	// The number of buckets doubles whenever there are as many entries as 
+	// buckets, keeping add, remove and lookups expected O(1). The key of 
+	// each index is stored, so entries can be removed or moved by index.
+	//////////////////////////////////////////////////////////////////////////
+	class HashIndex {
+	public:
+		explicit HashIndex( size_t initialHashSize = DEFAULT_HASH_SIZE, size_t initialIndexSize = DEFAULT_HASH_SIZE );
+		HashIndex( const HashIndex& other );
+		HashIndex( HashIndex&& other );
+		~HashIndex();
+
+		HashIndex&	operator=( const HashIndex& other );
+		HashIndex&	operator=( HashIndex&& other );
+
+		void		add( unsigned int key, int index );	// adds an entry for an index not in the hash index yet
+		void		remove( int index );					// removes the entry of the index
+		void		moveIndex( int from, int to );			// moves the entry of index 'from', which must be present, to the unused index 'to'
+
+		inline int	first( unsigned int key ) const;		// first index with the given key, or -1
+		inline int	next( int index ) const;				// next index with the same key, or -1
+		inline unsigned int getKey( int index ) const;		// key the index was added with
+
+		void		clear();								// removes every entry, keeping the memory
+		void		free();									// removes every entry and releases the memory
+		void		resizeIndex( size_t newIndexSize );		// makes room for indices up to newIndexSize - 1
+		void		swap( HashIndex& other );
+
+		size_t		getHashSize() const { return hashSize; }
+		size_t		getIndexSize() const { return indexSize; }
+		size_t		getNumEntries() const { return numEntries; }
+
+	private:
+		void		allocate();
+		void		rehash( size_t newHashSize );
+
+	private:
+		static const size_t DEFAULT_HASH_SIZE = 64;
+
+		int*			hash;			// first index of each bucket, -1 for empty buckets
+		int*			indexChain;		// next index in the same bucket, per index
+		unsigned int*	keys;			// key of each index
+		size_t			hashSize;		// always a power of two
+		size_t			hashMask;
+		size_t			indexSize;
+		size_t			numEntries;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Hash
+	//
+	// Default hash functor producing HashIndex keys. Mixes the bits of 
+	// std::hash, which is the identity for integers in most standard 
+	// libraries, as the hash index only uses the lowest bits of the keys.
+	//////////////////////////////////////////////////////////////////////////
+	inline unsigned int mixHash( uint64_t value ) {
+		value ^= value >> 33;
+		value *= 0xff51afd7ed558ccdull;
+		value ^= value >> 33;
+		value *= 0xc4ceb9fe1a85ec53ull;
+		value ^= value >> 33;
+		return (unsigned int)value;
+	}
+
+	template< typename T >
+	struct Hash {
+		unsigned int operator()( const T& value ) const {
+			return mixHash( (uint64_t)std::hash< T >()( value ) );
+		}
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// HashIndex::first
+	//////////////////////////////////////////////////////////////////////////
+	inline int HashIndex::first( unsigned int key ) const {
+		if ( hash == NULL ) {
+			return -1;
+		}
+		return hash[ key & hashMask ];
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// HashIndex::next
+	//////////////////////////////////////////////////////////////////////////
+	inline int HashIndex::next( int index ) const {
+		assert( index >= 0 && (size_t)index < indexSize );
+		return indexChain[ index ];
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// HashIndex::getKey
+	//////////////////////////////////////////////////////////////////////////
+	inline unsigned int HashIndex::getKey( int index ) const {
+		assert( index >= 0 && (size_t)index < indexSize );
+		return keys[ index ];
+	}
+}
@@ -0,0 +1,91 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+
+namespace CoreLib {
+
+	//////////////////////////////////////////////////////////////////////////
+	// Growth policies
+	//
+	// Decide the new capacity of a List which needs to hold at least 
+	// 'required' elements and is currently holding 'capacity'. Policies 
+	// expose a single static method:
+	//
+	//	size_t grow( capacity, required, granularity, elementSize )
+	//
+	// which must return a value >= required.
+	//////////////////////////////////////////////////////////////////////////
+
+	//////////////////////////////////////////////////////////////////////////
+	// FixedGrowth
+	//
+	// Grows the list by the list granularity. Memory efficient, but filling 
+	// a list this way is quadratic in copies unless preAllocate is used.
+	//////////////////////////////////////////////////////////////////////////
+	class FixedGrowth {
+	public:
+		inline static size_t grow( size_t /*capacity*/, size_t required, size_t granularity, size_t /*elementSize*/ ) {
+			size_t newCapacity = required + granularity - 1;
+			return newCapacity - newCapacity % granularity;
+		}
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// GeometricGrowth
+	//
+	// Grows the capacity by a factor of Numerator / Denominator (1.5 by 
+	// default), giving amortized constant time appends. The result is still 
+	// rounded up to the list granularity.
+	//////////////////////////////////////////////////////////////////////////
+	template< size_t Numerator = 3, size_t Denominator = 2 >
+	class GeometricGrowth {
+	public:
+		inline static size_t grow( size_t capacity, size_t required, size_t granularity, size_t elementSize ) {
+			static_assert( Numerator > Denominator, "the growth factor must be greater than 1" );
+			size_t newCapacity = capacity / Denominator * Numerator + capacity % Denominator * Numerator / Denominator;
+			if ( newCapacity < required ) {
+				newCapacity = required;
+			}
+			return FixedGrowth::grow( capacity, newCapacity, granularity, elementSize );
+		}
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// PageGrowth
+	//
+	// Applies another growth policy and rounds the resulting allocation up to
+	// a whole number of pages, so that no partially used pages are wasted.
+	// e.g. PageGrowth< GeometricGrowth<> >
+	//////////////////////////////////////////////////////////////////////////
+	template< class BaseGrowth = FixedGrowth, size_t PageSize = 4096 >
+	class PageGrowth {
+	public:
+		inline static size_t grow( size_t capacity, size_t required, size_t granularity, size_t elementSize ) {
+			static_assert( ( PageSize & ( PageSize - 1 ) ) == 0, "the page size must be a power of two" );
+			const size_t newCapacity = BaseGrowth::grow( capacity, required, granularity, elementSize );
+			const size_t bytes = ( newCapacity * elementSize + PageSize - 1 ) & ~( PageSize - 1 );
+			return bytes / elementSize;
+		}
+	};
+}
@@ -0,0 +1,92 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include "list.h"
+#include <containers/hashIndex/hashIndex.h>
+
+namespace CoreLib {
+
+	//////////////////////////////////////////////////////////////////////////
+	// class IndexedList
+	//
+	// A List paired with a HashIndex over its elements, making findIndex, 
+	// addUnique and removeFast expected O(1) instead of a linear scan. The 
+	// hash index is kept in sync by every modifying method, which is why 
+	// elements can only be read through the list interface and are written 
+	// through set().
+	//
+	// Hasher is a functor returning an unsigned int key for an element; 
+	// equal elements must produce equal keys.
+	//////////////////////////////////////////////////////////////////////////
+	template< typename T, class Allocator = CoreLib::Memory::StandardAllocator<T>, class Growth = FixedGrowth, class Hasher = Hash<T> >
+	class IndexedList {
+	public:
+		typedef List< T, Allocator, Growth >	ListType;
+		typedef const T							ConstType;
+		typedef T								Type;
+		typedef ConstType*						ConstIterator;
+
+		explicit IndexedList( size_t granularity = DEFAULT_GRANULARITY );
+		explicit IndexedList( const Allocator& allocator, size_t granularity = DEFAULT_GRANULARITY );
+
+		size_t size() const;
+		size_t capacity() const;
+		bool empty() const;
+
+		void clear();							// clears the list, its storage and the hash index
+		void resize( size_t newNum );			// set number of elements in list, indexing the new default constructed elements
+		void preAllocate( size_t newCapacity );	// makes room for newCapacity elements in both the list and the hash index
+		void shrinkToFit();
+
+		ConstType&		operator[]( int index ) const;
+		ConstType&		operator[]( size_t index ) const;
+		void			set( size_t index, ConstType& obj );	// replaces the i-th element, updating the hash index
+		void			set( size_t index, Type&& obj );
+
+		int			append( ConstType& obj );			// append element
+		int			append( Type&& obj );				// append element, moving it into the list
+		int			addUnique( ConstType& obj );		// add unique element
+
+		int			findIndex( ConstType& obj ) const;	// find the index for the given element
+
+		bool		removeFast( ConstType& obj );		// remove the element, move the last element into its spot
+		bool		removeIndexFast( size_t i );		// remove i-th element, move the last element into its spot
+		void		swap( IndexedList& other );			// swap the contents of the lists
+
+		void		rebuildIndex();						// rebuilds the hash index from scratch
+
+		ConstIterator	begin() const;
+		ConstIterator	end() const;
+
+		const ListType&		getList() const;
+		const HashIndex&	getHashIndex() const;
+
+	private:
+		ListType	list;
+		HashIndex	hashIndex;
+		Hasher		hasher;
+		const static size_t DEFAULT_GRANULARITY = 16;
+	};
+
+	#include "indexedList.inl"
+}
@@ -0,0 +1,279 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::IndexedList( size_t )
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::IndexedList( size_t granularity )
+	:	list( granularity ) {
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::IndexedList( const AllocPolicy&, size_t )
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::IndexedList( const AllocPolicy& allocator, size_t granularity )
+	:	list( allocator, granularity ) {
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::size
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline size_t IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::size() const {
+	return list.size();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::capacity
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline size_t IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::capacity() const {
+	return list.capacity();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::empty
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline bool IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::empty() const {
+	return list.empty();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::clear
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline void IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::clear() {
+	list.clear();
+	hashIndex.free();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::resize
+//
+// Elements beyond the new size are removed from the hash index, and the 
+// new default constructed elements are added to it.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline void IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::resize( size_t newNum ) {
+	const size_t oldNum = list.size();
+	for( size_t i = newNum; i < oldNum; i++ ) {
+		hashIndex.remove( (int)i );
+	}
+	list.resize( newNum );
+	hashIndex.resizeIndex( newNum );
+	for( size_t i = oldNum; i < newNum; i++ ) {
+		hashIndex.add( hasher( list[ i ] ), (int)i );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::preAllocate
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline void IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::preAllocate( size_t newCapacity ) {
+	list.preAllocate( newCapacity );
+	hashIndex.resizeIndex( newCapacity );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::shrinkToFit
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline void IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::shrinkToFit() {
+	list.shrinkToFit();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::operator[]
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline const type& IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::operator[]( int index ) const {
+	return list[ index ];
+}
+
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline const type& IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::operator[]( size_t index ) const {
+	return list[ index ];
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::set
+//
+// Replaces the i-th element, moving its entry to the bucket of the new 
+// value.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline void IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::set( size_t index, type const & obj ) {
+	assert( index < list.size() );
+	hashIndex.remove( (int)index );
+	list[ index ] = obj;
+	hashIndex.add( hasher( list[ index ] ), (int)index );
+}
+
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline void IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::set( size_t index, type&& obj ) {
+	assert( index < list.size() );
+	hashIndex.remove( (int)index );
+	list[ index ] = std::move( obj );
+	hashIndex.add( hasher( list[ index ] ), (int)index );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::append
+//
+// Returns the index of the new element.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline int IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::append( type const & obj ) {
+	int index = list.append( obj );
+	hashIndex.add( hasher( list[ index ] ), index );
+	return index;
+}
+
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline int IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::append( type&& obj ) {
+	int index = list.append( std::move( obj ) );
+	hashIndex.add( hasher( list[ index ] ), index );
+	return index;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::addUnique
+// 
+// Adds the data to the list if it doesn't already exist.  Returns the 
+// index of the data in the list.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline int IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::addUnique( type const & obj ) {
+	int index = findIndex( obj );
+	if ( index < 0 ) {
+		index = append( obj );
+	}
+	return index;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::findIndex
+//
+// Searches for the specified data among the elements sharing its key, and 
+// returns the index of the first match, or -1 if it wasn't found.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline int IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::findIndex( type const & obj ) const {
+	int found = -1;
+	for( int i = hashIndex.first( hasher( obj ) ); i != -1; i = hashIndex.next( i ) ) {
+		// entries are chained newest first, keep the lowest index like List does
+		if ( list[ i ] == obj && ( found < 0 || i < found ) ) {
+			found = i;
+		}
+	}
+	return found;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::removeFast
+//
+// Removes the element if found, moving the last element into its spot.
+// Returns true if the element was found.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline bool IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::removeFast( type const & obj ) {
+	int index = findIndex( obj );
+	if ( index >= 0 ) {
+		return removeIndexFast( index );
+	}
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::removeIndexFast
+//
+// Removes the element at the specified index, moving the last element 
+// into its spot along with its hash index entry.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline bool IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::removeIndexFast( size_t index ) {
+	if ( index >= list.size() ) {
+		return false;
+	}
+	const size_t last = list.size() - 1;
+	hashIndex.remove( (int)index );
+	hashIndex.moveIndex( (int)last, (int)index );
+	return list.removeIndexFast( index );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::swap
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline void IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::swap( IndexedList &other ) {
+	list.swap( other.list );
+	hashIndex.swap( other.hashIndex );
+	std::swap( hasher, other.hasher );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::rebuildIndex
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline void IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::rebuildIndex() {
+	hashIndex.clear();
+	hashIndex.resizeIndex( list.size() );
+	for( size_t i = 0; i < list.size(); i++ ) {
+		hashIndex.add( hasher( list[ i ] ), (int)i );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::begin
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline typename IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::ConstIterator IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::begin() const {
+	return list.begin();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::end
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline typename IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::ConstIterator IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::end() const {
+	return list.end();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::getList
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline const typename IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::ListType& IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::getList() const {
+	return list;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::getHashIndex
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy, class HashPolicy >
+inline const HashIndex& IndexedList< type, AllocPolicy, GrowthPolicy, HashPolicy >::getHashIndex() const {
+	return hashIndex;
+}
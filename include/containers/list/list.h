@@ -28,22 +28,33 @@
 
 #pragma once
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <algorithm>
 #include <memory/standardAllocator.h>
+#include <memory/allocatorTraits.h>
+#include <memory/construct.h>
+#include <algorithms/kernels.h>
+#include <algorithms/sort.h>
+#include "growthPolicy.h"
+#include <stats/counters.h>
 
 namespace CoreLib {
 	template< typename T >
-	inline int ListSortCompare( const T *a, const T *b ) { return *a - *b; }
+	inline int ListSortCompare( const T *a, const T *b ) { return ( *b < *a ) - ( *a < *b ); }
 
 	//////////////////////////////////////////////////////////////////////////
 	// class List
 	//
 	// Similar to std::vector, but allowing for more efficient element removal
-	// copy and granularity control.
+	// copy and granularity control. The way the storage grows is controlled 
+	// by the Growth policy (see growthPolicy.h).
+	//
+	// The list holds a copy of its allocator, so stateful allocators such as
+	// PoolAllocator let different lists draw from different pools.
 	//////////////////////////////////////////////////////////////////////////
-	template< typename T, class Allocator = CoreLib::Memory::StandardAllocator<T> >
-	class List {
+	template< typename T, class Allocator = CoreLib::Memory::StandardAllocator<T>, class Growth = FixedGrowth >
+	class List : private Allocator {
 	public:
 		typedef const T			ConstType;
 		typedef T				Type;
@@ -52,7 +63,9 @@ namespace CoreLib {
 		typedef int				cmp_t( const T *, const T * );
 
 		explicit List( size_t granularity = DEFAULT_GRANULARITY );
+		explicit List( const Allocator& allocator, size_t granularity = DEFAULT_GRANULARITY );
 		List( const List& other);
+		List( List&& other );
 		~List();
 
 		size_t size() const;		// number of elements in the list
@@ -62,11 +75,16 @@ namespace CoreLib {
 		void clear();	// clears the list and storage
 		void resize( size_t newNum, bool resizeCapacity = true );	// set number of elements in list and resize to exactly this number if necessary
 		void preAllocate( size_t newCapacity ); // makes sure the list has capacity for newSize number of elements, without changing the current element count
+		void shrinkToFit();	// releases the unused capacity
+		void adoptStorage( Type* storage, size_t count );	// takes over storage holding count constructed elements, to be released through the allocator
 
 		void setGranularity( size_t granularity );
 		size_t getGranularity() const;
 
+		const Allocator& getAllocator() const;
+
 		List&			operator=( const List& other );
+		List&			operator=( List&& other );
 		Type&			operator[]( int index );
 		ConstType&		operator[]( int index ) const;	
 		Type&			operator[]( size_t index );
@@ -76,15 +94,34 @@ namespace CoreLib {
 
 		Type&		append();							// returns reference to a new data element at the end of the list
 		int			append( ConstType& obj );			// append element
+		int			append( Type&& obj );				// append element, moving it into the list
 		int			append( const List &other );		// append list
+		int			appendRange( ConstType* first, size_t count );				// append count elements copied from first, returns the index of the first one
+		void		insertRange( size_t index, ConstType* first, size_t count );	// insert count elements copied from first at the given index
+		template< typename... Args >
+		int			emplace( Args&&... args );			// append an element constructed in place from args
+		void		resizeUninitialized( size_t newNum );	// set number of elements in list, leaving new elements uninitialized (trivial types only)
 
 		int			addUnique( ConstType& obj );		// add unique element
 
 		int			findIndex( ConstType& obj ) const;				// find the index for the given element
+		size_t		count( ConstType& obj ) const;					// number of elements equal to the given one
+		bool		contains( ConstType& obj ) const;
+
+		Type		min() const;									// smallest element, the list must not be empty
+		Type		max() const;									// largest element, the list must not be empty
+		typename Algorithms::SumType< T >::type sum() const;		// sum of the elements (64 bit for int types)
 
 		bool		removeFast( ConstType& obj );		// remove the element, move the last element into its spot
 		bool		removeIndexFast( size_t i );		// remove i-th element, move the last element into its spot
+		template< class Predicate >
+		size_t		removeIf( Predicate pred );			// remove the elements matching pred( element ), keeping the order of the rest
+		size_t		removeAllFast( ConstType& obj );	// remove every element equal to obj, moving elements from the end into their spots
 		void		sort( cmp_t *compare = ListSortCompare<T> );	// sort the list
+		template< class Less >
+		void		sort( Less less );					// sort the list according to less( a, b ), which is inlined
+		template< class KeyOf >
+		void		sortByKey( KeyOf key );				// sort the list by the key returned by key( element ), radix sorting integral and floating point keys
 		void		swap( List &other );				// swap the contents of the lists
 
 		Iterator		begin();						// return list[ 0 ]
@@ -95,6 +132,14 @@ namespace CoreLib {
 
 	private:
 		void setSize(size_t numElem);
+		void grow(size_t required);
+		void takeStorage( List& other );
+
+#if CORELIB_ENABLE_STATS
+		// counters shared by every list of the same type
+		enum { STAT_REALLOCATIONS, STAT_BYTES_MOVED, STAT_FIND_CALLS, STAT_FIND_SCANNED, NUM_STATS };
+		static Stats::CounterGroup< NUM_STATS >& stats();
+#endif
 
 	private:
 		size_t			numElements;
@@ -104,5 +149,15 @@ namespace CoreLib {
 		const static size_t DEFAULT_GRANULARITY = 16;
 	};
 
+	namespace Memory {
+		// the list only holds a pointer to its storage, so it can be moved 
+		// around with memcpy when stored within another container, as long 
+		// as its allocator can
+		template< typename T, class Allocator, class Growth >
+		struct IsRelocatable< List< T, Allocator, Growth > > {
+			static const bool value = IsRelocatable< Allocator >::value;
+		};
+	}
+
 	#include "list.inl"
 }
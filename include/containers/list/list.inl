@@ -21,11 +21,12 @@
 */
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::List( int )
+// List< type, AllocPolicy, GrowthPolicy >::List( int )
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline List< type, AllocPolicy >::List( size_t newgranularity )
-	:	allocedSize( 0 ),
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline List< type, AllocPolicy, GrowthPolicy >::List( size_t newgranularity )
+	:	numElements( 0 ),
+		allocedSize( 0 ),
 		granularity( newgranularity ),
 		list( NULL ) {
 	assert( granularity > 0 );
@@ -33,69 +34,123 @@ inline List< type, AllocPolicy >::List( size_t newgranularity )
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::List( const List &other )
+// List< type, AllocPolicy, GrowthPolicy >::List( const AllocPolicy &, int )
+//
+// Creates an empty list drawing its storage from the given allocator.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline List< type, AllocPolicy >::List( const List &other ) 
-	:	allocedSize( 0 ),
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline List< type, AllocPolicy, GrowthPolicy >::List( const AllocPolicy& allocator, size_t newgranularity )
+	:	AllocPolicy( allocator ),
+		numElements( 0 ),
+		allocedSize( 0 ),
+		granularity( newgranularity ),
+		list( NULL ) {
+	assert( granularity > 0 );
+	clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::List( const List &other )
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline List< type, AllocPolicy, GrowthPolicy >::List( const List &other ) 
+	:	AllocPolicy( other ),
+		numElements( 0 ),
+		allocedSize( 0 ),
 		list( NULL ) {
 	*this = other;
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::~List
+// List< type, AllocPolicy, GrowthPolicy >::List( List &&other )
+//
+// Takes over the storage of the other list, which is left empty.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline List< type, AllocPolicy, GrowthPolicy >::List( List &&other ) 
+	:	AllocPolicy( other ),
+		numElements( 0 ),
+		allocedSize( 0 ),
+		granularity( other.granularity ),
+		list( NULL ) {
+	takeStorage( other );
+}
+
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline List< type, AllocPolicy >::~List( void ) {
+// List< type, AllocPolicy, GrowthPolicy >::~List
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline List< type, AllocPolicy, GrowthPolicy >::~List( void ) {
 	clear();
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::clear
+// List< type, AllocPolicy, GrowthPolicy >::clear
 //
 // Frees up the memory allocated by the list.  Assumes that type 
 // automatically handles freeing up memory.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline void List< type, AllocPolicy >::clear() {
-	AllocPolicy::free( list, allocedSize );
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline void List< type, AllocPolicy, GrowthPolicy >::clear() {
+	if ( list != NULL ) {
+		Memory::destroy( list, numElements );
+		AllocPolicy::freeRaw( list, allocedSize );
+	}
 	list		= NULL;
 	numElements	= 0;
 	allocedSize	= 0;	
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::size
+// List< type, AllocPolicy, GrowthPolicy >::size
 //
 // Returns the number of elements currently contained in the list.
 // Note that this is NOT an indication of the memory allocated.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline size_t List< type, AllocPolicy >::size( void ) const {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline size_t List< type, AllocPolicy, GrowthPolicy >::size( void ) const {
 	return numElements;
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::resize
+// List< type, AllocPolicy, GrowthPolicy >::capacity
 //
-// Resize to the exact allocedSize specified irregardless of granularity
+// Returns the number of elements the list can hold before reallocating.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline size_t List< type, AllocPolicy, GrowthPolicy >::capacity( void ) const {
+	return allocedSize;
+}
+
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline void List< type, AllocPolicy >::resize( size_t newnum, bool resize ) {
-	assert( newnum >= 0 );
+// List< type, AllocPolicy, GrowthPolicy >::resize
+//
+// Resize to the exact allocedSize specified irregardless of granularity.
+// New elements are default constructed, and elements beyond the new size
+// are destroyed.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline void List< type, AllocPolicy, GrowthPolicy >::resize( size_t newnum, bool resize ) {
+	if ( newnum < numElements ) {
+		Memory::destroy( list + newnum, numElements - newnum );
+		numElements = newnum;
+	}
 	if ( resize || newnum > allocedSize ) {
 		setSize( newnum );
 	}
+	if ( newnum > numElements ) {
+		Memory::defaultConstruct( list + numElements, newnum - numElements );
+	}
 	numElements = newnum;
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::setGranularity
+// List< type, AllocPolicy, GrowthPolicy >::setGranularity
 //
 // Sets the base allocedSize of the array and resizes the array to match.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline void List< type, AllocPolicy >::setGranularity( size_t newgranularity ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline void List< type, AllocPolicy, GrowthPolicy >::setGranularity( size_t newgranularity ) {
 	size_t newsize;
 
 	assert( newgranularity > 0 );
@@ -112,56 +167,135 @@ inline void List< type, AllocPolicy >::setGranularity( size_t newgranularity ) {
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::getGranularity
+// List< type, AllocPolicy, GrowthPolicy >::getGranularity
 // 
 // Get the current granularity.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline size_t List< type, AllocPolicy >::getGranularity( void ) const {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline size_t List< type, AllocPolicy, GrowthPolicy >::getGranularity( void ) const {
 	return granularity;
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::setSize
+// List< type, AllocPolicy, GrowthPolicy >::getAllocator
 // 
-// Allocates memory for the amount of elements requested while keeping the 
-// contents intact. Contents are copied using their = operator so that data 
-// is correctly instantiated.
+// Get the allocator the list draws its storage from.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline void List< type, AllocPolicy >::setSize( size_t newsize ) {
-	assert( newsize >= 0 );
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline const AllocPolicy& List< type, AllocPolicy, GrowthPolicy >::getAllocator( void ) const {
+	return *this;
+}
 
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::setSize
+// 
+// Allocates memory for the amount of elements requested while keeping the 
+// contents intact. The new storage is left uninitialized beyond the 
+// existing elements, which are moved into it (or memcpy'd, for relocatable
+// types) rather than copied.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline void List< type, AllocPolicy, GrowthPolicy >::setSize( size_t newsize ) {
 	// free up the list if no data is being reserved
 	if ( newsize <= 0 ) {
 		clear();
 		return;
 	}
 
+	// storage held within the allocator (see InlineAllocator) has a fixed 
+	// size, so there is no point in asking for less
+	const size_t inlineCapacity = Memory::AllocatorTraits< AllocPolicy, type >::inlineCapacity( *this );
+	if ( newsize < inlineCapacity ) {
+		newsize = inlineCapacity;
+	}
+
 	if ( newsize == allocedSize ) {
 		// not changing the allocedSize, so just exit
 		return;
 	}
 
 	type* temp	= list;
-	int oldAllocedSize = allocedSize;
+	size_t oldAllocedSize = allocedSize;
 	allocedSize		= newsize;
 	if ( allocedSize < numElements ) {
+		// destroy the elements which won't fit in the new storage
+		Memory::destroy( temp + allocedSize, numElements - allocedSize );
 		numElements = allocedSize;
 	}
 
-	list = AllocPolicy::alloc( allocedSize );
+	CORELIB_STAT( stats().add( STAT_REALLOCATIONS, 1 ) );
+
+	if ( temp != NULL && Memory::IsRelocatable< type >::value ) {
+		// relocatable elements can be moved bitwise by the allocator, which 
+		// may be able to resize the storage without copying anything at all
+		type* resized = Memory::AllocatorTraits< AllocPolicy, type >::reallocRaw( *this, temp, oldAllocedSize, allocedSize );
+		if ( resized != NULL ) {
+			list = resized;
+			return;
+		}
+	}
+
+	list = AllocPolicy::allocRaw( allocedSize );
 
 	if ( temp != NULL ) {
-		// copy the old list into our new one
-		// can't use memcopy, we're potentially copying classes
-		for( size_t i = 0; i < numElements; i++ ) {
-			list[ i ] = temp[ i ];
+		// move the old elements into the new storage, leaving the old 
+		// storage uninitialized
+		Memory::relocate( list, temp, numElements );
+		CORELIB_STAT( stats().add( STAT_BYTES_MOVED, numElements * sizeof( type ) ) );
+
+		// release the old storage
+		AllocPolicy::freeRaw( temp, oldAllocedSize );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::grow
+// 
+// Grows the storage to hold at least the required number of elements, as
+// dictated by the growth policy. Elements fitting in the allocator's 
+// inline storage, if any, are kept there regardless of the policy.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline void List< type, AllocPolicy, GrowthPolicy >::grow( size_t required ) {
+	if ( required > allocedSize ) {
+		const size_t inlineCapacity = Memory::AllocatorTraits< AllocPolicy, type >::inlineCapacity( *this );
+		if ( required <= inlineCapacity ) {
+			setSize( inlineCapacity );
+		} else {
+			setSize( GrowthPolicy::grow( allocedSize, required, granularity, sizeof( type ) ) );
 		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::takeStorage
+// 
+// Takes over the elements of the other list, which is left empty. This 
+// list must hold no storage, and is expected to use the same allocator as 
+// the other list. Storage living within the other list's allocator can't 
+// be handed over, so in that case the elements are moved instead.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline void List< type, AllocPolicy, GrowthPolicy >::takeStorage( List &other ) {
+	assert( list == NULL );
+	granularity = other.granularity;
+	if ( other.list == NULL ) {
+		return;
+	}
 
-		// delete the old list if it exists	
-		AllocPolicy::free( temp, oldAllocedSize );
+	if ( Memory::AllocatorTraits< AllocPolicy, type >::isInline( other, other.list ) ) {
+		list = AllocPolicy::allocRaw( other.allocedSize );
+		Memory::relocate( list, other.list, other.numElements );
+		static_cast< AllocPolicy& >( other ).freeRaw( other.list, other.allocedSize );
+	} else {
+		list = other.list;
 	}
+	numElements = other.numElements;
+	allocedSize = other.allocedSize;
+
+	other.numElements = 0;
+	other.allocedSize = 0;
+	other.list = NULL;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -170,8 +304,8 @@ inline void List< type, AllocPolicy >::setSize( size_t newsize ) {
 // Makes sure the list has at least the given number of elements
 // allocated but don't actually change the number of items.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline void List< type, AllocPolicy >::preAllocate( size_t newSize ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline void List< type, AllocPolicy, GrowthPolicy >::preAllocate( size_t newSize ) {
 	if ( newSize > allocedSize ) {
 		newSize += granularity - 1;
 		newSize -= newSize % granularity;
@@ -180,43 +314,88 @@ inline void List< type, AllocPolicy >::preAllocate( size_t newSize ) {
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::operator=
+// List< type, AllocPolicy, GrowthPolicy >::shrinkToFit
 //
-// Copies the contents and allocedSize attributes of another list.
+// Reallocates the storage to exactly fit the current elements, releasing
+// the storage altogether if the list is empty.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline List< type, AllocPolicy > &List< type, AllocPolicy >::operator=( const List &other ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline void List< type, AllocPolicy, GrowthPolicy >::shrinkToFit() {
+	setSize( numElements );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::adoptStorage
+//
+// Clears the list and takes over the given storage, which holds count 
+// constructed elements and no spare capacity. The allocator must be able 
+// to release it with freeRaw, e.g. storage within a file mapping known to
+// the allocator (see MappedList).
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline void List< type, AllocPolicy, GrowthPolicy >::adoptStorage( type* storage, size_t count ) {
+	assert( storage != NULL || count == 0 );
+	clear();
+	list		= storage;
+	numElements	= count;
+	allocedSize	= count;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::operator=
+//
+// Copies the contents and allocedSize attributes of another list. The 
+// list keeps its own allocator.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline List< type, AllocPolicy, GrowthPolicy > &List< type, AllocPolicy, GrowthPolicy >::operator=( const List &other ) {
 	if( &other == this ) {
 		return *this;
 	}
 
 	clear();
 
-	numElements	= other.numElements;
-	allocedSize	= other.allocedSize;
 	granularity	= other.granularity;
 
-	if ( allocedSize ) {
-		list = AllocPolicy::alloc( allocedSize );
+	if ( other.allocedSize ) {
+		list = AllocPolicy::allocRaw( other.allocedSize );
+		allocedSize = other.allocedSize;
 
-		// copy the old list into our new one
-		// can't use memcopy, we're potentially copying classes
-		for( size_t i = 0; i < numElements; i++ ) {
-			list[ i ] = other.list[ i ];
-		}
+		// copy construct the elements into the uninitialized storage,
+		// trivially copyable types are copied with a single memcpy
+		Memory::copyConstruct( list, other.list, other.numElements );
+		numElements = other.numElements;
 	}
 
 	return *this;
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::operator[] const
+// List< type, AllocPolicy, GrowthPolicy >::operator=
+//
+// Takes over the storage, and allocator, of the other list, which is left 
+// empty.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline List< type, AllocPolicy, GrowthPolicy > &List< type, AllocPolicy, GrowthPolicy >::operator=( List &&other ) {
+	if( &other == this ) {
+		return *this;
+	}
+
+	clear();
+	swap( other );
+
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::operator[] const
 //
 // Access operator.  Index must be within range or an assert will be issued 
 // in debug builds. Release builds do no range checking.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline const type &List< type, AllocPolicy >::operator[]( int index ) const {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline const type &List< type, AllocPolicy, GrowthPolicy >::operator[]( int index ) const {
 	assert( index >= 0 );
 	assert( index < (int)numElements );
 
@@ -224,13 +403,13 @@ inline const type &List< type, AllocPolicy >::operator[]( int index ) const {
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::operator[]
+// List< type, AllocPolicy, GrowthPolicy >::operator[]
 //	
 // Access operator.	Index must be within range or an assert will be issued 
 // in debug builds. Release builds do no range checking.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline type &List< type, AllocPolicy >::operator[]( int index ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline type &List< type, AllocPolicy, GrowthPolicy >::operator[]( int index ) {
 	assert( index >= 0 );
 	assert( index < (int)numElements );
 
@@ -238,136 +417,242 @@ inline type &List< type, AllocPolicy >::operator[]( int index ) {
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::operator[] const
+// List< type, AllocPolicy, GrowthPolicy >::operator[] const
 //
 // Access operator.  Index must be within range or an assert will be issued 
 // in debug builds. Release builds do no range checking.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline const type &List< type, AllocPolicy >::operator[]( unsigned int index ) const {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline const type &List< type, AllocPolicy, GrowthPolicy >::operator[]( unsigned int index ) const {
 	assert( index < (unsigned int)numElements );
 	return list[ index ];
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::operator[]
+// List< type, AllocPolicy, GrowthPolicy >::operator[]
 //	
 // Access operator.	Index must be within range or an assert will be issued 
 // in debug builds. Release builds do no range checking.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline type &List< type, AllocPolicy >::operator[]( unsigned int index ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline type &List< type, AllocPolicy, GrowthPolicy >::operator[]( unsigned int index ) {
 	assert( index < (unsigned int)numElements );
 	return list[ index ];
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::operator[] const
+// List< type, AllocPolicy, GrowthPolicy >::operator[] const
 //
 // Access operator.  Index must be within range or an assert will be issued 
 // in debug builds. Release builds do no range checking.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline const type &List< type, AllocPolicy >::operator[]( size_t index ) const {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline const type &List< type, AllocPolicy, GrowthPolicy >::operator[]( size_t index ) const {
 	assert( index < numElements );
 	return list[ index ];
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::operator[]
+// List< type, AllocPolicy, GrowthPolicy >::operator[]
 //	
 // Access operator.	Index must be within range or an assert will be issued 
 // in debug builds. Release builds do no range checking.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline type &List< type, AllocPolicy >::operator[]( size_t index ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline type &List< type, AllocPolicy, GrowthPolicy >::operator[]( size_t index ) {
 	assert( index < numElements );
 	return list[ index ];
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::append
+// List< type, AllocPolicy, GrowthPolicy >::append
 //
 // Returns a reference to a new data element at the end of the list.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline type &List< type, AllocPolicy >::append( void ) {
-	if ( !list ) {
-		setSize( granularity );
-	}
-
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline type &List< type, AllocPolicy, GrowthPolicy >::append( void ) {
 	if ( numElements == allocedSize ) {
-		setSize( allocedSize + granularity );
+		grow( numElements + 1 );
 	}
 
+	new( list + numElements ) type;
 	return list[ numElements++ ];
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::append
+// List< type, AllocPolicy, GrowthPolicy >::append
 //
 // Increases the allocedSize of the list by one element and copies the 
 // supplied data into it.
 //
 // Returns the index of the new element.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline int List< type, AllocPolicy >::append( type const & obj ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline int List< type, AllocPolicy, GrowthPolicy >::append( type const & obj ) {
 
 	// appending one of the list items does not work because the list may be reallocated
 	assert( &obj < list || &obj >= list + numElements );
 
-	if ( !list ) {
-		setSize( granularity );
+	if ( numElements == allocedSize ) {
+		grow( numElements + 1 );
 	}
 
+	new( list + numElements ) type( obj );
+	numElements++;
+
+	return numElements - 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::append
+//
+// Increases the allocedSize of the list by one element and moves the 
+// supplied data into it.
+//
+// Returns the index of the new element.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline int List< type, AllocPolicy, GrowthPolicy >::append( type&& obj ) {
+
+	// appending one of the list items does not work because the list may be reallocated
+	assert( &obj < list || &obj >= list + numElements );
+
 	if ( numElements == allocedSize ) {
-		size_t newsize = allocedSize + granularity;
-		setSize( newsize - newsize % granularity );
+		grow( numElements + 1 );
 	}
 
-	list[ numElements ] = obj;
+	new( list + numElements ) type( std::move( obj ) );
 	numElements++;
 
 	return numElements - 1;
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::Append
+// List< type, AllocPolicy, GrowthPolicy >::append
 //
 // adds the other list to this one
-// correctly handles this->append( *this );
 // 
-// Returns the allocedSize of the new combined list
+// Returns the size of the new combined list
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline int List< type, AllocPolicy >::append( const List &other ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline int List< type, AllocPolicy, GrowthPolicy >::append( const List &other ) {
 
 	// appending the list itself does not work because the list may be reallocated
 	assert( &other != this );
 
-	size_t n = other.size();
-	if ( !list ) {
-		resize( granularity + n );
+	appendRange( other.list, other.numElements );
+
+	return (int)size();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::appendRange
+//
+// Copies count elements starting at first to the end of the list, growing
+// the storage at most once. Trivially copyable types are copied with a 
+// single memcpy.
+//
+// Returns the index of the first appended element.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline int List< type, AllocPolicy, GrowthPolicy >::appendRange( const type* first, size_t count ) {
+
+	// appending list items does not work because the list may be reallocated
+	assert( count == 0 || first + count <= list || first >= list + numElements );
+
+	const size_t index = numElements;
+	grow( numElements + count );
+
+	Memory::copyConstruct( list + numElements, first, count );
+	numElements += count;
+
+	return (int)index;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::insertRange
+//
+// Inserts count elements copied from first at the given index, shifting 
+// the following elements up in a single pass, or a single memmove for 
+// relocatable types. The index may be the list size, which appends them.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline void List< type, AllocPolicy, GrowthPolicy >::insertRange( size_t index, const type* first, size_t count ) {
+	assert( index <= numElements );
+
+	// inserting list items does not work because the list may be reallocated
+	assert( count == 0 || first + count <= list || first >= list + numElements );
+
+	if ( count == 0 ) {
+		return;
+	}
+
+	grow( numElements + count );
+
+	// move the tail up, leaving the gap uninitialized
+	type* gap = list + index;
+	const size_t tail = numElements - index;
+	if ( Memory::IsRelocatable< type >::value ) {
+		if ( tail > 0 ) {
+			memmove( (void*)( gap + count ), (const void*)gap, tail * sizeof( type ) );
+		}
 	} else {
-		resize( numElements + n );
-	}	
-	
-	for ( size_t i = 0; i < n; i++ ) {
-		append( other[i] );
+		for( size_t i = tail; i > 0; i-- ) {
+			new( gap + count + i - 1 ) type( std::move( gap[ i - 1 ] ) );
+			gap[ i - 1 ].~type();
+		}
+	}
+
+	Memory::copyConstruct( gap, first, count );
+	numElements += count;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::emplace
+//
+// Constructs a new element at the end of the list, forwarding the given 
+// arguments to its constructor. The arguments must not refer to elements 
+// of the list, since it may be reallocated.
+//
+// Returns the index of the new element.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+template< typename... Args >
+inline int List< type, AllocPolicy, GrowthPolicy >::emplace( Args&&... args ) {
+	if ( numElements == allocedSize ) {
+		grow( numElements + 1 );
 	}
 
-	return size();
+	new( list + numElements ) type( std::forward< Args >( args )... );
+	numElements++;
+
+	return (int)( numElements - 1 );
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::addUnique
+// List< type, AllocPolicy, GrowthPolicy >::resizeUninitialized
+//
+// Sets the number of elements without initializing the new ones, so that 
+// they can be filled in afterwards (e.g. by a loader reading straight into
+// the list). Unlike resize, the capacity is only ever grown, following the 
+// growth policy. Only available for trivial types.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline void List< type, AllocPolicy, GrowthPolicy >::resizeUninitialized( size_t newnum ) {
+	static_assert( std::is_trivial< type >::value, "resizeUninitialized requires a trivial type" );
+
+	grow( newnum );
+	numElements = newnum;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::addUnique
 // 
 // Adds the data to the list if it doesn't already exist.  Returns the 
 // index of the data in the list.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline int List< type, AllocPolicy >::addUnique( type const & obj ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline int List< type, AllocPolicy, GrowthPolicy >::addUnique( type const & obj ) {
 
 	// inserting one of the list items does not work because the list may be reallocated
 	assert( &obj < list || &obj >= list + numElements );
@@ -381,36 +666,76 @@ inline int List< type, AllocPolicy >::addUnique( type const & obj ) {
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::FindIndex
+// List< type, AllocPolicy, GrowthPolicy >::FindIndex
 //
 // Searches for the specified data in the list and returns it's index.  
-// Returns -1 if the data is not found.
+// Returns -1 if the data is not found. Lists of int, unsigned int, float
+// and double are searched with SIMD instructions (see kernels.h).
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline int List< type, AllocPolicy, GrowthPolicy >::findIndex( ConstType& obj ) const {
+	int index = Algorithms::findIndex( list, numElements, obj );
+	CORELIB_STAT( stats().add( STAT_FIND_CALLS, 1 ) );
+	CORELIB_STAT( stats().add( STAT_FIND_SCANNED, index >= 0 ? (size_t)index + 1 : numElements ) );
+	return index;
+}
+
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-//template< typename T >
-inline int List< type, AllocPolicy >::findIndex( ConstType& obj ) const {
-	for( size_t i = 0; i < numElements; i++ ) {
-		if ( list[ i ] == obj ) {
-			return (int)i;
-		}
-	}
+// List< type, AllocPolicy, GrowthPolicy >::count
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline size_t List< type, AllocPolicy, GrowthPolicy >::count( ConstType& obj ) const {
+	return Algorithms::count( list, numElements, obj );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::contains
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline bool List< type, AllocPolicy, GrowthPolicy >::contains( ConstType& obj ) const {
+	return Algorithms::contains( list, numElements, obj );
+}
 
-	// Not found
-	return -1;
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::min
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline type List< type, AllocPolicy, GrowthPolicy >::min() const {
+	assert( numElements > 0 );
+	return Algorithms::min( list, numElements );
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::removeIndexFast
+// List< type, AllocPolicy, GrowthPolicy >::max
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline type List< type, AllocPolicy, GrowthPolicy >::max() const {
+	assert( numElements > 0 );
+	return Algorithms::max( list, numElements );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::sum
+//
+// The elements are added up in 8 interleaved partial sums (see kernels.h),
+// so floating point results don't depend on the instruction set used.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline typename Algorithms::SumType< type >::type List< type, AllocPolicy, GrowthPolicy >::sum() const {
+	return Algorithms::sum( list, numElements );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::removeIndexFast
 //
 // Removes the element at the specified index and moves the last element into
 // it's spot, rather than moving the whole array down by one.  Of course, this 
 // doesn't maintain the order of elements!
 // The number of elements in the list is reduced by one.  Returns false if the 
-// index is outside the bounds of the list. Note that the element is not destroyed, 
-// so any memory used by it may not be freed until the destruction of the list.
+// index is outside the bounds of the list. The vacated last slot is destroyed.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline bool List< type, AllocPolicy >::removeIndexFast( size_t index ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline bool List< type, AllocPolicy, GrowthPolicy >::removeIndexFast( size_t index ) {
 	assert( list != NULL );
 	assert( index >= 0 );
 	assert( index < numElements );
@@ -421,27 +746,24 @@ inline bool List< type, AllocPolicy >::removeIndexFast( size_t index ) {
 
 	numElements--;	
 
-	// nothing to do
-	if( index == numElements )  {
-		return true;
+	if( index != numElements )  {
+		list[ index ] = std::move( list[ numElements ] );
 	}
 
-	list[ index ] = list[ numElements ];	
+	Memory::destroy( list + numElements, 1 );
 
 	return true;
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::removeFast
+// List< type, AllocPolicy, GrowthPolicy >::removeFast
 //
 // Removes the element if it is found within the list and moves the last 
 // element into the gap. The number of elements in the list is reduced by 
-// one.  Returns false if the data is not found in the list.  Note that
-// the element is not destroyed, so any memory used by it may not be freed 
-// until the destruction of the list.
+// one.  Returns false if the data is not found in the list.
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline bool List< type, AllocPolicy >::removeFast( ConstType& obj ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline bool List< type, AllocPolicy, GrowthPolicy >::removeFast( ConstType& obj ) {
 	int index;
 
 	index = findIndex( obj );
@@ -453,31 +775,133 @@ inline bool List< type, AllocPolicy >::removeFast( ConstType& obj ) {
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::sort
+// List< type, AllocPolicy, GrowthPolicy >::sort
 //
-// Performs a qsort on the list using the supplied comparison function.  
+// Sorts the list using the supplied qsort style comparison function.  
 // Note that the data is merely moved around the list, so any pointers to 
 // data within the list may no longer be valid.
-// FIXME: These don't obey the element destruction policy
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline void List< type, AllocPolicy >::sort( cmp_t *compare ) {
-	if ( !list ) {
-		return;
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline void List< type, AllocPolicy, GrowthPolicy >::sort( cmp_t *compare ) {
+	Algorithms::sort( list, list + numElements, [ compare ]( const type& a, const type& b ) { return compare( &a, &b ) < 0; } );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::sort( Less )
+//
+// Sorts the list so that less( a, b ) holds for any a preceding b. Unlike
+// the comparison function version, the functor is inlined into the sort.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+template< class Less >
+inline void List< type, AllocPolicy, GrowthPolicy >::sort( Less less ) {
+	Algorithms::sort( list, list + numElements, less );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::sortByKey
+//
+// Sorts the list in ascending order of key( element ). Integral and 
+// floating point keys of relocatable elements are radix sorted, using 
+// scratch storage from the list allocator.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+template< class KeyOf >
+inline void List< type, AllocPolicy, GrowthPolicy >::sortByKey( KeyOf key ) {
+	Algorithms::sortByKey( list, list + numElements, key, static_cast< AllocPolicy& >( *this ) );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::removeIf
+//
+// Removes every element for which pred( element ) returns true, compacting
+// the remaining elements in a single pass which keeps their order. The 
+// vacated slots at the end are destroyed.
+//
+// Returns the number of elements removed.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+template< class Predicate >
+inline size_t List< type, AllocPolicy, GrowthPolicy >::removeIf( Predicate pred ) {
+	size_t kept = 0;
+	for( size_t i = 0; i < numElements; i++ ) {
+		if ( pred( static_cast< ConstType& >( list[ i ] ) ) ) {
+			continue;
+		}
+		if ( kept != i ) {
+			list[ kept ] = std::move( list[ i ] );
+		}
+		kept++;
+	}
+
+	const size_t removed = numElements - kept;
+	Memory::destroy( list + kept, removed );
+	numElements = kept;
+
+	return removed;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::removeAllFast
+//
+// Removes every element equal to obj in a single pass, filling each hole 
+// with an element taken from the end of the list, like removeIndexFast. 
+// This doesn't maintain the order of elements, but moves at most one 
+// element per removal. The vacated slots at the end are destroyed.
+//
+// Returns the number of elements removed.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline size_t List< type, AllocPolicy, GrowthPolicy >::removeAllFast( type const & obj ) {
+
+	// removing one of the list items does not work because it may be overwritten
+	assert( &obj < list || &obj >= list + numElements );
+
+	size_t end = numElements;
+	size_t i = 0;
+	while( i < end ) {
+		if ( !( list[ i ] == obj ) ) {
+			i++;
+			continue;
+		}
+		// skip the matching elements at the end rather than moving them in
+		end--;
+		while( end > i && list[ end ] == obj ) {
+			end--;
+		}
+		if ( end > i ) {
+			list[ i ] = std::move( list[ end ] );
+			i++;
+		}
 	}
-	typedef int cmp_c(const void *, const void *);
 
-	cmp_c *vCompare = (cmp_c *)compare;
-	qsort( ( void * )list, numElements, sizeof( type ), vCompare );
+	const size_t removed = numElements - end;
+	Memory::destroy( list + end, removed );
+	numElements = end;
+
+	return removed;
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::swap
+// List< type, AllocPolicy, GrowthPolicy >::swap
 //
 // Swaps the contents of two lists
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline void List< type, AllocPolicy >::swap( List< type, AllocPolicy > &other ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline void List< type, AllocPolicy, GrowthPolicy >::swap( List< type, AllocPolicy, GrowthPolicy > &other ) {
+	typedef Memory::AllocatorTraits< AllocPolicy, type > Traits;
+	if ( Traits::isInline( *this, list ) || Traits::isInline( other, other.list ) ) {
+		// storage held within the allocators stays behind, move the 
+		// elements through a temporary list instead
+		List temp( std::move( other ) );
+		static_cast< AllocPolicy& >( other ) = static_cast< AllocPolicy& >( *this );
+		other.takeStorage( *this );
+		static_cast< AllocPolicy& >( *this ) = static_cast< AllocPolicy& >( temp );
+		takeStorage( temp );
+		return;
+	}
+
+	std::swap( static_cast< AllocPolicy& >( *this ), static_cast< AllocPolicy& >( other ) );
 	std::swap( numElements, other.numElements );
 	std::swap( allocedSize, other.allocedSize );
 	std::swap( granularity, other.granularity );
@@ -485,12 +909,12 @@ inline void List< type, AllocPolicy >::swap( List< type, AllocPolicy > &other )
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::begin
+// List< type, AllocPolicy, GrowthPolicy >::begin
 //
 // Returns the first element of the list
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline typename List< type, AllocPolicy >::Iterator List< type, AllocPolicy >::begin( void ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline typename List< type, AllocPolicy, GrowthPolicy >::Iterator List< type, AllocPolicy, GrowthPolicy >::begin( void ) {
 	if( numElements == 0 ) {
 		return end();
 	}
@@ -498,22 +922,22 @@ inline typename List< type, AllocPolicy >::Iterator List< type, AllocPolicy >::b
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::end
+// List< type, AllocPolicy, GrowthPolicy >::end
 //
 // Returns one past the end of the list
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline typename List< type, AllocPolicy >::Iterator List< type, AllocPolicy >::end( void ) {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline typename List< type, AllocPolicy, GrowthPolicy >::Iterator List< type, AllocPolicy, GrowthPolicy >::end( void ) {
 	return list + numElements;
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::begin
+// List< type, AllocPolicy, GrowthPolicy >::begin
 //
 // Returns the first element of the list
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline typename List< type, AllocPolicy >::ConstIterator List< type, AllocPolicy >::begin( void ) const {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline typename List< type, AllocPolicy, GrowthPolicy >::ConstIterator List< type, AllocPolicy, GrowthPolicy >::begin( void ) const {
 	if( numElements == 0 ) {
 		return end();
 	}
@@ -521,19 +945,34 @@ inline typename List< type, AllocPolicy >::ConstIterator List< type, AllocPolicy
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::End
+// List< type, AllocPolicy, GrowthPolicy >::End
 //
 // Returns one past the end of the list
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline typename List< type, AllocPolicy >::ConstIterator List< type, AllocPolicy >::end( void ) const {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline typename List< type, AllocPolicy, GrowthPolicy >::ConstIterator List< type, AllocPolicy, GrowthPolicy >::end( void ) const {
 	return list + numElements;
 }
 
 //////////////////////////////////////////////////////////////////////////
-// List< type, AllocPolicy >::empty
+// List< type, AllocPolicy, GrowthPolicy >::empty
 //////////////////////////////////////////////////////////////////////////
-template< typename type, class AllocPolicy >
-inline bool List< type, AllocPolicy >::empty() const {
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline bool List< type, AllocPolicy, GrowthPolicy >::empty() const {
 	return numElements == 0 || list == NULL;
 }
+
+#if CORELIB_ENABLE_STATS
+//////////////////////////////////////////////////////////////////////////
+// List< type, AllocPolicy, GrowthPolicy >::stats
+//
+// Counters shared by every list of this type: reallocations, bytes moved
+// by them, and findIndex calls along with the elements they scanned.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy, class GrowthPolicy >
+inline Stats::CounterGroup< List< type, AllocPolicy, GrowthPolicy >::NUM_STATS >& List< type, AllocPolicy, GrowthPolicy >::stats() {
+	static const char* const names[ NUM_STATS ] = { "reallocations", "bytesMoved", "findCalls", "findScanned" };
+	static Stats::CounterGroup< NUM_STATS > counters( "list." + Stats::typeName( typeid( type ) ), names );
+	return counters;
+}
+#endif
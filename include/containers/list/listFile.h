@@ -0,0 +1,120 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include "list.h"
+
+namespace CoreLib {
+
+	//////////////////////////////////////////////////////////////////////////
+	// List files
+	//
+	// Binary image of a List of trivially copyable elements, laid out so that
+	// it can be mapped and used in place (see MappedList):
+	//
+	//	ListFileHeader
+	//	padding up to dataOffset, a multiple of both the element alignment 
+	//	and the cache line size
+	//	count * elementSize bytes of elements, as they are in memory
+	//
+	// The elements are stored in the byte order and layout of the machine 
+	// writing the file. The header records enough to refuse files written 
+	// for another layout: element size and alignment, byte order and a 
+	// caller chosen userVersion, to be bumped whenever the element type 
+	// changes.
+	//////////////////////////////////////////////////////////////////////////
+
+	struct ListFileHeader {
+		char		magic[ 8 ];			// LIST_FILE_MAGIC
+		uint32_t	formatVersion;		// LIST_FILE_VERSION
+		uint32_t	byteOrder;			// LIST_FILE_BYTE_ORDER, as seen by the writing machine
+		uint64_t	elementSize;
+		uint64_t	elementAlignment;
+		uint64_t	count;
+		uint64_t	dataOffset;			// offset of the first element from the start of the file
+		uint32_t	userVersion;		// version of the element type, chosen by the caller
+		uint32_t	reserved;
+		uint64_t	dataChecksum;		// of the count * elementSize bytes of elements
+		uint64_t	headerChecksum;		// of the preceding header fields
+	};
+
+	static const char		LIST_FILE_MAGIC[ 8 ]	= { 'C', 'O', 'R', 'E', 'L', 'I', 'S', 'T' };
+	static const uint32_t	LIST_FILE_VERSION		= 1;
+	static const uint32_t	LIST_FILE_BYTE_ORDER	= 0x01020304;
+
+	// 64 bit checksum of a block of memory, to detect truncated or corrupt
+	// files (it is not a cryptographic hash)
+	uint64_t listFileChecksum( const void* data, size_t bytes );
+
+	//////////////////////////////////////////////////////////////////////////
+	// class ListFileChecksum
+	//
+	// Computes listFileChecksum over data fed in pieces of any size, e.g. 
+	// while streaming a file.
+	//////////////////////////////////////////////////////////////////////////
+	class ListFileChecksum {
+	public:
+		ListFileChecksum();
+
+		void		update( const void* data, size_t bytes );
+		uint64_t	finish() const;		// checksum of all the data so far
+
+	private:
+		uint64_t		lanes[ 4 ];
+		unsigned char	pending[ 32 ];		// start of an incomplete block
+		size_t			pendingBytes;
+		uint64_t		totalBytes;
+	};
+
+	// Header of a file holding count elements, and offset of its first one
+	ListFileHeader makeListFileHeader( size_t count, size_t elementSize, size_t elementAlignment, uint32_t userVersion, uint64_t dataChecksum );
+	size_t listFileDataOffset( size_t elementAlignment );
+
+	// Moves the complete file at temporaryPath to path, replacing any file 
+	// already there, so that readers never see a partially written one. 
+	// Returns false on failure, having removed the temporary file.
+	bool replaceFile( const char* temporaryPath, const char* path );
+
+	// Writes the elements to path, going through a temporary file (see 
+	// replaceFile). Returns false on failure.
+	bool writeListFile( const char* path, const void* elements, size_t count, size_t elementSize, size_t elementAlignment, uint32_t userVersion );
+
+	// Checks that the fileSize bytes at file hold a valid list file for the 
+	// given element type and userVersion, and returns its header, or NULL 
+	// if it doesn't. Verifying the data checksum reads every element, so it
+	// is optional.
+	const ListFileHeader* validateListFile( const void* file, size_t fileSize, size_t elementSize, size_t elementAlignment, uint32_t userVersion, bool verifyChecksum );
+
+	//////////////////////////////////////////////////////////////////////////
+	// writeListFile
+	//
+	// Writes the list to a file which MappedList< T > can open in place.
+	//////////////////////////////////////////////////////////////////////////
+	template< typename T, class Allocator, class Growth >
+	bool writeListFile( const char* path, const List< T, Allocator, Growth >& list, uint32_t userVersion = 0 ) {
+		static_assert( std::is_trivially_copyable< T >::value, "only lists of trivially copyable types can be written as an image" );
+		return writeListFile( path, list.begin(), list.size(), sizeof( T ), std::alignment_of< T >::value, userVersion );
+	}
+}
@@ -0,0 +1,218 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+#include <containers/span/span.h>
+#include "list.h"
+#include "listFile.h"
+
+namespace CoreLib {
+
+	//////////////////////////////////////////////////////////////////////////
+	// class ListStreamWriterBase
+	//
+	// Untyped core of ListStreamWriter: owns the two chunk buffers and the 
+	// background thread writing them to disk.
+	//////////////////////////////////////////////////////////////////////////
+	class ListStreamWriterBase {
+	public:
+		static const size_t DEFAULT_CHUNK_BYTES = 4 * 1024 * 1024;
+
+	protected:
+		ListStreamWriterBase();
+		~ListStreamWriterBase();
+
+		void*		openStream( const char* path, size_t elementSize, size_t elementAlignment, uint32_t userVersion, size_t chunkBytes );	// returns the first buffer to fill, or NULL on failure
+		void*		submitChunk( size_t count );	// queues the filled buffer for writing, returns the next one to fill
+		bool		closeStream( size_t count );	// writes the last count elements and completes the file
+		bool		isStreamOpen() const { return file != NULL; }
+		size_t		getChunkElements() const { return chunkElements; }
+
+	private:
+		ListStreamWriterBase( const ListStreamWriterBase& );
+		ListStreamWriterBase& operator=( const ListStreamWriterBase& );
+
+		void		writeLoop();
+		void		releaseStream();
+
+	private:
+		FILE*					file;
+		std::string				path;
+		std::string				temporaryPath;
+		size_t					elementSize;
+		size_t					elementAlignment;
+		uint32_t				userVersion;
+		size_t					chunkElements;
+		void*					buffers[ 2 ];
+		size_t					fillBuffer;		// buffer being filled by the caller, the other one may be being written
+		uint64_t				count;			// elements submitted so far
+
+		// shared with the writing thread
+		std::thread				thread;
+		std::mutex				mutex;
+		std::condition_variable	condition;
+		const void*				queued;			// buffer waiting for, or being written
+		size_t					queuedBytes;
+		bool					stopping;
+		bool					failed;
+		ListFileChecksum		checksum;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// class ListStreamWriter
+	//
+	// Writes a list file (see listFile.h) of any size, one chunk at a time:
+	// elements are gathered in a chunk buffer, which a background thread 
+	// writes to disk while the next one is being filled. Memory use is two 
+	// chunks, regardless of the number of elements.
+	//
+	//	ListStreamWriter< Record > writer( "records.bin", RECORD_VERSION );
+	//	for( ... ) writer.append( record );
+	//	bool written = writer.close();
+	//
+	// The file is complete, and can be read with ListStreamReader or 
+	// MappedList, once close returns true.
+	//////////////////////////////////////////////////////////////////////////
+	template< typename T >
+	class ListStreamWriter : private ListStreamWriterBase {
+	public:
+		using ListStreamWriterBase::DEFAULT_CHUNK_BYTES;
+
+		ListStreamWriter();
+		explicit ListStreamWriter( const char* path, uint32_t userVersion = 0, size_t chunkBytes = DEFAULT_CHUNK_BYTES );
+		~ListStreamWriter();
+
+		bool	open( const char* path, uint32_t userVersion = 0, size_t chunkBytes = DEFAULT_CHUNK_BYTES );	// returns false if the file can't be created
+		bool	close();		// returns false if any write failed, in which case the file is removed
+		bool	isOpen() const;
+
+		void	append( const T& obj );
+		void	appendRange( const T* first, size_t count );
+		template< class Allocator, class Growth >
+		void	append( const List< T, Allocator, Growth >& list );
+
+		size_t	size() const;	// number of elements appended so far
+
+	private:
+		static_assert( std::is_trivially_copyable< T >::value, "only trivially copyable types can be streamed" );
+
+		T*			chunk;			// buffer being filled
+		size_t		chunkUsed;
+		size_t		submitted;		// elements in the chunks already handed to the writing thread
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// class ListStreamReaderBase
+	//
+	// Untyped core of ListStreamReader: owns the two chunk buffers and the 
+	// background thread reading ahead into them.
+	//////////////////////////////////////////////////////////////////////////
+	class ListStreamReaderBase {
+	public:
+		static const size_t DEFAULT_CHUNK_BYTES = 4 * 1024 * 1024;
+
+	protected:
+		ListStreamReaderBase();
+		~ListStreamReaderBase();
+
+		bool		openStream( const char* path, size_t elementSize, size_t elementAlignment, uint32_t userVersion, size_t chunkBytes, bool verifyChecksum );
+		void		closeStream();
+		const void*	nextChunk( size_t& count );		// NULL at the end of the file or on failure
+		bool		isStreamOpen() const { return file != NULL; }
+		uint64_t	getStreamCount() const { return header.count; }
+		bool		hasStreamFailed();
+
+	private:
+		ListStreamReaderBase( const ListStreamReaderBase& );
+		ListStreamReaderBase& operator=( const ListStreamReaderBase& );
+
+		void		readLoop();
+
+	private:
+		FILE*					file;
+		ListFileHeader			header;
+		size_t					chunkElements;
+		size_t					numChunks;
+		bool					verifyChecksum;
+		void*					buffers[ 2 ];		// chunk i is read into buffers[ i % 2 ]
+		size_t					bufferCounts[ 2 ];
+		size_t					requested;			// chunks handed to the caller
+
+		// shared with the reading thread
+		std::thread				thread;
+		std::mutex				mutex;
+		std::condition_variable	condition;
+		size_t					filled;				// chunks read so far
+		size_t					released;			// chunks the caller is done with
+		bool					stopping;
+		bool					failed;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// class ListStreamReader
+	//
+	// Reads a list file (see listFile.h) of any size one chunk at a time, 
+	// while a background thread reads the following chunk ahead. Memory use 
+	// is two chunks, regardless of the number of elements, and sequential 
+	// reads keep the disk busy while the caller processes each chunk.
+	//
+	//	ListStreamReader< Record > reader( "records.bin", RECORD_VERSION );
+	//	reader.forEachChunk( [ & ]( Span< const Record > records ) { ... } );
+	//
+	// With verifyChecksum, the checksum is accumulated as the chunks are read
+	// and a mismatch makes the last chunk fail, so callers must check 
+	// hasFailed (or the result of forEachChunk) before trusting the results.
+	//////////////////////////////////////////////////////////////////////////
+	template< typename T >
+	class ListStreamReader : private ListStreamReaderBase {
+	public:
+		using ListStreamReaderBase::DEFAULT_CHUNK_BYTES;
+
+		ListStreamReader();
+		explicit ListStreamReader( const char* path, uint32_t userVersion = 0, size_t chunkBytes = DEFAULT_CHUNK_BYTES, bool verifyChecksum = false );
+		~ListStreamReader();
+
+		bool	open( const char* path, uint32_t userVersion = 0, size_t chunkBytes = DEFAULT_CHUNK_BYTES, bool verifyChecksum = false );	// returns false if the file can't be read or doesn't match T
+		void	close();
+		bool	isOpen() const;
+
+		size_t	size() const;				// number of elements in the file
+
+		Span< const T >	nextChunk();		// next chunk of elements, valid until the following call. Empty at the end of the file
+		template< class Function >
+		bool	forEachChunk( Function f );	// calls f( Span< const T > ) for each remaining chunk, returns false if reading failed
+		bool	hasFailed();				// whether a read failed, or the checksum didn't match
+
+	private:
+		static_assert( std::is_trivially_copyable< T >::value, "only trivially copyable types can be streamed" );
+	};
+
+	#include "listStream.inl"
+}
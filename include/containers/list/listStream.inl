@@ -0,0 +1,240 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamWriter< type >::ListStreamWriter
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline ListStreamWriter< type >::ListStreamWriter()
+	:	chunk( NULL ),
+		chunkUsed( 0 ),
+		submitted( 0 ) {
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamWriter< type >::ListStreamWriter( const char*, uint32_t, size_t )
+//
+// Creates the file, check isOpen for the result.
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline ListStreamWriter< type >::ListStreamWriter( const char* path, uint32_t userVersion, size_t chunkBytes )
+	:	chunk( NULL ),
+		chunkUsed( 0 ),
+		submitted( 0 ) {
+	open( path, userVersion, chunkBytes );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamWriter< type >::~ListStreamWriter
+//
+// Completes the file, if still open.
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline ListStreamWriter< type >::~ListStreamWriter() {
+	close();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamWriter< type >::open
+//
+// Chunks hold chunkBytes worth of elements, and at least one.
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline bool ListStreamWriter< type >::open( const char* path, uint32_t userVersion, size_t chunkBytes ) {
+	close();
+	chunk = static_cast< type* >( openStream( path, sizeof( type ), std::alignment_of< type >::value, userVersion, chunkBytes ) );
+	return chunk != NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamWriter< type >::close
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline bool ListStreamWriter< type >::close() {
+	if ( !isStreamOpen() ) {
+		return false;
+	}
+	const bool written = closeStream( chunkUsed );
+	chunk = NULL;
+	chunkUsed = 0;
+	submitted = 0;
+	return written;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamWriter< type >::isOpen
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline bool ListStreamWriter< type >::isOpen() const {
+	return isStreamOpen();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamWriter< type >::append
+//
+// Copies the element into the current chunk, handing it over to the 
+// writing thread once full.
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline void ListStreamWriter< type >::append( type const & obj ) {
+	assert( isStreamOpen() );
+	if ( chunkUsed == getChunkElements() ) {
+		chunk = static_cast< type* >( submitChunk( chunkUsed ) );
+		submitted += chunkUsed;
+		chunkUsed = 0;
+	}
+	chunk[ chunkUsed++ ] = obj;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamWriter< type >::appendRange
+//
+// Copies the elements a chunk at a time.
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline void ListStreamWriter< type >::appendRange( const type* first, size_t count ) {
+	assert( isStreamOpen() );
+	while( count > 0 ) {
+		if ( chunkUsed == getChunkElements() ) {
+			chunk = static_cast< type* >( submitChunk( chunkUsed ) );
+			submitted += chunkUsed;
+			chunkUsed = 0;
+		}
+		const size_t free = getChunkElements() - chunkUsed;
+		const size_t run = count < free ? count : free;
+		memcpy( chunk + chunkUsed, first, run * sizeof( type ) );
+		chunkUsed += run;
+		first += run;
+		count -= run;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamWriter< type >::append( const List & )
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+template< class Allocator, class Growth >
+inline void ListStreamWriter< type >::append( const List< type, Allocator, Growth >& list ) {
+	appendRange( list.begin(), list.size() );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamWriter< type >::size
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline size_t ListStreamWriter< type >::size() const {
+	return submitted + chunkUsed;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamReader< type >::ListStreamReader
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline ListStreamReader< type >::ListStreamReader() {
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamReader< type >::ListStreamReader( const char*, uint32_t, size_t, bool )
+//
+// Opens the file and starts reading ahead, check isOpen for the result.
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline ListStreamReader< type >::ListStreamReader( const char* path, uint32_t userVersion, size_t chunkBytes, bool verifyChecksum ) {
+	open( path, userVersion, chunkBytes, verifyChecksum );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamReader< type >::~ListStreamReader
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline ListStreamReader< type >::~ListStreamReader() {
+	close();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamReader< type >::open
+//
+// Checks that the file header matches the element type and userVersion, 
+// and starts reading the first chunks in the background.
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline bool ListStreamReader< type >::open( const char* path, uint32_t userVersion, size_t chunkBytes, bool verifyChecksum ) {
+	return openStream( path, sizeof( type ), std::alignment_of< type >::value, userVersion, chunkBytes, verifyChecksum );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamReader< type >::close
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline void ListStreamReader< type >::close() {
+	closeStream();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamReader< type >::isOpen
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline bool ListStreamReader< type >::isOpen() const {
+	return isStreamOpen();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamReader< type >::size
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline size_t ListStreamReader< type >::size() const {
+	return (size_t)getStreamCount();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamReader< type >::nextChunk
+//
+// Returns the next chunk, waiting for it to be read if the background 
+// thread isn't done with it yet. The previous chunk is released, so that 
+// its buffer can be reused for reading ahead.
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline Span< const type > ListStreamReader< type >::nextChunk() {
+	size_t count = 0;
+	const type* elements = static_cast< const type* >( ListStreamReaderBase::nextChunk( count ) );
+	return Span< const type >( elements, count );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamReader< type >::forEachChunk
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+template< class Function >
+inline bool ListStreamReader< type >::forEachChunk( Function f ) {
+	for( Span< const type > elements = nextChunk(); !elements.empty(); elements = nextChunk() ) {
+		f( elements );
+	}
+	return !hasFailed();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ListStreamReader< type >::hasFailed
+//////////////////////////////////////////////////////////////////////////
+template< typename type >
+inline bool ListStreamReader< type >::hasFailed() {
+	return hasStreamFailed();
+}
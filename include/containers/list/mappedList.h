@@ -0,0 +1,135 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include <memory/mappedFile.h>
+#include <memory/standardAllocator.h>
+#include "list.h"
+#include "listFile.h"
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// MappedListAllocator
+	//
+	// Standard heap allocator which knows about a file mapping, and ignores 
+	// requests to release storage within it. Lets a List start out on top of
+	// a mapped file and move to the heap if it ever grows.
+	////////////////////////////////////////////////////////////////////////////
+	template< class T >
+	class MappedListAllocator {
+	public:
+		MappedListAllocator() : mappingBegin( NULL ), mappingEnd( NULL ) {}
+		MappedListAllocator( const void* mapping, size_t bytes ) 
+			:	mappingBegin( static_cast< const char* >( mapping ) ), 
+				mappingEnd( static_cast< const char* >( mapping ) + bytes ) {}
+
+		T* alloc( size_t count ) { return StandardAllocator< T >::alloc( count ); }
+		void free( T* objects, size_t count ) {
+			if ( !isMapped( objects ) ) {
+				StandardAllocator< T >::free( objects, count );
+			}
+		}
+
+		T* allocRaw( size_t count ) { return StandardAllocator< T >::allocRaw( count ); }
+		void freeRaw( T* ptr, size_t count ) {
+			if ( !isMapped( ptr ) ) {
+				StandardAllocator< T >::freeRaw( ptr, count );
+			}
+		}
+
+		bool isMapped( const T* ptr ) const {
+			const char* address = reinterpret_cast< const char* >( ptr );
+			return address >= mappingBegin && address < mappingEnd;
+		}
+
+	private:
+		const char*	mappingBegin;
+		const char*	mappingEnd;
+	};
+
+} // namespace Memory
+
+	//////////////////////////////////////////////////////////////////////////
+	// class MappedList
+	//
+	// Opens a file written by writeListFile as a List of T, mapping it into 
+	// memory and using the elements in place: nothing is copied or parsed, 
+	// and opening costs the same regardless of the number of elements. The 
+	// pages are read from the page cache as they are first touched. 
+	//
+	//	writeListFile( "records.bin", records, RECORD_VERSION );
+	//	...
+	//	MappedList< Record > view( "records.bin", MappedList< Record >::READ_ONLY, RECORD_VERSION );
+	//	if ( view.isOpen() ) {
+	//		int index = view->findIndex( key );
+	//
+	// The whole const API of List is available through getList(), or 
+	// straight through the -> operator. Copy on write views also hand out a
+	// mutable List: writes to the elements stay private to the process, and 
+	// growing the list moves it to the heap. In both cases the List belongs 
+	// to the view, and must not outlive it.
+	//////////////////////////////////////////////////////////////////////////
+	template< typename T, class Growth = FixedGrowth >
+	class MappedList {
+	public:
+		typedef List< T, Memory::MappedListAllocator< T >, Growth > ListType;
+
+		enum Mode {
+			READ_ONLY,
+			COPY_ON_WRITE
+		};
+
+		MappedList();
+		explicit MappedList( const char* path, Mode mode = READ_ONLY, uint32_t userVersion = 0, bool verifyChecksum = false );
+		~MappedList();
+
+		bool open( const char* path, Mode mode = READ_ONLY, uint32_t userVersion = 0, bool verifyChecksum = false );	// returns false if the file can't be mapped or doesn't match T
+		void close();
+
+		bool isOpen() const;
+		Mode getMode() const;
+
+		const ListType&		getList() const;
+		ListType&			getMutableList();			// copy on write views only
+		const ListType*		operator->() const;
+
+		void willNeed() const;		// hints that every element is about to be read, so the kernel can start paging them in
+
+	private:
+		MappedList( const MappedList& );
+		MappedList& operator=( const MappedList& );
+
+	private:
+		static_assert( std::is_trivially_copyable< T >::value, "only lists of trivially copyable types can be mapped" );
+
+		Memory::MappedFile	file;
+		ListType			elements;		// declared after the file, so that it's released before the file is unmapped
+		Mode				mode;
+	};
+
+	#include "mappedList.inl"
+}
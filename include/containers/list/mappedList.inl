@@ -0,0 +1,144 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// MappedList< type, GrowthPolicy >::MappedList
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class GrowthPolicy >
+inline MappedList< type, GrowthPolicy >::MappedList()
+	:	mode( READ_ONLY ) {
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MappedList< type, GrowthPolicy >::MappedList( const char*, Mode, uint32_t, bool )
+//
+// Opens the given file, check isOpen for the result.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class GrowthPolicy >
+inline MappedList< type, GrowthPolicy >::MappedList( const char* path, Mode newMode, uint32_t userVersion, bool verifyChecksum )
+	:	mode( READ_ONLY ) {
+	open( path, newMode, userVersion, verifyChecksum );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MappedList< type, GrowthPolicy >::~MappedList
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class GrowthPolicy >
+inline MappedList< type, GrowthPolicy >::~MappedList() {
+	close();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MappedList< type, GrowthPolicy >::open
+//
+// Maps the file and checks that its header matches the element type and 
+// userVersion. Verifying the checksum of the elements reads the whole file,
+// so it defeats the purpose of mapping it, and is best left for files of 
+// unknown origin.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class GrowthPolicy >
+inline bool MappedList< type, GrowthPolicy >::open( const char* path, Mode newMode, uint32_t userVersion, bool verifyChecksum ) {
+	close();
+
+	if ( !file.open( path, newMode == COPY_ON_WRITE ? Memory::MappedFile::ACCESS_COPY_ON_WRITE : Memory::MappedFile::ACCESS_READ_ONLY ) ) {
+		return false;
+	}
+
+	const ListFileHeader* header = validateListFile( file.getData(), file.getSize(), sizeof( type ), std::alignment_of< type >::value, userVersion, verifyChecksum );
+	if ( header == NULL ) {
+		file.close();
+		return false;
+	}
+
+	// the list is only ever written through in copy on write mode, where 
+	// the mapping is writable
+	char* mapping = const_cast< char* >( static_cast< const char* >( file.getData() ) );
+	type* storage = header->count > 0 ? reinterpret_cast< type* >( mapping + header->dataOffset ) : NULL;
+	elements = ListType( Memory::MappedListAllocator< type >( mapping, file.getSize() ) );
+	elements.adoptStorage( storage, (size_t)header->count );
+	mode = newMode;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MappedList< type, GrowthPolicy >::close
+//
+// Releases the list and unmaps the file.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class GrowthPolicy >
+inline void MappedList< type, GrowthPolicy >::close() {
+	elements = ListType();
+	file.close();
+	mode = READ_ONLY;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MappedList< type, GrowthPolicy >::isOpen
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class GrowthPolicy >
+inline bool MappedList< type, GrowthPolicy >::isOpen() const {
+	return file.isOpen();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MappedList< type, GrowthPolicy >::getMode
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class GrowthPolicy >
+inline typename MappedList< type, GrowthPolicy >::Mode MappedList< type, GrowthPolicy >::getMode() const {
+	return mode;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MappedList< type, GrowthPolicy >::getList
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class GrowthPolicy >
+inline const typename MappedList< type, GrowthPolicy >::ListType& MappedList< type, GrowthPolicy >::getList() const {
+	return elements;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MappedList< type, GrowthPolicy >::getMutableList
+//
+// Writing to a read only mapping would fault, so only copy on write views
+// can be modified.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class GrowthPolicy >
+inline typename MappedList< type, GrowthPolicy >::ListType& MappedList< type, GrowthPolicy >::getMutableList() {
+	assert( mode == COPY_ON_WRITE );
+	return elements;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MappedList< type, GrowthPolicy >::operator->
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class GrowthPolicy >
+inline const typename MappedList< type, GrowthPolicy >::ListType* MappedList< type, GrowthPolicy >::operator->() const {
+	return &elements;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MappedList< type, GrowthPolicy >::willNeed
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class GrowthPolicy >
+inline void MappedList< type, GrowthPolicy >::willNeed() const {
+	file.willNeed( 0, file.getSize() );
+}
@@ -0,0 +1,47 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <memory/inlineAllocator.h>
+#include "list.h"
+
+namespace CoreLib {
+
+	//////////////////////////////////////////////////////////////////////////
+	// SmallList
+	//
+	// List storing up to N elements within the list object itself, and only 
+	// drawing from the Fallback allocator once it outgrows them. This spares
+	// the heap allocation for the many lists which only ever hold a handful 
+	// of elements, at the cost of a bigger list object. 
+	//
+	// It is a plain List using an InlineAllocator, so it offers the same 
+	// interface and can be swapped in per call site, e.g.
+	//	SmallList< int, 8 > neighbors;
+	//
+	// Unlike List, moving or swapping a SmallList whose elements are stored 
+	// inline moves the elements one by one.
+	//////////////////////////////////////////////////////////////////////////
+	template< typename T, size_t N, class Growth = FixedGrowth, class Fallback = Memory::StandardAllocator< T > >
+	using SmallList = List< T, Memory::InlineAllocator< T, N, Fallback >, Growth >;
+}
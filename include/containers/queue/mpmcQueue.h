@@ -0,0 +1,116 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <assert.h>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <memory/alignment.h>
+#include <memory/construct.h>
+#include <memory/standardAllocator.h>
+
+namespace CoreLib {
+
+	//////////////////////////////////////////////////////////////////////////
+	// class MpmcQueue
+	//
+	// Bounded FIFO queue which any number of threads can push to and pop 
+	// from at once, after Dmitry Vyukov's bounded MPMC queue. The ring 
+	// buffer cells carry a sequence number telling, for the position being
+	// claimed, whether the cell is free to fill or holds an element to take.
+	// Threads claim positions with a CAS on the shared enqueue (or dequeue)
+	// index, and never wait for each other: push and pop fail instead when
+	// the queue is full or empty.
+	//
+	// pushRange and popRange claim a run of consecutive cells with a single
+	// CAS, so batches cost one contended operation.
+	//
+	// The cells, holding the elements along with their sequence numbers, 
+	// are allocated once from a byte allocator policy, aligned to a cache 
+	// line.
+	//////////////////////////////////////////////////////////////////////////
+	template< typename T, class Allocator = CoreLib::Memory::StandardAllocator< unsigned char > >
+	class MpmcQueue : private Allocator {
+	public:
+		typedef const T			ConstType;
+		typedef T				Type;
+
+		explicit MpmcQueue( size_t capacity );
+		MpmcQueue( const Allocator& allocator, size_t capacity );
+		~MpmcQueue();
+
+		// thread safe
+		bool		push( ConstType& obj );						// returns false if the queue is full
+		bool		push( Type&& obj );
+		template< typename... Args >
+		bool		emplace( Args&&... args );					// pushes an element constructed in place from args
+		size_t		pushRange( ConstType* first, size_t count );	// pushes as many of the count elements as fit, returns how many
+
+		bool		pop( Type& obj );							// moves the oldest element into obj, returns false if the queue is empty
+		size_t		popRange( Type* out, size_t maxCount );		// moves up to maxCount elements into out, returns how many
+
+		size_t		size() const;								// approximate while the queue is in use
+		bool		empty() const;
+
+		size_t		capacity() const;							// the requested capacity rounded up to a power of two
+
+		const Allocator& getAllocator() const;
+
+	private:
+		MpmcQueue( const MpmcQueue& );
+		MpmcQueue& operator=( const MpmcQueue& );
+
+		struct Cell {
+			std::atomic< size_t >	sequence;	// position + 1 once filled, position + capacity once taken
+			typename std::aligned_storage< sizeof( T ), std::alignment_of< T >::value >::type storage;
+
+			Type* element() { return reinterpret_cast< Type* >( &storage ); }
+		};
+
+		void		init( size_t capacity );
+		size_t		claim( std::atomic< size_t >& index, size_t count, size_t full, size_t& claimed );	// claims up to count cells ready to fill (full = 0) or to take (full = 1), returns the first position
+		size_t		storageBytes() const;
+
+	private:
+		static_assert( std::alignment_of< T >::value <= Memory::CACHE_LINE_SIZE, "over-aligned types are not supported" );
+
+		// read only once created
+		Cell*					cells;
+		size_t					mask;
+		unsigned char*			storage;		// as returned by the allocator
+		char					cellsPadding[ Memory::CACHE_LINE_SIZE - sizeof( Cell* ) - sizeof( size_t ) - sizeof( unsigned char* ) ];
+
+		// contended by the producers
+		std::atomic< size_t >	enqueuePos;
+		char					enqueuePadding[ Memory::CACHE_LINE_SIZE - sizeof( std::atomic< size_t > ) ];
+
+		// contended by the consumers
+		std::atomic< size_t >	dequeuePos;
+		char					dequeuePadding[ Memory::CACHE_LINE_SIZE - sizeof( std::atomic< size_t > ) ];
+	};
+
+	#include "mpmcQueue.inl"
+}
@@ -0,0 +1,283 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::MpmcQueue( size_t )
+//
+// The capacity is rounded up to a power of two.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline MpmcQueue< type, AllocPolicy >::MpmcQueue( size_t capacity ) {
+	init( capacity );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::MpmcQueue( const AllocPolicy&, size_t )
+//
+// The allocator must be thread safe if the queue is destroyed on another
+// thread than the one which created it.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline MpmcQueue< type, AllocPolicy >::MpmcQueue( const AllocPolicy& allocator, size_t capacity )
+	:	AllocPolicy( allocator ) {
+	init( capacity );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::~MpmcQueue
+//
+// Destroys the elements left in the queue.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline MpmcQueue< type, AllocPolicy >::~MpmcQueue() {
+	const size_t last = enqueuePos.load( std::memory_order_acquire );
+	for( size_t i = dequeuePos.load( std::memory_order_relaxed ); i != last; i++ ) {
+		cells[ i & mask ].element()->~type();
+	}
+	for( size_t i = 0; i <= mask; i++ ) {
+		cells[ i ].~Cell();
+	}
+	AllocPolicy::freeRaw( storage, storageBytes() );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::init
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline void MpmcQueue< type, AllocPolicy >::init( size_t capacity ) {
+	size_t roundedCapacity = 1;
+	while ( roundedCapacity < capacity ) {
+		roundedCapacity <<= 1;
+	}
+	mask = roundedCapacity - 1;
+
+	storage = AllocPolicy::allocRaw( storageBytes() );
+	assert( storage != NULL );
+	cells = reinterpret_cast< Cell* >( Memory::alignPointer( storage, Memory::CACHE_LINE_SIZE ) );
+	for( size_t i = 0; i < roundedCapacity; i++ ) {
+		new( cells + i ) Cell;
+		cells[ i ].sequence.store( i, std::memory_order_relaxed );
+	}
+	enqueuePos.store( 0, std::memory_order_relaxed );
+	dequeuePos.store( 0, std::memory_order_relaxed );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::push
+//
+// Copies the element at the back of the queue. Thread safe.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline bool MpmcQueue< type, AllocPolicy >::push( type const & obj ) {
+	return emplace( obj );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::push( type&& )
+//
+// Moves the element at the back of the queue. Thread safe.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline bool MpmcQueue< type, AllocPolicy >::push( type&& obj ) {
+	return emplace( std::move( obj ) );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::emplace
+//
+// Constructs the element in place at the back of the queue. Thread safe.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+template< typename... Args >
+inline bool MpmcQueue< type, AllocPolicy >::emplace( Args&&... args ) {
+	size_t pos = enqueuePos.load( std::memory_order_relaxed );
+	Cell* cell;
+	for( ;; ) {
+		cell = cells + ( pos & mask );
+		const intptr_t diff = (intptr_t)cell->sequence.load( std::memory_order_acquire ) - (intptr_t)pos;
+		if ( diff == 0 ) {
+			if ( enqueuePos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+				break;
+			}
+		} else if ( diff < 0 ) {
+			return false; // the cell still holds the element from the previous lap
+		} else {
+			pos = enqueuePos.load( std::memory_order_relaxed );
+		}
+	}
+	new( cell->element() ) type( std::forward< Args >( args )... );
+	cell->sequence.store( pos + 1, std::memory_order_release );
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::pushRange
+//
+// Copies as many of the elements as fit at the back of the queue, in 
+// order, claiming their cells at once. Thread safe.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t MpmcQueue< type, AllocPolicy >::pushRange( type const * first, size_t count ) {
+	size_t pushed = 0;
+	const size_t pos = claim( enqueuePos, count, 0, pushed );
+	for( size_t i = 0; i < pushed; i++ ) {
+		Cell* cell = cells + ( ( pos + i ) & mask );
+		new( cell->element() ) type( first[ i ] );
+		cell->sequence.store( pos + i + 1, std::memory_order_release );
+	}
+	return pushed;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::pop
+//
+// Moves the oldest element into obj. Thread safe.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline bool MpmcQueue< type, AllocPolicy >::pop( type& obj ) {
+	size_t pos = dequeuePos.load( std::memory_order_relaxed );
+	Cell* cell;
+	for( ;; ) {
+		cell = cells + ( pos & mask );
+		const intptr_t diff = (intptr_t)cell->sequence.load( std::memory_order_acquire ) - (intptr_t)( pos + 1 );
+		if ( diff == 0 ) {
+			if ( dequeuePos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+				break;
+			}
+		} else if ( diff < 0 ) {
+			return false; // the cell hasn't been filled yet
+		} else {
+			pos = dequeuePos.load( std::memory_order_relaxed );
+		}
+	}
+	type* element = cell->element();
+	obj = std::move( *element );
+	element->~type();
+	cell->sequence.store( pos + mask + 1, std::memory_order_release );
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::popRange
+//
+// Moves up to maxCount of the oldest elements into out, in order, 
+// claiming their cells at once. Thread safe.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t MpmcQueue< type, AllocPolicy >::popRange( type* out, size_t maxCount ) {
+	size_t popped = 0;
+	const size_t pos = claim( dequeuePos, maxCount, 1, popped );
+	for( size_t i = 0; i < popped; i++ ) {
+		Cell* cell = cells + ( ( pos + i ) & mask );
+		type* element = cell->element();
+		out[ i ] = std::move( *element );
+		element->~type();
+		cell->sequence.store( pos + i + mask + 1, std::memory_order_release );
+	}
+	return popped;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::claim
+//
+// Claims the longest run, up to count, of consecutive cells from index 
+// whose sequence is their position + full, i.e. free cells for the 
+// producers (full = 0) or filled cells for the consumers (full = 1). 
+// Returns the first position, and the number of cells in claimed.
+//
+// Checking every cell of the run before the CAS is enough: a cell ready 
+// for position p only changes once position p has been claimed, which 
+// the successful CAS rules out for the whole run.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t MpmcQueue< type, AllocPolicy >::claim( std::atomic< size_t >& index, size_t count, size_t full, size_t& claimed ) {
+	size_t pos = index.load( std::memory_order_relaxed );
+	for( ;; ) {
+		size_t ready = 0;
+		bool stale = false;
+		while ( ready < count ) {
+			const intptr_t diff = (intptr_t)cells[ ( pos + ready ) & mask ].sequence.load( std::memory_order_acquire ) - (intptr_t)( pos + ready + full );
+			if ( diff != 0 ) {
+				// ahead of the position, another thread claimed it already
+				stale = diff > 0 && ready == 0;
+				break;
+			}
+			ready++;
+		}
+		if ( stale ) {
+			pos = index.load( std::memory_order_relaxed );
+			continue;
+		}
+		if ( ready == 0 ) {
+			claimed = 0;
+			return pos;
+		}
+		if ( index.compare_exchange_weak( pos, pos + ready, std::memory_order_relaxed ) ) {
+			claimed = ready;
+			return pos;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::size
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t MpmcQueue< type, AllocPolicy >::size() const {
+	const size_t dequeued = dequeuePos.load( std::memory_order_acquire );
+	const size_t enqueued = enqueuePos.load( std::memory_order_acquire );
+	return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::empty
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline bool MpmcQueue< type, AllocPolicy >::empty() const {
+	return size() == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::capacity
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t MpmcQueue< type, AllocPolicy >::capacity() const {
+	return mask + 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::getAllocator
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline const AllocPolicy& MpmcQueue< type, AllocPolicy >::getAllocator() const {
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// MpmcQueue< type, AllocPolicy >::storageBytes
+//
+// Room for the cells, plus the slack to align them to a cache line.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t MpmcQueue< type, AllocPolicy >::storageBytes() const {
+	return ( mask + 1 ) * sizeof( Cell ) + Memory::CACHE_LINE_SIZE - 1;
+}
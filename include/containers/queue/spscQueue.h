@@ -0,0 +1,112 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <assert.h>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <memory/alignment.h>
+#include <memory/construct.h>
+#include <memory/standardAllocator.h>
+
+namespace CoreLib {
+
+	//////////////////////////////////////////////////////////////////////////
+	// class SpscQueue
+	//
+	// Bounded FIFO queue between exactly one producer thread and one 
+	// consumer thread, e.g. two stages of a pipeline:
+	//
+	//	SpscQueue< Packet > queue( 1024 );
+	//	producer:	while ( !queue.push( packet ) ) { /* full, back off */ }
+	//	consumer:	Packet packet; if ( queue.pop( packet ) ) { ... }
+	//
+	// The elements live in a ring buffer of a power of two capacity, 
+	// allocated once from the allocator policy. Neither side ever blocks or
+	// takes a lock: push and pop fail instead when the queue is full or 
+	// empty. Each side keeps a cached copy of the other side's index, on 
+	// its own cache line, and only reads the shared index when the cached 
+	// one says the queue is full (or empty), so in the steady state the two
+	// threads don't touch each other's cache lines except for the elements.
+	//
+	// pushRange and popRange move a batch of elements with a single index 
+	// update.
+	//////////////////////////////////////////////////////////////////////////
+	template< typename T, class Allocator = CoreLib::Memory::StandardAllocator< T > >
+	class SpscQueue : private Allocator {
+	public:
+		typedef const T			ConstType;
+		typedef T				Type;
+
+		explicit SpscQueue( size_t capacity );
+		SpscQueue( const Allocator& allocator, size_t capacity );
+		~SpscQueue();
+
+		// producer only
+		bool		push( ConstType& obj );						// returns false if the queue is full
+		bool		push( Type&& obj );
+		template< typename... Args >
+		bool		emplace( Args&&... args );					// pushes an element constructed in place from args
+		size_t		pushRange( ConstType* first, size_t count );	// pushes as many of the count elements as fit, returns how many
+
+		// consumer only
+		bool		pop( Type& obj );							// moves the oldest element into obj, returns false if the queue is empty
+		size_t		popRange( Type* out, size_t maxCount );		// moves up to maxCount elements into out, returns how many
+
+		// any thread, approximate while the queue is in use
+		size_t		size() const;
+		bool		empty() const;
+
+		size_t		capacity() const;							// the requested capacity rounded up to a power of two
+
+		const Allocator& getAllocator() const;
+
+	private:
+		SpscQueue( const SpscQueue& );
+		SpscQueue& operator=( const SpscQueue& );
+
+		void		init( size_t capacity );
+		size_t		freeSlots( size_t tail, size_t wanted );	// slots the producer can fill, refreshing the cached head if less than wanted
+		size_t		usedSlots( size_t head, size_t wanted );	// slots the consumer can take, refreshing the cached tail if less than wanted
+
+	private:
+		// read only once created
+		Type*					slots;
+		size_t					mask;
+		char					slotsPadding[ Memory::CACHE_LINE_SIZE - sizeof( Type* ) - sizeof( size_t ) ];
+
+		// written by the producer
+		std::atomic< size_t >	tail;			// next slot to fill
+		size_t					cachedHead;		// last head seen by the producer
+		char					tailPadding[ Memory::CACHE_LINE_SIZE - sizeof( std::atomic< size_t > ) - sizeof( size_t ) ];
+
+		// written by the consumer
+		std::atomic< size_t >	head;			// next slot to take
+		size_t					cachedTail;		// last tail seen by the consumer
+		char					headPadding[ Memory::CACHE_LINE_SIZE - sizeof( std::atomic< size_t > ) - sizeof( size_t ) ];
+	};
+
+	#include "spscQueue.inl"
+}
@@ -0,0 +1,234 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::SpscQueue( size_t )
+//
+// The capacity is rounded up to a power of two.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline SpscQueue< type, AllocPolicy >::SpscQueue( size_t capacity ) {
+	init( capacity );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::SpscQueue( const AllocPolicy&, size_t )
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline SpscQueue< type, AllocPolicy >::SpscQueue( const AllocPolicy& allocator, size_t capacity )
+	:	AllocPolicy( allocator ) {
+	init( capacity );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::~SpscQueue
+//
+// Destroys the elements left in the queue.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline SpscQueue< type, AllocPolicy >::~SpscQueue() {
+	const size_t last = tail.load( std::memory_order_acquire );
+	for( size_t i = head.load( std::memory_order_relaxed ); i != last; i++ ) {
+		slots[ i & mask ].~type();
+	}
+	AllocPolicy::freeRaw( slots, mask + 1 );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::init
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline void SpscQueue< type, AllocPolicy >::init( size_t capacity ) {
+	size_t roundedCapacity = 1;
+	while ( roundedCapacity < capacity ) {
+		roundedCapacity <<= 1;
+	}
+	slots = AllocPolicy::allocRaw( roundedCapacity );
+	assert( slots != NULL );
+	mask = roundedCapacity - 1;
+	tail.store( 0, std::memory_order_relaxed );
+	cachedHead = 0;
+	head.store( 0, std::memory_order_relaxed );
+	cachedTail = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::push
+//
+// Copies the element at the back of the queue. Producer only.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline bool SpscQueue< type, AllocPolicy >::push( type const & obj ) {
+	return emplace( obj );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::push( type&& )
+//
+// Moves the element at the back of the queue. Producer only.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline bool SpscQueue< type, AllocPolicy >::push( type&& obj ) {
+	return emplace( std::move( obj ) );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::emplace
+//
+// Constructs the element in place at the back of the queue. Producer only.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+template< typename... Args >
+inline bool SpscQueue< type, AllocPolicy >::emplace( Args&&... args ) {
+	const size_t t = tail.load( std::memory_order_relaxed );
+	if ( freeSlots( t, 1 ) == 0 ) {
+		return false;
+	}
+	new( slots + ( t & mask ) ) type( std::forward< Args >( args )... );
+	tail.store( t + 1, std::memory_order_release );
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::pushRange
+//
+// Copies as many of the elements as fit at the back of the queue, and 
+// publishes them at once. Producer only.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t SpscQueue< type, AllocPolicy >::pushRange( type const * first, size_t count ) {
+	const size_t t = tail.load( std::memory_order_relaxed );
+	const size_t available = freeSlots( t, count );
+	const size_t pushed = count < available ? count : available;
+
+	// up to two runs, split where the ring wraps around
+	const size_t begin = t & mask;
+	const size_t firstRun = pushed < mask + 1 - begin ? pushed : mask + 1 - begin;
+	Memory::copyConstruct( slots + begin, first, firstRun );
+	Memory::copyConstruct( slots, first + firstRun, pushed - firstRun );
+
+	tail.store( t + pushed, std::memory_order_release );
+	return pushed;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::pop
+//
+// Moves the oldest element into obj. Consumer only.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline bool SpscQueue< type, AllocPolicy >::pop( type& obj ) {
+	const size_t h = head.load( std::memory_order_relaxed );
+	if ( usedSlots( h, 1 ) == 0 ) {
+		return false;
+	}
+	type* slot = slots + ( h & mask );
+	obj = std::move( *slot );
+	slot->~type();
+	head.store( h + 1, std::memory_order_release );
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::popRange
+//
+// Moves up to maxCount of the oldest elements into out, in order, and 
+// releases their slots at once. Consumer only.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t SpscQueue< type, AllocPolicy >::popRange( type* out, size_t maxCount ) {
+	const size_t h = head.load( std::memory_order_relaxed );
+	const size_t available = usedSlots( h, maxCount );
+	const size_t popped = maxCount < available ? maxCount : available;
+	for( size_t i = 0; i < popped; i++ ) {
+		type* slot = slots + ( ( h + i ) & mask );
+		out[ i ] = std::move( *slot );
+		slot->~type();
+	}
+	head.store( h + popped, std::memory_order_release );
+	return popped;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::size
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t SpscQueue< type, AllocPolicy >::size() const {
+	const size_t h = head.load( std::memory_order_acquire );
+	const size_t t = tail.load( std::memory_order_acquire );
+	return t > h ? t - h : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::empty
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline bool SpscQueue< type, AllocPolicy >::empty() const {
+	return size() == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::capacity
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t SpscQueue< type, AllocPolicy >::capacity() const {
+	return mask + 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::getAllocator
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline const AllocPolicy& SpscQueue< type, AllocPolicy >::getAllocator() const {
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::freeSlots
+//
+// The acquire load of head orders the consumer's reads of the slots 
+// before the producer overwrites them.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t SpscQueue< type, AllocPolicy >::freeSlots( size_t t, size_t wanted ) {
+	size_t available = mask + 1 - ( t - cachedHead );
+	if ( available < wanted ) {
+		cachedHead = head.load( std::memory_order_acquire );
+		available = mask + 1 - ( t - cachedHead );
+	}
+	return available;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpscQueue< type, AllocPolicy >::usedSlots
+//
+// The acquire load of tail makes the producer's elements visible.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, class AllocPolicy >
+inline size_t SpscQueue< type, AllocPolicy >::usedSlots( size_t h, size_t wanted ) {
+	size_t available = cachedTail - h;
+	if ( available < wanted ) {
+		cachedTail = tail.load( std::memory_order_acquire );
+		available = cachedTail - h;
+	}
+	return available;
+}
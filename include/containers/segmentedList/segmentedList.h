@@ -0,0 +1,172 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stdlib.h>
+#include <assert.h>
+#include <iterator>
+#include <memory/standardAllocator.h>
+#include <memory/construct.h>
+#include <containers/list/list.h>
+
+namespace CoreLib {
+
+	//////////////////////////////////////////////////////////////////////////
+	// class SegmentedListIterator
+	//
+	// Forward iterator over a SegmentedList, stepping through each block with
+	// a pointer and only going back to the block table at block boundaries.
+	//////////////////////////////////////////////////////////////////////////
+	template< class ListType, typename ValueType >
+	class SegmentedListIterator {
+	public:
+		typedef std::forward_iterator_tag	iterator_category;
+		typedef ValueType					value_type;
+		typedef ptrdiff_t					difference_type;
+		typedef ValueType*					pointer;
+		typedef ValueType&					reference;
+
+		SegmentedListIterator( ListType* list, size_t index ) 
+			:	list( list ), 
+				index( index ), 
+				current( index < list->size() ? &( *list )[ index ] : NULL ) {}
+
+		reference	operator*() const { return *current; }
+		pointer		operator->() const { return current; }
+
+		SegmentedListIterator& operator++() {
+			++index;
+			++current;
+			if ( index % ListType::BLOCK_SIZE == 0 ) {
+				current = index < list->size() ? &( *list )[ index ] : NULL;
+			}
+			return *this;
+		}
+		SegmentedListIterator operator++( int ) { SegmentedListIterator it( *this ); ++( *this ); return it; }
+
+		bool operator==( const SegmentedListIterator& other ) const { return index == other.index; }
+		bool operator!=( const SegmentedListIterator& other ) const { return index != other.index; }
+
+	private:
+		ListType*	list;
+		size_t		index;
+		ValueType*	current;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// class SegmentedList
+	//
+	// List whose elements live in fixed size blocks of BlockSize elements, 
+	// found through a small table of block pointers. Growing the list only 
+	// allocates new blocks: elements are never copied or moved, so pointers 
+	// to them stay valid until the element itself is removed. Indexed access
+	// is a shift and a mask away from a block pointer.
+	//
+	// Blocks are drawn one at a time from the Allocator policy, e.g. 
+	//
+	//	SegmentedList< Entity, 1024, Memory::StaticMemoryPool< Entity > > entities;
+	//
+	// Unused blocks are kept as capacity until shrinkToFit or clear.
+	//////////////////////////////////////////////////////////////////////////
+	template< typename T, size_t BlockSize = 256, class Allocator = CoreLib::Memory::StandardAllocator< T > >
+	class SegmentedList : private Allocator {
+	public:
+		typedef const T			ConstType;
+		typedef T				Type;
+		typedef SegmentedListIterator< SegmentedList, T >					Iterator;
+		typedef SegmentedListIterator< const SegmentedList, const T >		ConstIterator;
+
+		static const size_t BLOCK_SIZE = BlockSize;
+
+		SegmentedList();
+		explicit SegmentedList( const Allocator& allocator );
+		SegmentedList( const SegmentedList& other );
+		SegmentedList( SegmentedList&& other );
+		~SegmentedList();
+
+		size_t size() const;		// number of elements in the list
+		size_t capacity() const;	// number of elements that fit in the allocated blocks
+		size_t numBlocks() const;	// number of allocated blocks
+		bool empty() const;
+
+		void clear();	// clears the list and releases every block
+		void resize( size_t newNum );				// set number of elements in list, default constructing the new ones
+		void preAllocate( size_t newCapacity );		// makes sure there are blocks for newCapacity elements, without changing the current element count
+		void shrinkToFit();	// releases the blocks past the last element
+
+		const Allocator& getAllocator() const;
+
+		SegmentedList&	operator=( const SegmentedList& other );
+		SegmentedList&	operator=( SegmentedList&& other );
+		Type&			operator[]( int index );
+		ConstType&		operator[]( int index ) const;	
+		Type&			operator[]( size_t index );
+		ConstType&		operator[]( size_t index ) const;	
+		Type&			operator[]( unsigned int index );
+		ConstType&		operator[]( unsigned int index ) const;	
+
+		Type&		append();							// returns reference to a new default constructed element at the end of the list
+		int			append( ConstType& obj );			// append element
+		int			append( Type&& obj );				// append element, moving it into the list
+		int			appendRange( ConstType* first, size_t count );	// append count elements copied from first, returns the index of the first one
+		template< typename... Args >
+		int			emplace( Args&&... args );			// append an element constructed in place from args
+
+		bool		removeIndexFast( size_t i );		// remove i-th element, move the last element into its spot
+		void		removeLast();						// remove the last element
+		void		swap( SegmentedList& other );		// swap the contents of the lists
+
+		template< class Function >
+		void		forEachBlock( Function f );			// calls f( T* elements, size_t count ) for each block, in index order
+		template< class Function >
+		void		forEachBlock( Function f ) const;	// calls f( const T* elements, size_t count ) for each block, in index order
+
+		Iterator		begin();
+		Iterator		end();
+
+		ConstIterator	begin() const;
+		ConstIterator	end() const;
+
+	private:
+		Type*	slot( size_t index ) const;
+		void	allocateBlocks( size_t count );			// makes sure there are blocks for count elements
+
+	private:
+		static_assert( BlockSize > 0 && ( BlockSize & ( BlockSize - 1 ) ) == 0, "the block size must be a power of two" );
+
+		typedef List< Type*, CoreLib::Memory::StandardAllocator< Type* >, GeometricGrowth<> > BlockTable;
+
+		size_t			numElements;
+		BlockTable		blocks;			// every block holds BlockSize elements
+	};
+
+	namespace Memory {
+		// only the block table points to the elements, so the list can be 
+		// moved around with memcpy as long as its allocator can
+		template< typename T, size_t BlockSize, class Allocator >
+		struct IsRelocatable< SegmentedList< T, BlockSize, Allocator > > {
+			static const bool value = IsRelocatable< Allocator >::value;
+		};
+	}
+
+	#include "segmentedList.inl"
+}
@@ -0,0 +1,450 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::SegmentedList
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline SegmentedList< type, BlockSize, AllocPolicy >::SegmentedList()
+	:	numElements( 0 ) {
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::SegmentedList( const AllocPolicy & )
+//
+// Creates an empty list drawing its blocks from the given allocator.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline SegmentedList< type, BlockSize, AllocPolicy >::SegmentedList( const AllocPolicy& allocator )
+	:	AllocPolicy( allocator ),
+		numElements( 0 ) {
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::SegmentedList( const SegmentedList &other )
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline SegmentedList< type, BlockSize, AllocPolicy >::SegmentedList( const SegmentedList &other )
+	:	AllocPolicy( other ),
+		numElements( 0 ) {
+	*this = other;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::SegmentedList( SegmentedList &&other )
+//
+// Takes over the blocks of the other list, which is left empty. Pointers 
+// to the elements remain valid.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline SegmentedList< type, BlockSize, AllocPolicy >::SegmentedList( SegmentedList &&other )
+	:	AllocPolicy( other ),
+		numElements( other.numElements ),
+		blocks( std::move( other.blocks ) ) {
+	other.numElements = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::~SegmentedList
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline SegmentedList< type, BlockSize, AllocPolicy >::~SegmentedList() {
+	clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::clear
+//
+// Destroys the elements and releases every block.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline void SegmentedList< type, BlockSize, AllocPolicy >::clear() {
+	resize( 0 );
+	for( size_t i = 0; i < blocks.size(); i++ ) {
+		AllocPolicy::freeRaw( blocks[ i ], BlockSize );
+	}
+	blocks.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::size
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline size_t SegmentedList< type, BlockSize, AllocPolicy >::size() const {
+	return numElements;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::capacity
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline size_t SegmentedList< type, BlockSize, AllocPolicy >::capacity() const {
+	return blocks.size() * BlockSize;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::numBlocks
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline size_t SegmentedList< type, BlockSize, AllocPolicy >::numBlocks() const {
+	return blocks.size();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::empty
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline bool SegmentedList< type, BlockSize, AllocPolicy >::empty() const {
+	return numElements == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::resize
+//
+// New elements are default constructed, and elements beyond the new size 
+// are destroyed. Blocks are kept, see shrinkToFit.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline void SegmentedList< type, BlockSize, AllocPolicy >::resize( size_t newnum ) {
+	if ( newnum < numElements ) {
+		// destroy block by block, from the end
+		while( numElements > newnum ) {
+			const size_t blockBegin = ( numElements - 1 ) & ~( BlockSize - 1 );
+			const size_t begin = blockBegin > newnum ? blockBegin : newnum;
+			Memory::destroy( slot( begin ), numElements - begin );
+			numElements = begin;
+		}
+		return;
+	}
+
+	allocateBlocks( newnum );
+	while( numElements < newnum ) {
+		const size_t blockEnd = ( numElements & ~( BlockSize - 1 ) ) + BlockSize;
+		const size_t end = blockEnd < newnum ? blockEnd : newnum;
+		Memory::defaultConstruct( slot( numElements ), end - numElements );
+		numElements = end;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::preAllocate
+//
+// Makes sure there are blocks for at least the given number of elements
+// but don't actually change the number of items.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline void SegmentedList< type, BlockSize, AllocPolicy >::preAllocate( size_t newSize ) {
+	allocateBlocks( newSize );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::shrinkToFit
+//
+// Releases the blocks holding no elements. The remaining elements don't 
+// move.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline void SegmentedList< type, BlockSize, AllocPolicy >::shrinkToFit() {
+	const size_t usedBlocks = ( numElements + BlockSize - 1 ) / BlockSize;
+	for( size_t i = usedBlocks; i < blocks.size(); i++ ) {
+		AllocPolicy::freeRaw( blocks[ i ], BlockSize );
+	}
+	blocks.resize( usedBlocks );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::getAllocator
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline const AllocPolicy& SegmentedList< type, BlockSize, AllocPolicy >::getAllocator() const {
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::operator=
+//
+// Copies the contents of another list. The list keeps its own allocator.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline SegmentedList< type, BlockSize, AllocPolicy >& SegmentedList< type, BlockSize, AllocPolicy >::operator=( const SegmentedList &other ) {
+	if ( &other == this ) {
+		return *this;
+	}
+
+	clear();
+	allocateBlocks( other.numElements );
+	other.forEachBlock( [ this ]( const type* elements, size_t count ) {
+		Memory::copyConstruct( slot( numElements ), elements, count );
+		numElements += count;
+	} );
+
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::operator=
+//
+// Takes over the blocks, and allocator, of the other list, which is left 
+// empty.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline SegmentedList< type, BlockSize, AllocPolicy >& SegmentedList< type, BlockSize, AllocPolicy >::operator=( SegmentedList &&other ) {
+	if ( &other == this ) {
+		return *this;
+	}
+
+	clear();
+	swap( other );
+
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::operator[]
+//	
+// Access operator. Index must be within range or an assert will be issued 
+// in debug builds.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline const type &SegmentedList< type, BlockSize, AllocPolicy >::operator[]( int index ) const {
+	assert( index >= 0 );
+	assert( index < (int)numElements );
+	return *slot( (size_t)index );
+}
+
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline type &SegmentedList< type, BlockSize, AllocPolicy >::operator[]( int index ) {
+	assert( index >= 0 );
+	assert( index < (int)numElements );
+	return *slot( (size_t)index );
+}
+
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline const type &SegmentedList< type, BlockSize, AllocPolicy >::operator[]( unsigned int index ) const {
+	assert( index < numElements );
+	return *slot( index );
+}
+
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline type &SegmentedList< type, BlockSize, AllocPolicy >::operator[]( unsigned int index ) {
+	assert( index < numElements );
+	return *slot( index );
+}
+
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline const type &SegmentedList< type, BlockSize, AllocPolicy >::operator[]( size_t index ) const {
+	assert( index < numElements );
+	return *slot( index );
+}
+
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline type &SegmentedList< type, BlockSize, AllocPolicy >::operator[]( size_t index ) {
+	assert( index < numElements );
+	return *slot( index );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::append
+//
+// Returns a reference to a new default constructed element at the end of 
+// the list.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline type &SegmentedList< type, BlockSize, AllocPolicy >::append() {
+	allocateBlocks( numElements + 1 );
+	type* element = slot( numElements );
+	Memory::defaultConstruct( element, 1 );
+	numElements++;
+	return *element;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::append
+//
+// Increases the size of the list by one element and copies the supplied 
+// data into it. Existing elements never move.
+// Returns the index of the new element.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline int SegmentedList< type, BlockSize, AllocPolicy >::append( type const & obj ) {
+	allocateBlocks( numElements + 1 );
+	new( slot( numElements ) ) type( obj );
+	return (int)numElements++;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::append
+//
+// Moves the supplied element into a new slot at the end of the list.
+// Returns the index of the new element.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline int SegmentedList< type, BlockSize, AllocPolicy >::append( type&& obj ) {
+	allocateBlocks( numElements + 1 );
+	new( slot( numElements ) ) type( std::move( obj ) );
+	return (int)numElements++;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::appendRange
+//
+// Copies count elements to the end of the list, one block at a time.
+// Returns the index of the first appended element.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline int SegmentedList< type, BlockSize, AllocPolicy >::appendRange( const type* first, size_t count ) {
+	const size_t begin = numElements;
+	allocateBlocks( numElements + count );
+	while( numElements < begin + count ) {
+		const size_t blockEnd = ( numElements & ~( BlockSize - 1 ) ) + BlockSize;
+		const size_t end = blockEnd < begin + count ? blockEnd : begin + count;
+		Memory::copyConstruct( slot( numElements ), first + ( numElements - begin ), end - numElements );
+		numElements = end;
+	}
+	return (int)begin;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::emplace
+//
+// Constructs a new element at the end of the list, forwarding the given 
+// arguments to its constructor. Returns the index of the new element.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+template< typename... Args >
+inline int SegmentedList< type, BlockSize, AllocPolicy >::emplace( Args&&... args ) {
+	allocateBlocks( numElements + 1 );
+	new( slot( numElements ) ) type( std::forward< Args >( args )... );
+	return (int)numElements++;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::removeIndexFast
+//
+// Removes the element at the specified index, moving the last element into
+// its spot. Returns false if the index is out of range. Pointers to the 
+// other elements, but the last, remain valid.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline bool SegmentedList< type, BlockSize, AllocPolicy >::removeIndexFast( size_t index ) {
+	if ( index >= numElements ) {
+		return false;
+	}
+
+	if ( index != numElements - 1 ) {
+		*slot( index ) = std::move( *slot( numElements - 1 ) );
+	}
+	removeLast();
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::removeLast
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline void SegmentedList< type, BlockSize, AllocPolicy >::removeLast() {
+	assert( numElements > 0 );
+	numElements--;
+	Memory::destroy( slot( numElements ), 1 );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::swap
+//
+// Swaps the contents of two lists. Only the block tables are exchanged.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline void SegmentedList< type, BlockSize, AllocPolicy >::swap( SegmentedList &other ) {
+	std::swap( static_cast< AllocPolicy& >( *this ), static_cast< AllocPolicy& >( other ) );
+	std::swap( numElements, other.numElements );
+	blocks.swap( other.blocks );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::forEachBlock
+//
+// Calls f( elements, count ) for the contiguous run of elements in each 
+// block, which is the fastest way to visit every element.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+template< class Function >
+inline void SegmentedList< type, BlockSize, AllocPolicy >::forEachBlock( Function f ) {
+	for( size_t begin = 0, block = 0; begin < numElements; begin += BlockSize, block++ ) {
+		f( blocks[ block ], numElements - begin < BlockSize ? numElements - begin : BlockSize );
+	}
+}
+
+template< typename type, size_t BlockSize, class AllocPolicy >
+template< class Function >
+inline void SegmentedList< type, BlockSize, AllocPolicy >::forEachBlock( Function f ) const {
+	for( size_t begin = 0, block = 0; begin < numElements; begin += BlockSize, block++ ) {
+		f( static_cast< const type* >( blocks[ block ] ), numElements - begin < BlockSize ? numElements - begin : BlockSize );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::begin / end
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline typename SegmentedList< type, BlockSize, AllocPolicy >::Iterator SegmentedList< type, BlockSize, AllocPolicy >::begin() {
+	return Iterator( this, 0 );
+}
+
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline typename SegmentedList< type, BlockSize, AllocPolicy >::Iterator SegmentedList< type, BlockSize, AllocPolicy >::end() {
+	return Iterator( this, numElements );
+}
+
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline typename SegmentedList< type, BlockSize, AllocPolicy >::ConstIterator SegmentedList< type, BlockSize, AllocPolicy >::begin() const {
+	return ConstIterator( this, 0 );
+}
+
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline typename SegmentedList< type, BlockSize, AllocPolicy >::ConstIterator SegmentedList< type, BlockSize, AllocPolicy >::end() const {
+	return ConstIterator( this, numElements );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::slot
+//
+// Address of the given index, which must be within an allocated block.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline type* SegmentedList< type, BlockSize, AllocPolicy >::slot( size_t index ) const {
+	return blocks[ index / BlockSize ] + ( index & ( BlockSize - 1 ) );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedList< type, BlockSize, AllocPolicy >::allocateBlocks
+//
+// Allocates blocks until count elements fit. Only the block table may be 
+// reallocated, the elements themselves never move.
+//////////////////////////////////////////////////////////////////////////
+template< typename type, size_t BlockSize, class AllocPolicy >
+inline void SegmentedList< type, BlockSize, AllocPolicy >::allocateBlocks( size_t count ) {
+	while( blocks.size() * BlockSize < count ) {
+		type* block = AllocPolicy::allocRaw( BlockSize );
+		assert( block != NULL );
+		blocks.append( block );
+	}
+}
@@ -0,0 +1,217 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <assert.h>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <memory/alignment.h>
+#include <memory/standardAllocator.h>
+#include <memory/construct.h>
+#include <containers/list/growthPolicy.h>
+#include <containers/span/span.h>
+
+namespace CoreLib {
+
+	//////////////////////////////////////////////////////////////////////////
+	// SoaFields
+	//
+	// Field list of a SoaList, e.g. SoaFields< float, float, float, int >.
+	// Each field is stored in its own array, starting on a cache line 
+	// boundary (or the field alignment, if greater) and padded up to a whole
+	// number of cache lines.
+	//
+	// The static methods operate on every field array at once, given an array
+	// of pointers to the storage of each field.
+	//////////////////////////////////////////////////////////////////////////
+	template< typename... Fields >
+	struct SoaFields;
+
+	template<>
+	struct SoaFields<> {
+		static const size_t ARRAY_ALIGNMENT = Memory::CACHE_LINE_SIZE;
+		static const size_t NUM_FIELDS = 0;
+		static const size_t ALIGNMENT = ARRAY_ALIGNMENT;
+		static const size_t ROW_SIZE = 0;
+
+		static size_t layout( size_t*, size_t offset, size_t ) { return offset; }
+		static void relocate( void* const*, void* const*, size_t ) {}
+		static void copyConstruct( void* const*, const void* const*, size_t ) {}
+		static void defaultConstruct( void* const*, size_t, size_t ) {}
+		static void destroy( void* const*, size_t, size_t ) {}
+		static void moveElement( void* const*, size_t, size_t ) {}
+		static void construct( void* const*, size_t ) {}
+	};
+
+	template< typename F, typename... Rest >
+	struct SoaFields< F, Rest... > {
+		typedef SoaFields< Rest... > Next;
+
+		// type of the I-th field
+		template< size_t I >
+		struct Field {
+			typedef typename std::tuple_element< I, std::tuple< F, Rest... > >::type type;
+		};
+
+		static const size_t NUM_FIELDS = 1 + Next::NUM_FIELDS;
+		static const size_t FIELD_ALIGNMENT = std::alignment_of< F >::value > SoaFields<>::ARRAY_ALIGNMENT ? std::alignment_of< F >::value : SoaFields<>::ARRAY_ALIGNMENT;
+		static const size_t ALIGNMENT = FIELD_ALIGNMENT > Next::ALIGNMENT ? FIELD_ALIGNMENT : Next::ALIGNMENT;
+		static const size_t ROW_SIZE = sizeof( F ) + Next::ROW_SIZE;	// bytes per element across all the fields
+
+		// Fills in the offset of each field array for the given capacity, 
+		// starting at offset and assuming an ALIGNMENT aligned base address.
+		// Returns the end of the last array.
+		static size_t layout( size_t* offsets, size_t offset, size_t capacity ) {
+			offset = alignUp( offset, FIELD_ALIGNMENT );
+			offsets[ 0 ] = offset;
+			offset = alignUp( offset + capacity * sizeof( F ), SoaFields<>::ARRAY_ALIGNMENT );
+			return Next::layout( offsets + 1, offset, capacity );
+		}
+
+		// moves count elements from the src arrays into the uninitialized dst arrays
+		static void relocate( void* const* dst, void* const* src, size_t count ) {
+			Memory::relocate( static_cast< F* >( dst[ 0 ] ), static_cast< F* >( src[ 0 ] ), count );
+			Next::relocate( dst + 1, src + 1, count );
+		}
+
+		// copies count elements from the src arrays into the uninitialized dst arrays
+		static void copyConstruct( void* const* dst, const void* const* src, size_t count ) {
+			Memory::copyConstruct( static_cast< F* >( dst[ 0 ] ), static_cast< const F* >( src[ 0 ] ), count );
+			Next::copyConstruct( dst + 1, src + 1, count );
+		}
+
+		static void defaultConstruct( void* const* arrays, size_t first, size_t count ) {
+			Memory::defaultConstruct( static_cast< F* >( arrays[ 0 ] ) + first, count );
+			Next::defaultConstruct( arrays + 1, first, count );
+		}
+
+		static void destroy( void* const* arrays, size_t first, size_t count ) {
+			Memory::destroy( static_cast< F* >( arrays[ 0 ] ) + first, count );
+			Next::destroy( arrays + 1, first, count );
+		}
+
+		// move assigns the element at src over the element at dst
+		static void moveElement( void* const* arrays, size_t dst, size_t src ) {
+			F* field = static_cast< F* >( arrays[ 0 ] );
+			field[ dst ] = std::move( field[ src ] );
+			Next::moveElement( arrays + 1, dst, src );
+		}
+
+		// constructs the element at index from one value per field
+		template< typename V, typename... Vs >
+		static void construct( void* const* arrays, size_t index, V&& value, Vs&&... values ) {
+			new( static_cast< F* >( arrays[ 0 ] ) + index ) F( std::forward< V >( value ) );
+			Next::construct( arrays + 1, index, std::forward< Vs >( values )... );
+		}
+
+	private:
+		static size_t alignUp( size_t offset, size_t alignment ) {
+			return ( offset + alignment - 1 ) & ~( alignment - 1 );
+		}
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// class SoaList
+	//
+	// Structure of arrays counterpart of List: elements are made of the 
+	// fields in the Layout (see SoaFields), and each field is stored in its 
+	// own contiguous array, so loops touching only a few fields don't drag 
+	// the rest into the cache, and can run over plain aligned arrays, e.g.
+	//
+	//	enum { POSITION_X, VELOCITY_X, MASS };
+	//	SoaList< SoaFields< float, float, float > > particles;
+	//	particles.append( 0.0f, 1.0f, 2.0f );
+	//	Span< float > x = particles.field< POSITION_X >();
+	//	Span< const float > vx = particles.field< VELOCITY_X >();
+	//	for( size_t i = 0; i < x.size(); i++ ) x[ i ] += vx[ i ] * dt;
+	//
+	// All the arrays share a single allocation drawn from a byte allocator, 
+	// and grow together as dictated by the Growth policy (see 
+	// growthPolicy.h).
+	//////////////////////////////////////////////////////////////////////////
+	template< class Layout, class Allocator = CoreLib::Memory::StandardAllocator< unsigned char >, class Growth = FixedGrowth >
+	class SoaList : private Allocator {
+	public:
+		static const size_t NUM_FIELDS = Layout::NUM_FIELDS;
+
+		explicit SoaList( size_t granularity = DEFAULT_GRANULARITY );
+		explicit SoaList( const Allocator& allocator, size_t granularity = DEFAULT_GRANULARITY );
+		SoaList( const SoaList& other );
+		SoaList( SoaList&& other );
+		~SoaList();
+
+		size_t size() const;		// number of elements in the list
+		size_t capacity() const;	// total number of elements that can be stored without resizing the list
+		bool empty() const;
+
+		void clear();	// clears the list and storage
+		void resize( size_t newNum, bool resizeCapacity = true );	// set number of elements in list and resize to exactly this number if necessary
+		void preAllocate( size_t newCapacity ); // makes sure the list has capacity for newCapacity elements, without changing the current element count
+		void shrinkToFit();	// releases the unused capacity
+
+		void setGranularity( size_t granularity );
+		size_t getGranularity() const;
+
+		const Allocator& getAllocator() const;
+
+		SoaList&	operator=( const SoaList& other );
+		SoaList&	operator=( SoaList&& other );
+
+		int			append();							// append a default constructed element, returns its index
+		template< typename... Values >
+		int			append( Values&&... values );		// append an element from one value per field, returns its index
+
+		bool		removeIndexFast( size_t i );		// remove i-th element, move the last element into its spot
+		void		swap( SoaList& other );				// swap the contents of the lists
+
+		template< size_t I >
+		Span< typename Layout::template Field< I >::type >			field();			// array of the I-th field
+		template< size_t I >
+		Span< const typename Layout::template Field< I >::type >	field() const;
+
+		template< size_t I >
+		typename Layout::template Field< I >::type&					get( size_t index );	// I-th field of the element at index
+		template< size_t I >
+		const typename Layout::template Field< I >::type&			get( size_t index ) const;
+
+	private:
+		void setSize( size_t newSize );
+		void grow( size_t required );
+
+	private:
+		static_assert( NUM_FIELDS > 0, "a SoaList needs at least one field" );
+
+		size_t			numElements;
+		size_t			allocedSize;
+		size_t			granularity;
+		unsigned char*	storage;
+		size_t			storageSize;				// bytes allocated for storage
+		void*			arrays[ NUM_FIELDS ];		// start of each field array within storage
+		const static size_t DEFAULT_GRANULARITY = 16;
+	};
+
+	#include "soaList.inl"
+}
@@ -0,0 +1,434 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::SoaList( size_t )
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline SoaList< Layout, AllocPolicy, GrowthPolicy >::SoaList( size_t newgranularity )
+	:	numElements( 0 ),
+		allocedSize( 0 ),
+		granularity( newgranularity ),
+		storage( NULL ),
+		storageSize( 0 ) {
+	assert( granularity > 0 );
+	clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::SoaList( const AllocPolicy &, size_t )
+//
+// Creates an empty list drawing its storage from the given allocator.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline SoaList< Layout, AllocPolicy, GrowthPolicy >::SoaList( const AllocPolicy& allocator, size_t newgranularity )
+	:	AllocPolicy( allocator ),
+		numElements( 0 ),
+		allocedSize( 0 ),
+		granularity( newgranularity ),
+		storage( NULL ),
+		storageSize( 0 ) {
+	assert( granularity > 0 );
+	clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::SoaList( const SoaList &other )
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline SoaList< Layout, AllocPolicy, GrowthPolicy >::SoaList( const SoaList &other )
+	:	AllocPolicy( other ),
+		numElements( 0 ),
+		allocedSize( 0 ),
+		granularity( other.granularity ),
+		storage( NULL ),
+		storageSize( 0 ) {
+	clear();
+	*this = other;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::SoaList( SoaList &&other )
+//
+// Takes over the storage of the other list, which is left empty.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline SoaList< Layout, AllocPolicy, GrowthPolicy >::SoaList( SoaList &&other )
+	:	AllocPolicy( other ),
+		numElements( other.numElements ),
+		allocedSize( other.allocedSize ),
+		granularity( other.granularity ),
+		storage( other.storage ),
+		storageSize( other.storageSize ) {
+	for( size_t i = 0; i < NUM_FIELDS; i++ ) {
+		arrays[ i ] = other.arrays[ i ];
+		other.arrays[ i ] = NULL;
+	}
+	other.numElements = 0;
+	other.allocedSize = 0;
+	other.storage = NULL;
+	other.storageSize = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::~SoaList
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline SoaList< Layout, AllocPolicy, GrowthPolicy >::~SoaList() {
+	clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::clear
+//
+// Destroys the elements and frees up the storage.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline void SoaList< Layout, AllocPolicy, GrowthPolicy >::clear() {
+	if ( storage != NULL ) {
+		Layout::destroy( arrays, 0, numElements );
+		AllocPolicy::freeRaw( storage, storageSize );
+	}
+	for( size_t i = 0; i < NUM_FIELDS; i++ ) {
+		arrays[ i ] = NULL;
+	}
+	storage		= NULL;
+	storageSize	= 0;
+	numElements	= 0;
+	allocedSize	= 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::size
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline size_t SoaList< Layout, AllocPolicy, GrowthPolicy >::size() const {
+	return numElements;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::capacity
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline size_t SoaList< Layout, AllocPolicy, GrowthPolicy >::capacity() const {
+	return allocedSize;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::empty
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline bool SoaList< Layout, AllocPolicy, GrowthPolicy >::empty() const {
+	return numElements == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::resize
+//
+// Resize to the exact size specified irregardless of granularity. New 
+// elements are default constructed, and elements beyond the new size are 
+// destroyed.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline void SoaList< Layout, AllocPolicy, GrowthPolicy >::resize( size_t newnum, bool resize ) {
+	if ( newnum < numElements ) {
+		Layout::destroy( arrays, newnum, numElements - newnum );
+		numElements = newnum;
+	}
+	if ( resize || newnum > allocedSize ) {
+		setSize( newnum );
+	}
+	if ( newnum > numElements ) {
+		Layout::defaultConstruct( arrays, numElements, newnum - numElements );
+	}
+	numElements = newnum;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::preAllocate
+//
+// Makes sure the list has at least the given number of elements allocated
+// but don't actually change the number of items.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline void SoaList< Layout, AllocPolicy, GrowthPolicy >::preAllocate( size_t newSize ) {
+	if ( newSize > allocedSize ) {
+		newSize += granularity - 1;
+		newSize -= newSize % granularity;
+		setSize( newSize );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::shrinkToFit
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline void SoaList< Layout, AllocPolicy, GrowthPolicy >::shrinkToFit() {
+	setSize( numElements );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::setGranularity
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline void SoaList< Layout, AllocPolicy, GrowthPolicy >::setGranularity( size_t newgranularity ) {
+	assert( newgranularity > 0 );
+	granularity = newgranularity;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::getGranularity
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline size_t SoaList< Layout, AllocPolicy, GrowthPolicy >::getGranularity() const {
+	return granularity;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::getAllocator
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline const AllocPolicy& SoaList< Layout, AllocPolicy, GrowthPolicy >::getAllocator() const {
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::setSize
+//
+// Reallocates the field arrays to hold newSize elements, moving the 
+// existing elements into the new storage. Every array is carved out of a 
+// single allocation, padded so that the arrays can be aligned regardless 
+// of the alignment the allocator provides.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline void SoaList< Layout, AllocPolicy, GrowthPolicy >::setSize( size_t newSize ) {
+	if ( newSize == 0 ) {
+		clear();
+		return;
+	}
+
+	if ( newSize == allocedSize ) {
+		return;
+	}
+
+	if ( newSize < numElements ) {
+		// destroy the elements which won't fit in the new storage
+		Layout::destroy( arrays, newSize, numElements - newSize );
+		numElements = newSize;
+	}
+
+	size_t offsets[ NUM_FIELDS ];
+	const size_t newStorageSize = Layout::layout( offsets, 0, newSize ) + Layout::ALIGNMENT - 1;
+	unsigned char* newStorage = AllocPolicy::allocRaw( newStorageSize );
+	unsigned char* base = newStorage + ( ( Layout::ALIGNMENT - (uintptr_t)newStorage % Layout::ALIGNMENT ) % Layout::ALIGNMENT );
+
+	void* newArrays[ NUM_FIELDS ];
+	for( size_t i = 0; i < NUM_FIELDS; i++ ) {
+		newArrays[ i ] = base + offsets[ i ];
+	}
+
+	if ( storage != NULL ) {
+		Layout::relocate( newArrays, arrays, numElements );
+		AllocPolicy::freeRaw( storage, storageSize );
+	}
+
+	for( size_t i = 0; i < NUM_FIELDS; i++ ) {
+		arrays[ i ] = newArrays[ i ];
+	}
+	storage		= newStorage;
+	storageSize	= newStorageSize;
+	allocedSize	= newSize;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::grow
+//
+// Grows the storage to hold at least the required number of elements, as
+// dictated by the growth policy.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline void SoaList< Layout, AllocPolicy, GrowthPolicy >::grow( size_t required ) {
+	if ( required > allocedSize ) {
+		setSize( GrowthPolicy::grow( allocedSize, required, granularity, Layout::ROW_SIZE ) );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::operator=
+//
+// Copies the contents and granularity of another list. The list keeps its 
+// own allocator.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline SoaList< Layout, AllocPolicy, GrowthPolicy >& SoaList< Layout, AllocPolicy, GrowthPolicy >::operator=( const SoaList &other ) {
+	if ( &other == this ) {
+		return *this;
+	}
+
+	clear();
+
+	granularity = other.granularity;
+
+	if ( other.allocedSize ) {
+		setSize( other.allocedSize );
+		Layout::copyConstruct( arrays, other.arrays, other.numElements );
+		numElements = other.numElements;
+	}
+
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::operator=
+//
+// Takes over the storage, and allocator, of the other list, which is left 
+// empty.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline SoaList< Layout, AllocPolicy, GrowthPolicy >& SoaList< Layout, AllocPolicy, GrowthPolicy >::operator=( SoaList &&other ) {
+	if ( &other == this ) {
+		return *this;
+	}
+
+	clear();
+	swap( other );
+
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::append
+//
+// Appends a default constructed element. Returns its index.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline int SoaList< Layout, AllocPolicy, GrowthPolicy >::append() {
+	if ( numElements == allocedSize ) {
+		grow( numElements + 1 );
+	}
+
+	Layout::defaultConstruct( arrays, numElements, 1 );
+	return (int)numElements++;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::append
+//
+// Appends an element constructing each field from the matching value, 
+// e.g. append( x, y, z ) for a SoaFields< float, float, float > layout.
+// Returns the index of the new element.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+template< typename... Values >
+inline int SoaList< Layout, AllocPolicy, GrowthPolicy >::append( Values&&... values ) {
+	static_assert( sizeof...( Values ) == NUM_FIELDS, "append takes one value per field" );
+
+	if ( numElements == allocedSize ) {
+		grow( numElements + 1 );
+	}
+
+	Layout::construct( arrays, numElements, std::forward< Values >( values )... );
+	return (int)numElements++;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::removeIndexFast
+//
+// Removes the element at the specified index and moves the last element 
+// into its spot, field by field. This doesn't maintain the order of 
+// elements. Returns false if the index is outside the bounds of the list.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline bool SoaList< Layout, AllocPolicy, GrowthPolicy >::removeIndexFast( size_t index ) {
+	assert( index < numElements );
+
+	if ( index >= numElements ) {
+		return false;
+	}
+
+	numElements--;
+
+	if ( index != numElements ) {
+		Layout::moveElement( arrays, index, numElements );
+	}
+
+	Layout::destroy( arrays, numElements, 1 );
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::swap
+//
+// Swaps the contents of two lists.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+inline void SoaList< Layout, AllocPolicy, GrowthPolicy >::swap( SoaList &other ) {
+	std::swap( static_cast< AllocPolicy& >( *this ), static_cast< AllocPolicy& >( other ) );
+	std::swap( numElements, other.numElements );
+	std::swap( allocedSize, other.allocedSize );
+	std::swap( granularity, other.granularity );
+	std::swap( storage, other.storage );
+	std::swap( storageSize, other.storageSize );
+	for( size_t i = 0; i < NUM_FIELDS; i++ ) {
+		std::swap( arrays[ i ], other.arrays[ i ] );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::field
+//
+// Returns the array of the I-th field. Its start is aligned to at least a 
+// cache line. The span is invalidated by any change in the list capacity.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+template< size_t I >
+inline Span< typename Layout::template Field< I >::type > SoaList< Layout, AllocPolicy, GrowthPolicy >::field() {
+	typedef typename Layout::template Field< I >::type FieldType;
+	return Span< FieldType >( static_cast< FieldType* >( arrays[ I ] ), numElements );
+}
+
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+template< size_t I >
+inline Span< const typename Layout::template Field< I >::type > SoaList< Layout, AllocPolicy, GrowthPolicy >::field() const {
+	typedef typename Layout::template Field< I >::type FieldType;
+	return Span< const FieldType >( static_cast< const FieldType* >( arrays[ I ] ), numElements );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SoaList< Layout, AllocPolicy, GrowthPolicy >::get
+//
+// Returns the I-th field of the element at index.
+//////////////////////////////////////////////////////////////////////////
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+template< size_t I >
+inline typename Layout::template Field< I >::type& SoaList< Layout, AllocPolicy, GrowthPolicy >::get( size_t index ) {
+	assert( index < numElements );
+	return static_cast< typename Layout::template Field< I >::type* >( arrays[ I ] )[ index ];
+}
+
+template< class Layout, class AllocPolicy, class GrowthPolicy >
+template< size_t I >
+inline const typename Layout::template Field< I >::type& SoaList< Layout, AllocPolicy, GrowthPolicy >::get( size_t index ) const {
+	assert( index < numElements );
+	return static_cast< const typename Layout::template Field< I >::type* >( arrays[ I ] )[ index ];
+}
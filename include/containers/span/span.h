@@ -0,0 +1,69 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <assert.h>
+#include <type_traits>
+
+namespace CoreLib {
+
+	//////////////////////////////////////////////////////////////////////////
+	// class Span
+	//
+	// Non owning view over count contiguous elements, e.g. one of the field 
+	// arrays of a SoaList. Spans are only valid as long as the storage they 
+	// point to isn't reallocated.
+	//////////////////////////////////////////////////////////////////////////
+	template< typename T >
+	class Span {
+	public:
+		typedef T		Type;
+		typedef T*		Iterator;
+
+		Span() : ptr( NULL ), count( 0 ) {}
+		Span( T* data, size_t count ) : ptr( data ), count( count ) {}
+
+		// Span< T > converts to Span< const T >
+		template< typename U, class = typename std::enable_if< std::is_convertible< U(*)[], T(*)[] >::value >::type >
+		Span( const Span< U >& other ) : ptr( other.data() ), count( other.size() ) {}
+
+		size_t		size() const { return count; }
+		bool		empty() const { return count == 0; }
+		T*			data() const { return ptr; }
+
+		T&			operator[]( size_t index ) const { assert( index < count ); return ptr[ index ]; }
+
+		Iterator	begin() const { return ptr; }
+		Iterator	end() const { return ptr + count; }
+
+		// view over count elements starting at first
+		Span		subSpan( size_t first, size_t subCount ) const {
+			assert( first <= count && subCount <= count - first );
+			return Span( ptr + first, subCount );
+		}
+
+	private:
+		T*		ptr;
+		size_t	count;
+	};
+}
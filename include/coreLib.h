@@ -24,7 +24,43 @@
 
 #define WIN32_LEAN_AND_MEAN
 
+#include "algorithms/kernels.h"
+#include "algorithms/parallel.h"
+#include "algorithms/parallelSort.h"
+#include "algorithms/sort.h"
+
+#include "containers/concurrentList/concurrentList.h"
+#include "containers/hashIndex/hashIndex.h"
+#include "containers/list/indexedList.h"
 #include "containers/list/list.h"
+#include "containers/list/listFile.h"
+#include "containers/list/listStream.h"
+#include "containers/list/mappedList.h"
+#include "containers/list/smallList.h"
+#include "containers/queue/mpmcQueue.h"
+#include "containers/queue/spscQueue.h"
+#include "containers/segmentedList/segmentedList.h"
+#include "containers/soa/soaList.h"
+#include "containers/span/span.h"
+
+#include "jobs/jobSystem.h"
 
+#include "memory/alignedAllocator.h"
+#include "memory/alignment.h"
+#include "memory/allocatorTraits.h"
+#include "memory/arena.h"
+#include "memory/concurrentPool.h"
+#include "memory/construct.h"
+#include "memory/inlineAllocator.h"
 #include "memory/standardAllocator.h"
-#include "memory/staticPool.h"
\ No newline at end of file
+#include "memory/mappedAllocator.h"
+#include "memory/mappedFile.h"
+#include "memory/objectPool.h"
+#include "memory/poolAllocator.h"
+#include "memory/slabPool.h"
+#include "memory/staticPool.h"
+#include "memory/threadCachingPool.h"
+#include "memory/virtualMemoryPool.h"
+
+#include "stats/counters.h"
+#include "stats/stats.h"
\ No newline at end of file
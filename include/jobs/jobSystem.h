@@ -0,0 +1,223 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <assert.h>
+#include <iostream>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <memory/construct.h>
+#include <memory/staticPool.h>
+
+namespace CoreLib {
+namespace Jobs {
+
+	class JobCounter;
+
+	////////////////////////////////////////////////////////////////////////////
+	// struct Job
+	//
+	// A scheduled functor. Functors fitting the inline storage (which holds 
+	// a few captured pointers and indices) are stored in place, bigger ones
+	// on the heap. Jobs are only handled by the JobSystem.
+	////////////////////////////////////////////////////////////////////////////
+	struct Job {
+		typedef void ( *Function )( Job* job );
+
+		static const size_t STORAGE_SIZE = 96;
+		static const size_t STORAGE_ALIGNMENT = 16;
+
+		Function		execute;	// runs and destroys the functor
+		JobCounter*		counter;	// signaled once the job is done
+		Job*			next;		// link in the continuation and submission lists
+		typename std::aligned_storage< STORAGE_SIZE, STORAGE_ALIGNMENT >::type storage;
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// class JobCounter
+	//
+	// Number of unfinished jobs started against it. Threads wait on counters
+	// (JobSystem::wait), and jobs can be made to start only once a counter
+	// is done, so counters are the dependencies between groups of jobs.
+	//
+	// A counter can be reused once done. It must not be destroyed while it
+	// has jobs pending.
+	////////////////////////////////////////////////////////////////////////////
+	class JobCounter {
+	public:
+		JobCounter() : pending( 0 ), continuations( NULL ) {}
+		~JobCounter();
+
+		bool isDone() const { return pending.load( std::memory_order_acquire ) == 0; }
+
+	private:
+		JobCounter( const JobCounter& );
+		JobCounter& operator=( const JobCounter& );
+
+		friend class JobSystem;
+
+		std::atomic< size_t >	pending;
+		std::mutex				mutex;			// held while the counter reaches zero, and while adding continuations
+		Job*					continuations;	// jobs waiting for the counter to be done
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// class JobSystem
+	//
+	// Work stealing job scheduler. Each worker thread owns a deque of jobs:
+	// it pushes and pops the jobs it starts at one end, while idle workers 
+	// steal the oldest jobs from the other end, so that recursively split 
+	// work spreads across the threads in large pieces.
+	//
+	// The thread creating the system becomes worker 0 and takes part in the
+	// work while it waits; numThreads - 1 more threads are started. Other 
+	// threads may start jobs and wait on them too, but only block while they
+	// wait. With a single thread, jobs only run while worker 0 waits.
+	//
+	//	JobCounter counter;
+	//	jobs.run( [ & ]() { ... }, counter );
+	//	jobs.run( [ & ]() { ... }, counter );
+	//	jobs.wait( counter );	// runs pending jobs until both are done
+	//
+	// Every worker owns a scratch MemoryPool, which is rewound after each job
+	// (see ScratchAllocator), for temporary allocations without locking. The
+	// jobs a worker runs while waiting allocate on top of the waiting job's
+	// scratch memory, so deeply nested waits need larger pools.
+	//
+	// The system is also an executor for the parallel algorithms (see 
+	// parallelSort.h), and its destructor must run on the creating thread
+	// once every job is done.
+	////////////////////////////////////////////////////////////////////////////
+	class JobSystem {
+	public:
+		struct Worker;
+
+		static const size_t DEFAULT_SCRATCH_BYTES = 256 * 1024;
+
+		explicit JobSystem( size_t numThreads = 0, size_t scratchBytes = DEFAULT_SCRATCH_BYTES ); // 0 uses every hardware thread
+		~JobSystem();
+
+		size_t	getConcurrency() const { return numWorkers; }
+
+		template< class Function >
+		void	run( Function&& function, JobCounter& counter );							// starts function(), counted by counter
+		template< class Function >
+		void	run( Function&& function, JobCounter& counter, JobCounter& dependency );	// starts function() once dependency is done
+
+		void	wait( JobCounter& counter );	// returns once the counter is done, running jobs meanwhile on worker threads
+
+		template< class Function >
+		void	parallelFor( size_t count, Function function );		// calls function( i ) for every i in [0, count)
+		template< class Function >
+		void	parallelForRange( size_t begin, size_t end, size_t grain, Function function );	// calls function( first, last ) over subranges of at most grain elements
+		size_t	autoGrain( size_t count, size_t minGrain = 1 ) const;	// subrange size giving every worker a few pieces to balance
+
+		static Memory::MemoryPool*	getScratchPool();	// scratch pool of the calling worker, NULL on other threads
+
+	private:
+		JobSystem( const JobSystem& );
+		JobSystem& operator=( const JobSystem& );
+
+		template< class Functor >
+		static void	runInline( Job* job );
+		template< class Functor >
+		static void	runOnHeap( Job* job );
+		template< class Function >
+		Job*		createJob( Function&& function, JobCounter& counter, std::true_type /* fits */ );
+		template< class Function >
+		Job*		createJob( Function&& function, JobCounter& counter, std::false_type /* fits */ );
+		template< class Function >
+		void		splitRange( size_t begin, size_t end, size_t grain, Function& function, JobCounter& counter );
+
+		Job*		allocateJob( JobCounter& counter );
+		void		submit( Job* job );
+		void		schedule( Job* job, JobCounter& dependency );
+		void		execute( Job* job, Worker* worker );
+		void		finish( JobCounter* counter );
+		Job*		findJob( Worker* worker );
+		Job*		popSubmitted();
+		bool		hasWork() const;
+		void		wakeWorker();
+		void		workerLoop( Worker* worker );
+		Worker*		getCurrentWorker() const;
+
+	private:
+		static const size_t GRAIN_PIECES_PER_WORKER = 8;
+
+		size_t						numWorkers;
+		Worker**					workers;
+		std::vector< std::thread >	threads;
+		Worker*						previousWorker;		// of the creating thread, if it was a worker of another system
+
+		// jobs started by threads other than the workers
+		std::mutex					submitMutex;
+		Job*						submittedHead;
+		Job*						submittedTail;
+		std::atomic< size_t >		numSubmitted;
+
+		// idle workers
+		std::mutex					sleepMutex;
+		std::condition_variable		sleepCondition;
+		std::atomic< size_t >		numSleeping;
+		bool						stopping;
+
+		// other threads blocked in wait
+		std::mutex					waitMutex;
+		std::condition_variable		waitCondition;
+		std::atomic< size_t >		numWaiting;
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// class ScratchAllocator
+	//
+	// Allocator policy drawing from the scratch pool of the calling worker, 
+	// like StaticMemoryPool does from its process-wide pool. Memory is never
+	// freed individually, it is released when the job using it returns, so
+	// containers using it must not outlive the job. Allocating outside the 
+	// workers fails.
+	////////////////////////////////////////////////////////////////////////////
+	struct ScratchPoolSource {
+		static Memory::MemoryPool* currentPool() {
+			Memory::MemoryPool* pool = JobSystem::getScratchPool();
+			if ( pool == NULL ) {
+				std::cerr << "Scratch memory can only be allocated from job system workers" << std::endl;
+				assert( false );
+			}
+			return pool;
+		}
+	};
+
+	template< class T, int alignment = 4 >
+	class ScratchAllocator : public Memory::SourcedPoolAllocator< T, ScratchPoolSource, alignment > {
+	};
+
+	#include "jobSystem.inl"
+
+} // namespace Jobs
+} // namespace CoreLib
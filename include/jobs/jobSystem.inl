@@ -0,0 +1,156 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// JobSystem::run
+//
+// Starts the job on the calling worker's deque, or hands it to the workers 
+// when called from another thread.
+//////////////////////////////////////////////////////////////////////////
+template< class Function >
+inline void JobSystem::run( Function&& function, JobCounter& counter ) {
+	typedef typename std::decay< Function >::type Functor;
+	typedef std::integral_constant< bool, sizeof( Functor ) <= Job::STORAGE_SIZE && std::alignment_of< Functor >::value <= Job::STORAGE_ALIGNMENT > Fits;
+	submit( createJob( std::forward< Function >( function ), counter, Fits() ) );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// JobSystem::run( Function&&, JobCounter&, JobCounter& )
+//
+// The job is counted right away, but only started once dependency is done.
+//////////////////////////////////////////////////////////////////////////
+template< class Function >
+inline void JobSystem::run( Function&& function, JobCounter& counter, JobCounter& dependency ) {
+	typedef typename std::decay< Function >::type Functor;
+	typedef std::integral_constant< bool, sizeof( Functor ) <= Job::STORAGE_SIZE && std::alignment_of< Functor >::value <= Job::STORAGE_ALIGNMENT > Fits;
+	schedule( createJob( std::forward< Function >( function ), counter, Fits() ), dependency );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// JobSystem::parallelFor
+//////////////////////////////////////////////////////////////////////////
+template< class Function >
+inline void JobSystem::parallelFor( size_t count, Function function ) {
+	parallelForRange( 0, count, autoGrain( count ), [ &function ]( size_t first, size_t last ) {
+		for( size_t i = first; i < last; i++ ) {
+			function( i );
+		}
+	} );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// JobSystem::parallelForRange
+//
+// The range is split in halves recursively, starting the upper half as a 
+// job and carrying on with the lower one, so idle workers steal the largest
+// pieces left. Returns once every subrange is done, with the scratch memory
+// they used released. Calls from outside the workers run as a job, so the 
+// function always runs on a worker.
+//////////////////////////////////////////////////////////////////////////
+template< class Function >
+inline void JobSystem::parallelForRange( size_t begin, size_t end, size_t grain, Function function ) {
+	if ( begin >= end ) {
+		return;
+	}
+	if ( grain == 0 ) {
+		grain = 1;
+	}
+
+	JobCounter counter;
+	if ( getCurrentWorker() != NULL ) {
+		// the pieces run here use the caller's scratch memory, as a job would
+		Memory::MemoryPool* scratch = getScratchPool();
+		const size_t marker = scratch->mark();
+		splitRange( begin, end, grain, function, counter );
+		wait( counter );
+		scratch->rewind( marker );
+	} else {
+		run( [ this, begin, end, grain, &function, &counter ]() {
+			splitRange( begin, end, grain, function, counter );
+		}, counter );
+		wait( counter );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// JobSystem::splitRange
+//////////////////////////////////////////////////////////////////////////
+template< class Function >
+inline void JobSystem::splitRange( size_t begin, size_t end, size_t grain, Function& function, JobCounter& counter ) {
+	while ( end - begin > grain ) {
+		const size_t middle = begin + ( end - begin ) / 2;
+		run( [ this, middle, end, grain, &function, &counter ]() {
+			splitRange( middle, end, grain, function, counter );
+		}, counter );
+		end = middle;
+	}
+	function( begin, end );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// JobSystem::runInline
+//////////////////////////////////////////////////////////////////////////
+template< class Functor >
+inline void JobSystem::runInline( Job* job ) {
+	Functor* functor = reinterpret_cast< Functor* >( &job->storage );
+	( *functor )();
+	functor->~Functor();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// JobSystem::runOnHeap
+//////////////////////////////////////////////////////////////////////////
+template< class Functor >
+inline void JobSystem::runOnHeap( Job* job ) {
+	Functor* functor = *reinterpret_cast< Functor** >( &job->storage );
+	( *functor )();
+	delete functor;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// JobSystem::createJob
+//
+// Stores the functor in the job.
+//////////////////////////////////////////////////////////////////////////
+template< class Function >
+inline Job* JobSystem::createJob( Function&& function, JobCounter& counter, std::true_type /* fits */ ) {
+	typedef typename std::decay< Function >::type Functor;
+	Job* job = allocateJob( counter );
+	new( &job->storage ) Functor( std::forward< Function >( function ) );
+	job->execute = &runInline< Functor >;
+	return job;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// JobSystem::createJob
+//
+// Stores a pointer to a heap allocated copy of the functor, too big for the 
+// job storage.
+//////////////////////////////////////////////////////////////////////////
+template< class Function >
+inline Job* JobSystem::createJob( Function&& function, JobCounter& counter, std::false_type /* fits */ ) {
+	typedef typename std::decay< Function >::type Functor;
+	Job* job = allocateJob( counter );
+	new( &job->storage ) Functor*( new Functor( std::forward< Function >( function ) ) );
+	job->execute = &runOnHeap< Functor >;
+	return job;
+}
@@ -0,0 +1,75 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <type_traits>
+#include <memory/alignment.h>
+#include <memory/construct.h>
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// AlignedAllocator
+	//
+	// Heap allocator policy whose allocations start on an Alignment boundary 
+	// (or the alignment of T, if greater) and are padded up to a multiple of
+	// it, so that with the default cache line alignment no two allocations 
+	// ever share a cache line. Useful for SIMD buffers and for data written 
+	// by different threads, e.g.
+	//
+	//	List< float, AlignedAllocator< float, 32 > > samples;	// AVX aligned
+	//	List< Counter, AlignedAllocator< Counter > > perThread;	// no false sharing with other lists
+	////////////////////////////////////////////////////////////////////////////
+	template< class T, size_t Alignment = CACHE_LINE_SIZE >
+	class AlignedAllocator {
+	public:
+		static T* alloc( size_t count ) {
+			T* ptr = allocRaw( count );
+			defaultConstruct( ptr, count );
+			return ptr;
+		}
+
+		static void free( T* objects, size_t count ) {
+			if ( objects != NULL ) {
+				destroy( objects, count );
+				freeRaw( objects, count );
+			}
+		}
+
+		static T* allocRaw( size_t count ) {
+			return static_cast< T* >( alignedAlloc( alignUp( count * sizeof( T ), ALIGNMENT ), ALIGNMENT ) );
+		}
+
+		static void freeRaw( T* ptr, size_t /*count*/ ) {
+			alignedFree( ptr, ALIGNMENT );
+		}
+
+		static const size_t ALIGNMENT = Alignment > std::alignment_of< T >::value ? Alignment : std::alignment_of< T >::value;
+
+	private:
+		static_assert( ( Alignment & ( Alignment - 1 ) ) == 0 && Alignment > 0, "the alignment must be a power of two" );
+	};
+
+} // namespace Memory
+} // namespace CoreLib
@@ -0,0 +1,105 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <cstddef>
+#include <stdlib.h>
+#include <assert.h>
+#include <new>
+#include <type_traits>
+#if defined( _MSC_VER )
+#include <malloc.h>
+#endif
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// Alignment helpers
+	//
+	// Alignments are always powers of two. CACHE_LINE_SIZE is the alignment 
+	// to use for data which must not share a cache line with anything else 
+	// (e.g. to avoid false sharing between threads), and DEFAULT_ALIGNMENT the
+	// one malloc and operator new already guarantee.
+	////////////////////////////////////////////////////////////////////////////
+	static const size_t CACHE_LINE_SIZE = 64;
+	static const size_t DEFAULT_ALIGNMENT = std::alignment_of< std::max_align_t >::value;
+
+	inline bool isPowerOfTwo( size_t value ) {
+		return value != 0 && ( value & ( value - 1 ) ) == 0;
+	}
+
+	// rounds value up to a multiple of alignment
+	inline size_t alignUp( size_t value, size_t alignment ) {
+		assert( isPowerOfTwo( alignment ) );
+		return ( value + alignment - 1 ) & ~( alignment - 1 );
+	}
+
+	// rounds ptr up to the next address multiple of alignment
+	template< typename T >
+	inline T* alignPointer( T* ptr, size_t alignment ) {
+		return reinterpret_cast< T* >( alignUp( reinterpret_cast< uintptr_t >( ptr ), alignment ) );
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// alignedAlloc / alignedFree
+	//
+	// Heap allocation starting at the given alignment, throwing std::bad_alloc
+	// if it can't be served like operator new does. Memory must be released 
+	// with alignedFree, passing the same alignment. Alignments the heap 
+	// already provides go straight to operator new.
+	////////////////////////////////////////////////////////////////////////////
+	inline void* alignedAlloc( size_t bytes, size_t alignment ) {
+		assert( isPowerOfTwo( alignment ) );
+		if ( alignment <= DEFAULT_ALIGNMENT ) {
+			return ::operator new( bytes );
+		}
+#if defined( _MSC_VER )
+		void* ptr = _aligned_malloc( bytes > 0 ? bytes : 1, alignment );
+#else
+		void* ptr = NULL;
+		if ( posix_memalign( &ptr, alignment < sizeof( void* ) ? sizeof( void* ) : alignment, bytes > 0 ? bytes : 1 ) != 0 ) {
+			ptr = NULL;
+		}
+#endif
+		if ( ptr == NULL ) {
+			throw std::bad_alloc();
+		}
+		return ptr;
+	}
+
+	inline void alignedFree( void* ptr, size_t alignment ) {
+		if ( alignment <= DEFAULT_ALIGNMENT ) {
+			::operator delete( ptr );
+			return;
+		}
+#if defined( _MSC_VER )
+		_aligned_free( ptr );
+#else
+		::free( ptr );
+#endif
+	}
+
+} // namespace Memory
+} // namespace CoreLib
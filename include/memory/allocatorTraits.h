@@ -0,0 +1,100 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <type_traits>
+#include <utility>
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// AllocatorTraits
+	//
+	// Gives access to the optional methods of the allocator policies, 
+	// falling back to a default behavior for the policies which don't 
+	// implement them:
+	//
+	//	T*		reallocRaw( ptr, oldCount, newCount )	resizes raw storage in place
+	//	size_t	inlineCapacity()						elements stored within the allocator itself
+	//	bool	isInline( ptr )							whether ptr is the allocator's own storage
+	////////////////////////////////////////////////////////////////////////////
+	template< class Allocator, class T >
+	class AllocatorTraits {
+	private:
+		template< class U > 
+		static auto testReallocRaw( int ) -> decltype( std::declval< U& >().reallocRaw( (T*)NULL, size_t(), size_t() ), std::true_type() );
+		template< class U > 
+		static std::false_type testReallocRaw( ... );
+		template< class U > 
+		static auto testIsInline( int ) -> decltype( std::declval< const U& >().isInline( (const T*)NULL ), std::true_type() );
+		template< class U > 
+		static std::false_type testIsInline( ... );
+
+	public:
+		static const bool hasReallocRaw = decltype( testReallocRaw< Allocator >( 0 ) )::value;
+		static const bool hasInlineStorage = decltype( testIsInline< Allocator >( 0 ) )::value;
+
+		// Resizes the raw storage returned by allocRaw, moving the objects 
+		// bitwise, so it must only be used with relocatable types. Returns 
+		// NULL if the policy can't resize the storage, in which case the 
+		// original storage is left untouched.
+		inline static T* reallocRaw( Allocator& allocator, T* ptr, size_t oldCount, size_t newCount ) {
+			return reallocRaw( allocator, ptr, oldCount, newCount, std::integral_constant< bool, hasReallocRaw >() );
+		}
+
+		// Number of elements the allocator can hand out from storage living 
+		// within the allocator object itself (see InlineAllocator). Such 
+		// storage can't be handed over to another container along with the 
+		// allocator, its elements must be moved instead.
+		inline static size_t inlineCapacity( const Allocator& allocator ) {
+			return inlineCapacity( allocator, std::integral_constant< bool, hasInlineStorage >() );
+		}
+
+		inline static bool isInline( const Allocator& allocator, const T* ptr ) {
+			return isInline( allocator, ptr, std::integral_constant< bool, hasInlineStorage >() );
+		}
+
+	private:
+		inline static T* reallocRaw( Allocator& allocator, T* ptr, size_t oldCount, size_t newCount, std::true_type ) {
+			return allocator.reallocRaw( ptr, oldCount, newCount );
+		}
+		inline static T* reallocRaw( Allocator&, T*, size_t, size_t, std::false_type ) {
+			return NULL;
+		}
+		inline static size_t inlineCapacity( const Allocator& allocator, std::true_type ) {
+			return allocator.inlineCapacity();
+		}
+		inline static size_t inlineCapacity( const Allocator&, std::false_type ) {
+			return 0;
+		}
+		inline static bool isInline( const Allocator& allocator, const T* ptr, std::true_type ) {
+			return allocator.isInline( ptr );
+		}
+		inline static bool isInline( const Allocator&, const T*, std::false_type ) {
+			return false;
+		}
+	};
+
+} // namespace Memory
+} // namespace CoreLib
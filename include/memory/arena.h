@@ -0,0 +1,112 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// class Arena
+	// Bump allocator which never runs out of memory: when the current block 
+	// fills up a new one is chained after it. Blocks are kept around when 
+	// the arena is cleared or rewound, so that steady-state usage (e.g. per 
+	// frame scratch memory) stops hitting the system allocator after warming
+	// up.
+	//
+	// mark() and rewind() give cheap nested scratch scopes, and ArenaScope 
+	// does the same with RAII:
+	//
+	//	{
+	//		ArenaScope scope( arena );
+	//		List< int, PoolAllocator< int, Arena > > temp( arena );
+	//		...
+	//	} // everything allocated within the scope is released here
+	////////////////////////////////////////////////////////////////////////////
+
+	class Arena {
+	private:
+		struct Block;
+
+	public:
+		// position within the arena to rewind to
+		class Marker {
+		private:
+			friend class Arena;
+			Block*	block;
+			size_t	used;
+		};
+
+		explicit Arena( size_t blockSize = DEFAULT_BLOCK_SIZE );
+		~Arena();
+
+		void* allocBytes( size_t bytes, size_t alignment );
+		void freeBytes( void* /*ptr*/, size_t /*bytes*/ ) { /* do nothing */ }
+
+		Marker mark() const;					// current position in the arena
+		void rewind( const Marker& marker );	// releases everything allocated after the marker was taken
+
+		void clearMemory( bool keepBlocks = true ); // releases every allocation, keeping the blocks for reuse unless told otherwise
+		void destroy();								// releases every allocation and block
+
+		void setBlockSize( size_t blockSize );	// size of the blocks allocated from now on
+		size_t getBlockSize() const { return blockSize; }
+
+		size_t getUsed() const;		// bytes handed out, including alignment padding
+		size_t getReserved() const;	// bytes held in blocks
+
+	private:
+		Arena( const Arena& );
+		Arena& operator=( const Arena& );
+
+		Block* nextBlock( size_t minSize );
+
+	private:
+		static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+		size_t	blockSize;
+		Block*	first;
+		Block*	current;
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// class ArenaScope
+	// Marks the arena on construction and rewinds it on destruction.
+	////////////////////////////////////////////////////////////////////////////
+
+	class ArenaScope {
+	public:
+		explicit ArenaScope( Arena& arena ) : arena( arena ), marker( arena.mark() ) {}
+		~ArenaScope() { arena.rewind( marker ); }
+
+	private:
+		ArenaScope( const ArenaScope& );
+		ArenaScope& operator=( const ArenaScope& );
+
+	private:
+		Arena&			arena;
+		Arena::Marker	marker;
+	};
+
+} // namespace Memory
+} // namespace CoreLib
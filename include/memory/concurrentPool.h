@@ -0,0 +1,78 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <atomic>
+#include <memory/staticPool.h>
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// class ConcurrentMemoryPool
+	// Thread safe version of MemoryPool: the bump pointer is advanced with an 
+	// atomic fetch-add, so any number of threads can allocate from the same 
+	// pool without locks.
+	//
+	// Threads doing many small allocations can instead carve a private chunk 
+	// out of the pool, and bump allocate from it without any atomic at all.
+	//
+	// init, destroy and clearMemory are not thread safe, and must not be 
+	// called while other threads are allocating.
+	////////////////////////////////////////////////////////////////////////////
+
+	class ConcurrentMemoryPool {
+	public:
+		ConcurrentMemoryPool();
+		explicit ConcurrentMemoryPool( size_t poolSize );
+		~ConcurrentMemoryPool();
+
+		void init( size_t poolSize );
+		void destroy();
+
+		void clearMemory(); // Wipes the memory chunk without freeing the memory and resets the allocator internal state. Call this before reusing the pool.
+
+		void* allocBytes( size_t bytes, size_t alignment );
+		void freeBytes( void* /*ptr*/, size_t /*bytes*/ ) { /* do nothing */ }
+
+		bool carve( size_t bytes, MemoryPool& chunk ); // reserves a chunk of the pool and attaches the given (thread private) pool to it
+
+		size_t getSize() const { return size; }
+		size_t getUsed() const;
+
+	private:
+		ConcurrentMemoryPool( const ConcurrentMemoryPool& );
+		ConcurrentMemoryPool& operator=( const ConcurrentMemoryPool& );
+
+	private:
+		// every allocation is padded to this size, so that allocations with
+		// lower alignment requirements never need any padding
+		static const size_t BASE_ALIGNMENT = 16;
+
+		char*					memory;
+		size_t					size;
+		std::atomic< size_t >	used;
+	};
+
+} // namespace Memory
+} // namespace CoreLib
@@ -0,0 +1,114 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <string.h>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// IsRelocatable
+	//
+	// Types which can be moved to a new address with a plain memcpy, leaving 
+	// the source memory to be released without running its destructor. This 
+	// holds for any trivially copyable type, and can be opted in for other 
+	// types (e.g. a List, which only owns a pointer to its storage) with the 
+	// CORELIB_DECLARE_RELOCATABLE macro, used from the global namespace.
+	////////////////////////////////////////////////////////////////////////////
+	template< typename T >
+	struct IsRelocatable {
+		static const bool value = std::is_trivially_copyable< T >::value;
+	};
+
+	#define CORELIB_DECLARE_RELOCATABLE( T ) \
+		namespace CoreLib { namespace Memory { \
+			template<> struct IsRelocatable< T > { static const bool value = true; }; \
+		} }
+
+	////////////////////////////////////////////////////////////////////////////
+	// Construction helpers
+	//
+	// Operate on raw, uninitialized storage as returned by the allocRaw 
+	// method of the allocator policies. 
+	////////////////////////////////////////////////////////////////////////////
+
+	// default constructs count objects. Note that, like new T[ count ], 
+	// POD types are left uninitialized.
+	template< typename T >
+	inline void defaultConstruct( T* dst, size_t count ) {
+		if ( std::is_trivially_default_constructible< T >::value ) {
+			return;
+		}
+		for( size_t i = 0; i < count; i++ ) {
+			new( dst + i ) T;
+		}
+	}
+
+	// copy constructs count objects from src into the uninitialized dst
+	template< typename T >
+	inline void copyConstruct( T* dst, const T* src, size_t count ) {
+		if ( std::is_trivially_copyable< T >::value ) {
+			if ( count > 0 ) {
+				memcpy( (void*)dst, (const void*)src, count * sizeof( T ) );
+			}
+			return;
+		}
+		for( size_t i = 0; i < count; i++ ) {
+			new( dst + i ) T( src[ i ] );
+		}
+	}
+
+	// destroys count objects, leaving the storage uninitialized
+	template< typename T >
+	inline void destroy( T* objects, size_t count ) {
+		if ( std::is_trivially_destructible< T >::value ) {
+			return;
+		}
+		for( size_t i = 0; i < count; i++ ) {
+			objects[ i ].~T();
+		}
+	}
+
+	// moves count objects from src into the uninitialized dst, and destroys 
+	// the source objects. Relocatable types are moved with a single memcpy.
+	// The ranges must not overlap.
+	template< typename T >
+	inline void relocate( T* dst, T* src, size_t count ) {
+		if ( IsRelocatable< T >::value ) {
+			if ( count > 0 ) {
+				memcpy( (void*)dst, (const void*)src, count * sizeof( T ) );
+			}
+			return;
+		}
+		for( size_t i = 0; i < count; i++ ) {
+			new( dst + i ) T( std::move( src[ i ] ) );
+			src[ i ].~T();
+		}
+	}
+
+} // namespace Memory
+} // namespace CoreLib
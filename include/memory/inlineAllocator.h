@@ -0,0 +1,115 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <assert.h>
+#include <type_traits>
+#include <memory/allocatorTraits.h>
+#include <memory/construct.h>
+#include <memory/standardAllocator.h>
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// InlineAllocator
+	//
+	// Allocator policy holding storage for up to N elements within the 
+	// allocator object itself, so a container using it keeps small contents 
+	// inline and only draws from the Fallback allocator once they outgrow it 
+	// (see SmallList). The inline storage serves a single allocation at a 
+	// time.
+	//
+	// Copying the allocator only copies the fallback allocator: the inline 
+	// storage always belongs to the object holding it, which is why it can't 
+	// be handed over along with the allocator (see AllocatorTraits::isInline).
+	////////////////////////////////////////////////////////////////////////////
+	template< class T, size_t N, class Fallback = StandardAllocator< T > >
+	class InlineAllocator {
+	public:
+		InlineAllocator() : inlineUsed( false ) {}
+		InlineAllocator( const Fallback& fallback ) : fallback( fallback ), inlineUsed( false ) {} // implicit, so that containers can be built straight from a fallback allocator
+		InlineAllocator( const InlineAllocator& other ) : fallback( other.fallback ), inlineUsed( false ) {}
+
+		InlineAllocator& operator=( const InlineAllocator& other ) {
+			// the inline storage stays in use by whoever is using it
+			fallback = other.fallback;
+			return *this;
+		}
+
+		T* alloc( size_t count ) {
+			T* ptr = allocRaw( count );
+			defaultConstruct( ptr, count );
+			return ptr;
+		}
+
+		void free( T* objects, size_t count ) {
+			destroy( objects, count );
+			freeRaw( objects, count );
+		}
+
+		T* allocRaw( size_t count ) {
+			if ( count <= N && !inlineUsed ) {
+				inlineUsed = true;
+				return inlineStorage();
+			}
+			return fallback.allocRaw( count );
+		}
+
+		void freeRaw( T* ptr, size_t count ) {
+			if ( ptr == inlineStorage() ) {
+				assert( inlineUsed );
+				inlineUsed = false;
+				return;
+			}
+			fallback.freeRaw( ptr, count );
+		}
+
+		// resizes storage drawn from the fallback allocator, while anything 
+		// moving in or out of the inline storage is left to the caller
+		T* reallocRaw( T* ptr, size_t oldCount, size_t newCount ) {
+			if ( ptr == inlineStorage() || newCount <= N ) {
+				return NULL;
+			}
+			return AllocatorTraits< Fallback, T >::reallocRaw( fallback, ptr, oldCount, newCount );
+		}
+
+		size_t inlineCapacity() const { return N; }
+		bool isInline( const T* ptr ) const { return ptr == inlineStorage(); }
+
+		const Fallback& getFallback() const { return fallback; }
+
+	private:
+		T* inlineStorage() { return reinterpret_cast< T* >( &storage ); }
+		const T* inlineStorage() const { return reinterpret_cast< const T* >( &storage ); }
+
+	private:
+		static_assert( N > 0, "the inline capacity must be greater than 0" );
+
+		typename std::aligned_storage< N * sizeof( T ), std::alignment_of< T >::value >::type storage;
+		Fallback	fallback;
+		bool		inlineUsed;
+	};
+
+} // namespace Memory
+} // namespace CoreLib
@@ -0,0 +1,131 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <assert.h>
+#include <new>
+#include <type_traits>
+#include <memory/alignment.h>
+#include <memory/construct.h>
+
+#if defined( __linux__ )
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // mremap
+#endif
+#include <sys/mman.h>
+#include <unistd.h>
+#define CORELIB_HAS_MREMAP 1
+#endif
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// MappedAllocator
+	//
+	// Serves large allocations (above MinMappedBytes) with anonymous memory 
+	// maps, which can then be grown with mremap without copying their 
+	// contents: the kernel just moves the pages around. Smaller allocations,
+	// and every allocation on platforms without mremap, go through the 
+	// heap with alignedAlloc, so over-aligned types get their alignment 
+	// either way (maps start at a page boundary).
+	//
+	// Growing with reallocRaw moves the objects bitwise, so List only does
+	// it for relocatable types (see IsRelocatable).
+	////////////////////////////////////////////////////////////////////////////
+	template< class T, size_t MinMappedBytes = 256 * 1024 >
+	class MappedAllocator {
+	public:
+		static T* alloc( size_t count ) {
+			T* ptr = allocRaw( count );
+			defaultConstruct( ptr, count );
+			return ptr;
+		}
+
+		static void free( T* objects, size_t count ) {
+			if ( objects != NULL ) {
+				destroy( objects, count );
+				freeRaw( objects, count );
+			}
+		}
+
+		static T* allocRaw( size_t count ) {
+#if CORELIB_HAS_MREMAP
+			const size_t bytes = count * sizeof( T );
+			if ( bytes >= MinMappedBytes ) {
+				void* ptr = mmap( NULL, pageRound( bytes ), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+				if ( ptr == MAP_FAILED ) {
+					throw std::bad_alloc();
+				}
+				return static_cast< T* >( ptr );
+			}
+#endif
+			return static_cast< T* >( alignedAlloc( count * sizeof( T ), std::alignment_of< T >::value ) );
+		}
+
+		static void freeRaw( T* ptr, size_t count ) {
+#if CORELIB_HAS_MREMAP
+			const size_t bytes = count * sizeof( T );
+			if ( bytes >= MinMappedBytes ) {
+				munmap( ptr, pageRound( bytes ) );
+				return;
+			}
+#endif
+			alignedFree( ptr, std::alignment_of< T >::value );
+		}
+
+		// Resizes mapped storage in place, or lets the kernel move its pages
+		// elsewhere. Returns NULL if either the old or the new size are 
+		// served by the heap.
+		static T* reallocRaw( T* ptr, size_t oldCount, size_t newCount ) {
+#if CORELIB_HAS_MREMAP
+			const size_t oldBytes = oldCount * sizeof( T );
+			const size_t newBytes = newCount * sizeof( T );
+			if ( oldBytes < MinMappedBytes || newBytes < MinMappedBytes ) {
+				return NULL;
+			}
+			if ( pageRound( oldBytes ) == pageRound( newBytes ) ) {
+				return ptr;
+			}
+			void* newPtr = mremap( ptr, pageRound( oldBytes ), pageRound( newBytes ), MREMAP_MAYMOVE );
+			if ( newPtr == MAP_FAILED ) {
+				return NULL;
+			}
+			return static_cast< T* >( newPtr );
+#else
+			(void)ptr; (void)oldCount; (void)newCount;
+			return NULL;
+#endif
+		}
+
+	private:
+#if CORELIB_HAS_MREMAP
+		inline static size_t pageRound( size_t bytes ) {
+			static const size_t pageSize = (size_t)sysconf( _SC_PAGESIZE );
+			return ( bytes + pageSize - 1 ) & ~( pageSize - 1 );
+		}
+#endif
+	};
+
+} // namespace Memory
+} // namespace CoreLib
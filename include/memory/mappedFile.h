@@ -0,0 +1,76 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// class MappedFile
+	// Maps a whole file into memory. Nothing is read up front: pages are 
+	// faulted in from the page cache as they are touched, and are shared 
+	// with any other process mapping the same file.
+	//
+	// Read only mappings fault on any write. Copy on write mappings can be 
+	// written to, but the changes stay private to the process and never 
+	// reach the file.
+	////////////////////////////////////////////////////////////////////////////
+
+	class MappedFile {
+	public:
+		enum Access {
+			ACCESS_READ_ONLY,
+			ACCESS_COPY_ON_WRITE
+		};
+
+		MappedFile();
+		~MappedFile();
+
+		bool open( const char* path, Access access = ACCESS_READ_ONLY );	// returns false if the file can't be mapped
+		void close();
+
+		bool isOpen() const { return data != NULL; }
+		Access getAccess() const { return access; }
+
+		const void* getData() const { return data; }
+		void* getMutableData();		// copy on write mappings only
+		size_t getSize() const { return size; }
+
+		void willNeed( size_t offset, size_t bytes ) const;	// hints that the range is about to be read, so the kernel can start paging it in
+
+	private:
+		MappedFile( const MappedFile& );
+		MappedFile& operator=( const MappedFile& );
+
+	private:
+		void*		data;
+		size_t		size;
+		Access		access;
+#if defined( _WIN32 )
+		void*		mappingHandle;
+#endif
+	};
+
+} // namespace Memory
+} // namespace CoreLib
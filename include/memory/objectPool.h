@@ -0,0 +1,147 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <assert.h>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// class FixedSizePool
+	// Hands out fixed size slots carved from page sized blocks. Freed slots
+	// are kept in an intrusive free list (the link is stored in the slot 
+	// itself), so both alloc and free are a handful of instructions.
+	// Blocks are only returned to the system by clearMemory / destroy.
+	//
+	// Usable from containers through PoolAllocator: requests which don't fit
+	// in a slot are forwarded to the heap.
+	//
+	//	FixedSizePool pool( 16 * sizeof( int ) );
+	//	List< int, PoolAllocator< int, FixedSizePool > > list( pool );
+	////////////////////////////////////////////////////////////////////////////
+
+	class FixedSizePool {
+	public:
+		explicit FixedSizePool( size_t slotSize, size_t blockSize = DEFAULT_BLOCK_SIZE );
+		~FixedSizePool();
+
+		inline void* alloc();				// returns an uninitialized slot
+		inline void free( void* slot );		// returns a slot to the pool
+
+		void* allocBytes( size_t bytes, size_t alignment );
+		void freeBytes( void* ptr, size_t bytes );
+
+		void clearMemory();	// releases every slot at once, keeping a block to allocate from
+		void destroy();		// releases every slot and block
+
+		size_t getSlotSize() const { return slotSize; }
+
+	private:
+		FixedSizePool( const FixedSizePool& );
+		FixedSizePool& operator=( const FixedSizePool& );
+
+		void* allocFromNewBlock();
+
+	public:
+		static const size_t SLOT_ALIGNMENT = 16;
+		static const size_t MAX_ALIGNMENT = SLOT_ALIGNMENT;	// largest alignment allocBytes can serve
+
+	private:
+		static const size_t DEFAULT_BLOCK_SIZE = 4096;
+
+		struct FreeSlot {
+			FreeSlot* next;
+		};
+
+		size_t		slotSize;
+		size_t		blockSize;
+		FreeSlot*	freeList;
+		char*		blocks;			// blocks are chained through their first bytes
+		char*		bumpCurrent;	// slots in the newest block never handed out
+		char*		bumpEnd;
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// class ObjectPool
+	// Typed front end to FixedSizePool, constructing and destroying the 
+	// objects in place.
+	////////////////////////////////////////////////////////////////////////////
+
+	template< class T >
+	class ObjectPool {
+	public:
+		explicit ObjectPool( size_t blockSize = 4096 ) : pool( sizeof( T ), blockSize ) {
+			static_assert( std::alignment_of< T >::value <= FixedSizePool::SLOT_ALIGNMENT, "over-aligned types are not supported" );
+		}
+
+		template< typename... Args >
+		T* construct( Args&&... args ) {
+			return new( pool.alloc() ) T( std::forward< Args >( args )... );
+		}
+
+		void destroy( T* object ) {
+			if ( object != NULL ) {
+				object->~T();
+				pool.free( object );
+			}
+		}
+
+		FixedSizePool& getPool() { return pool; }
+
+	private:
+		FixedSizePool pool;
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// FixedSizePool::alloc
+	////////////////////////////////////////////////////////////////////////////
+	inline void* FixedSizePool::alloc() {
+		if ( freeList != NULL ) {
+			FreeSlot* slot = freeList;
+			freeList = slot->next;
+			return slot;
+		}
+		if ( bumpCurrent != bumpEnd ) {
+			void* slot = bumpCurrent;
+			bumpCurrent += slotSize;
+			return slot;
+		}
+		return allocFromNewBlock();
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// FixedSizePool::free
+	////////////////////////////////////////////////////////////////////////////
+	inline void FixedSizePool::free( void* slot ) {
+		assert( slot != NULL );
+		FreeSlot* freeSlot = static_cast< FreeSlot* >( slot );
+		freeSlot->next = freeList;
+		freeList = freeSlot;
+	}
+
+} // namespace Memory
+} // namespace CoreLib
@@ -0,0 +1,136 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <assert.h>
+#include <type_traits>
+#include <memory/alignment.h>
+#include <memory/construct.h>
+#include <memory/staticPool.h>
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// PoolTraits
+	//
+	// Gives access to the optional MAX_ALIGNMENT constant of the pools, the 
+	// pools which don't declare it being able to align to any boundary.
+	////////////////////////////////////////////////////////////////////////////
+	template< class Pool >
+	class PoolTraits {
+	private:
+		template< class P >
+		static std::integral_constant< size_t, P::MAX_ALIGNMENT > testMaxAlignment( int );
+		template< class P >
+		static std::integral_constant< size_t, ~(size_t)0 > testMaxAlignment( ... );
+
+	public:
+		static const size_t maxAlignment = decltype( testMaxAlignment< Pool >( 0 ) )::value;
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// PoolAllocator
+	//
+	// Stateful allocator policy drawing memory from a given pool instance, so
+	// that containers can allocate from different pools. The pool type must 
+	// provide:
+	//
+	//	void*	allocBytes( bytes, alignment )
+	//	void	freeBytes( ptr, bytes )
+	//
+	// Pools which can only align up to a certain boundary (e.g. the slot 
+	// based ones) declare it as a MAX_ALIGNMENT constant. Allocations needing
+	// more than that are over-allocated from the pool and aligned here.
+	//
+	// Allocations start at the given power of two Alignment, or at the 
+	// alignment of T if greater, e.g.
+	//	MemoryPool framePool( 1024 * 1024 );
+	//	List< int, PoolAllocator< int > > list( framePool );
+	//	List< float, PoolAllocator< float, MemoryPool, 32 > > samples( framePool );
+	////////////////////////////////////////////////////////////////////////////
+	template< class T, class Pool = MemoryPool, size_t Alignment = std::alignment_of< T >::value >
+	class PoolAllocator {
+	public:
+		PoolAllocator() : pool( NULL ) {}
+		PoolAllocator( Pool& pool ) : pool( &pool ) {} // implicit, so that containers can be built straight from a pool
+
+		T* alloc( size_t count ) {
+			T* ptr = allocRaw( count );
+			defaultConstruct( ptr, count );
+			return ptr;
+		}
+
+		void free( T* objects, size_t count ) {
+			destroy( objects, count );
+			freeRaw( objects, count );
+		}
+
+		T* allocRaw( size_t count ) {
+			assert( pool != NULL );
+			if ( ALIGNMENT <= POOL_ALIGNMENT ) {
+				return static_cast< T* >( pool->allocBytes( count * sizeof( T ), ALIGNMENT ) );
+			}
+
+			// leave room to align the allocation, and to keep the address 
+			// returned by the pool just before it
+			char* block = static_cast< char* >( pool->allocBytes( overAlignedBytes( count ), POOL_ALIGNMENT ) );
+			if ( block == NULL ) {
+				return NULL;
+			}
+			char* ptr = alignPointer( block + sizeof( void* ), ALIGNMENT );
+			reinterpret_cast< void** >( ptr )[ -1 ] = block;
+			return reinterpret_cast< T* >( ptr );
+		}
+
+		void freeRaw( T* ptr, size_t count ) {
+			assert( pool != NULL );
+			if ( ALIGNMENT <= POOL_ALIGNMENT ) {
+				pool->freeBytes( ptr, count * sizeof( T ) );
+				return;
+			}
+			if ( ptr != NULL ) {
+				pool->freeBytes( reinterpret_cast< void** >( ptr )[ -1 ], overAlignedBytes( count ) );
+			}
+		}
+
+		Pool* getPool() const { return pool; }
+
+		bool operator==( const PoolAllocator& other ) const { return pool == other.pool; }
+		bool operator!=( const PoolAllocator& other ) const { return pool != other.pool; }
+
+		static const size_t ALIGNMENT = Alignment > std::alignment_of< T >::value ? Alignment : std::alignment_of< T >::value;
+
+	private:
+		static const size_t POOL_ALIGNMENT = PoolTraits< Pool >::maxAlignment;
+
+		static size_t overAlignedBytes( size_t count ) { return count * sizeof( T ) + sizeof( void* ) + ALIGNMENT - 1; }
+
+		static_assert( ( Alignment & ( Alignment - 1 ) ) == 0 && Alignment > 0, "the alignment must be a power of two" );
+
+	private:
+		Pool* pool;
+	};
+
+} // namespace Memory
+} // namespace CoreLib
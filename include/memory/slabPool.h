@@ -0,0 +1,144 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <memory/objectPool.h>
+#include <memory/poolAllocator.h>
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// class SizeClasses
+	// jemalloc style size classes: 16 byte spaced up to 128 bytes, then four
+	// classes per power of two up to MAX_SIZE, which keeps the internal 
+	// fragmentation under 25%.
+	////////////////////////////////////////////////////////////////////////////
+
+	class SizeClasses {
+	public:
+		static const size_t MAX_SIZE = 16 * 1024;	// largest size served by the classes
+		static const size_t NUM_CLASSES = 36;
+
+		inline static size_t classIndex( size_t bytes );	// smallest class fitting the given number of bytes (<= MAX_SIZE)
+		inline static size_t classSize( size_t index );		// bytes held by the class
+
+	private:
+		inline static size_t log2( size_t value );
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// class SlabPool
+	// Serves mixed size allocations from one FixedSizePool per size class, 
+	// so that freed memory is reused by the next allocation of a similar 
+	// size. Allocations above SizeClasses::MAX_SIZE are forwarded to the 
+	// heap. Not thread safe.
+	////////////////////////////////////////////////////////////////////////////
+
+	class SlabPool {
+	public:
+		explicit SlabPool( size_t slabSize = DEFAULT_SLAB_SIZE );
+		~SlabPool();
+
+		void* allocBytes( size_t bytes, size_t alignment );
+		void freeBytes( void* ptr, size_t bytes );
+
+		static const size_t MAX_ALIGNMENT = FixedSizePool::SLOT_ALIGNMENT;	// largest alignment allocBytes can serve
+
+		void clearMemory();	// releases every allocation at once
+		void destroy();		// releases every allocation and slab
+
+	private:
+		SlabPool( const SlabPool& );
+		SlabPool& operator=( const SlabPool& );
+
+	private:
+		static const size_t DEFAULT_SLAB_SIZE = 16 * 1024;
+
+		size_t			slabSize;
+		FixedSizePool*	classes[ SizeClasses::NUM_CLASSES ]; // created on demand
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// SlabAllocator
+	//
+	// Allocator policy drawing from a SlabPool owned by the caller. Short 
+	// lists of any type share the slabs instead of each hitting the heap:
+	//
+	//	SlabPool pool;
+	//	List< Foo, SlabAllocator< Foo > > foos( pool );
+	//	List< Bar, SlabAllocator< Bar > > bars( pool );
+	//
+	// As SlabPool isn't thread safe, there is no process-wide default pool:
+	// lists used from different threads need pools of their own, or else a 
+	// ThreadCachingAllocator.
+	////////////////////////////////////////////////////////////////////////////
+	template< class T >
+	class SlabAllocator : public PoolAllocator< T, SlabPool > {
+	public:
+		SlabAllocator( SlabPool& pool ) : PoolAllocator< T, SlabPool >( pool ) {}
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// SizeClasses::classIndex
+	////////////////////////////////////////////////////////////////////////////
+	inline size_t SizeClasses::classIndex( size_t bytes ) {
+		if ( bytes <= 128 ) {
+			return bytes > 0 ? ( bytes - 1 ) >> 4 : 0;
+		}
+		// 2^p < bytes <= 2^(p+1), split in four classes spaced 2^(p-2)
+		const size_t p = log2( bytes - 1 );
+		const size_t group = p - 7;
+		const size_t offset = ( bytes - ( (size_t)1 << p ) - 1 ) >> ( p - 2 );
+		return 8 + group * 4 + offset;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// SizeClasses::classSize
+	////////////////////////////////////////////////////////////////////////////
+	inline size_t SizeClasses::classSize( size_t index ) {
+		if ( index < 8 ) {
+			return ( index + 1 ) << 4;
+		}
+		const size_t p = 7 + ( index - 8 ) / 4;
+		const size_t k = ( index - 8 ) % 4;
+		return ( (size_t)1 << p ) + ( ( k + 1 ) << ( p - 2 ) );
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// SizeClasses::log2
+	////////////////////////////////////////////////////////////////////////////
+	inline size_t SizeClasses::log2( size_t value ) {
+#if defined( __GNUC__ )
+		return sizeof( unsigned long long ) * 8 - 1 - __builtin_clzll( (unsigned long long)value );
+#else
+		size_t result = 0;
+		while( value >>= 1 ) {
+			result++;
+		}
+		return result;
+#endif
+	}
+
+} // namespace Memory
+} // namespace CoreLib
@@ -21,29 +21,115 @@
 */
 
 #pragma once
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+#include <memory/alignment.h>
+#include <memory/construct.h>
+#include <stats/counters.h>
 
 namespace CoreLib {
 namespace Memory {
 
+	////////////////////////////////////////////////////////////////////////////
+	// Allocator policies
+	//
+	// Containers such as List are parameterized on an allocator policy 
+	// exposing the following methods:
+	//
+	//	T*		alloc( count )			allocates and default constructs count objects
+	//	void	free( objects, count )	destroys and releases objects returned by alloc
+	//	T*		allocRaw( count )		allocates uninitialized storage for count objects
+	//	void	freeRaw( ptr, count )	releases storage returned by allocRaw, without
+	//									running any destructor
+	//
+	// Containers use the raw versions, and take care of constructing and 
+	// destroying the elements themselves.
+	////////////////////////////////////////////////////////////////////////////
+
 	////////////////////////////////////////////////////////////////////////////
 	// StandardAllocator
 	//
-	// Use the standard heap allocation
+	// Use the standard heap allocation.
+	// Over-aligned types, which operator new doesn't align for before C++17,
+	// are allocated with alignedAlloc instead, and then can only be released
+	// through free( objects, count ).
+	// With CORELIB_ENABLE_STATS, the live bytes are tracked per type, except
+	// for objects released through free( objects ), which doesn't know how 
+	// many there are.
 	////////////////////////////////////////////////////////////////////////////
 	template< class T >
 	class StandardAllocator {
 	public:
 		inline static T* alloc( size_t count ) {
-			return new T[ count ];
+			return alloc( count, std::integral_constant< bool, OVER_ALIGNED >() );
 		}
 
 		inline static void free( T* objects ) {
+			static_assert( !OVER_ALIGNED, "over-aligned objects must be released with free( objects, count )" );
 			delete[] objects;
 		}
 
-		inline static void free( T* objects, size_t /*count*/ ) {
+		inline static void free( T* objects, size_t count ) {
+			free( objects, count, std::integral_constant< bool, OVER_ALIGNED >() );
+		}
+
+		inline static T* allocRaw( size_t count ) {
+			CORELIB_STAT( recordAlloc( count ) );
+			return static_cast< T* >( alignedAlloc( count * sizeof( T ), std::alignment_of< T >::value ) );
+		}
+
+		inline static void freeRaw( T* ptr, size_t count ) {
+			CORELIB_STAT( if ( ptr != NULL ) recordFree( count ) );
+			(void)count;
+			alignedFree( ptr, std::alignment_of< T >::value );
+		}
+
+	private:
+		static const bool OVER_ALIGNED = std::alignment_of< T >::value > DEFAULT_ALIGNMENT;
+
+		inline static T* alloc( size_t count, std::false_type ) {
+			CORELIB_STAT( recordAlloc( count ) );
+			return new T[ count ];
+		}
+
+		inline static T* alloc( size_t count, std::true_type ) {
+			T* objects = allocRaw( count );
+			defaultConstruct( objects, count );
+			return objects;
+		}
+
+		inline static void free( T* objects, size_t count, std::false_type ) {
+			CORELIB_STAT( if ( objects != NULL ) recordFree( count ) );
+			(void)count;
 			delete[] objects;
 		}
+
+		inline static void free( T* objects, size_t count, std::true_type ) {
+			if ( objects != NULL ) {
+				destroy( objects, count );
+				freeRaw( objects, count );
+			}
+		}
+
+#if CORELIB_ENABLE_STATS
+		enum { LIVE_BYTES, ALLOCATIONS, NUM_COUNTERS };
+
+		static Stats::CounterGroup< NUM_COUNTERS >& stats() {
+			static const char* const names[ NUM_COUNTERS ] = { "liveBytes", "allocations" };
+			static Stats::CounterGroup< NUM_COUNTERS > counters( "standardAllocator." + Stats::typeName( typeid( T ) ), names );
+			return counters;
+		}
+
+		static void recordAlloc( size_t count ) {
+			stats().add( LIVE_BYTES, count * sizeof( T ) );
+			stats().add( ALLOCATIONS, 1 );
+		}
+
+		static void recordFree( size_t count ) {
+			stats().sub( LIVE_BYTES, count * sizeof( T ) );
+		}
+#endif
 	};
 }
 }
@@ -24,86 +24,143 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <iostream>
+#include <type_traits>
+#include <memory/construct.h>
+#include <stats/counters.h>
 
 namespace CoreLib {
 namespace Memory {
 
 	////////////////////////////////////////////////////////////////////////////
-	// class StaticMemoryPool
-	// Allocates a static chunk of memory once, and allocates memory from it
-	// the mem pool is deleted at once when the allocator is destroyed
+	// class MemoryPool
+	// Allocates a chunk of memory once, and allocates memory from it by 
+	// bumping a pointer. Individual allocations are never freed, the whole
+	// pool is either reset with clearMemory or released at once.
+	//
+	// Any number of pools can be created, e.g. one per frame or subsystem, 
+	// each with its own lifetime. Use them from containers through the 
+	// PoolAllocator policy.
 	////////////////////////////////////////////////////////////////////////////
 
-	class StaticMemoryPoolBase {
+	class MemoryPool {
 	public:
-		static void init( size_t poolSize );
-		static void destroy();
-		
-		static void clearMemory(); // Wipes the memory chunk without freeing the memory and resets the allocator internal state. Call this before reusing the pool.
+		constexpr MemoryPool() 
+			:	memory( NULL ), 
+				size( 0 ), 
+				used( 0 ), 
+				ownsMemory( false )
+#if CORELIB_ENABLE_STATS
+				, highWater( 0 ),
+				allocations( 0 ),
+				paddingBytes( 0 )
+#endif
+		{}
+		explicit MemoryPool( size_t poolSize );
+		~MemoryPool();
+
+		void init( size_t poolSize );
+		void attach( void* buffer, size_t bufferSize ); // allocate from external memory, which the pool won't release
+		void destroy();
 		
-	protected:
-		static char*				memory;
-		static size_t				size;
-		static size_t				used;
+		void clearMemory(); // Wipes the memory chunk without freeing the memory and resets the allocator internal state. Call this before reusing the pool.
+
+		void* allocBytes( size_t bytes, size_t alignment );
+		void freeBytes( void* /*ptr*/, size_t /*bytes*/ ) { /* do nothing */ }
+
+		size_t mark() const { return used; }	// current position in the pool
+		void rewind( size_t marker );			// releases everything allocated after the marker was taken
+
+		size_t getSize() const { return size; }
+		size_t getUsed() const { return used; }
+
+	private:
+		MemoryPool( const MemoryPool& );
+		MemoryPool& operator=( const MemoryPool& );
+
+#if CORELIB_ENABLE_STATS
+		void recordAllocation( size_t padding );
+		static void sampleStats( const void* pool, const std::string& name, Stats::Snapshot& snapshot );
+#endif
+
+	private:
+		char*				memory;
+		size_t				size;
+		size_t				used;
+		bool				ownsMemory;
+
+#if CORELIB_ENABLE_STATS
+		size_t				highWater;
+		size_t				allocations;
+		size_t				paddingBytes;	// lost to alignment
+#endif
 	};
-	
-	template< class T, int alignment = 4 >
-	class StaticMemoryPool : protected StaticMemoryPoolBase {
-	public:
-		
-		 static T* alloc( size_t count ) {
-			const size_t bytes = count * sizeof(T);
-			const size_t padding = bytes % alignment;
-			const size_t required = bytes + padding;
-			
-			// the array version of placement new stores extra information
-			// at the beginning of the provided buffer corresponding to the  
-			// size of the array!, therefore the pointer returned by new
-			// will be >= buffer, and we must adjust the actual
-			// memory used.
-			// http://www.devx.com/cplus/10MinuteSolution/30508/1954
-			// http://efreedom.com/Question/1-4011577/Placement-New-Array-Alignment
-			// The biggest problem is that it's not specified how much extra mem
-			// is used - according to my debug it's just 4 bytes (an int?) but
-			// it invalidates the used + required >= size test if used + required == size
-			// which we compensate with the placement_new_baggage constant
-
-			const int placement_new_baggage = 4; // FIXME! empiric, not portable
-
-			if ( used + required + placement_new_baggage >= size ) {
-                std::cerr << "Ran out of memory on static pool allocator (size = " << size << " bytes)" << std::endl;
-                assert(false);
-				return NULL; 
-			}
 
-			char* buffer = memory + used;
-			 
-			T* ptr = new( buffer )T[ count ];
+	////////////////////////////////////////////////////////////////////////////
+	// class SourcedPoolAllocator
+	// Stateless allocator policy drawing from the MemoryPool returned by 
+	// PoolSource::currentPool(), which may be NULL when no pool is available
+	// (the source reports why). Allocations start at the given power of two
+	// alignment, or at the alignment of T if greater. Memory is never freed 
+	// individually, only when the pool itself is cleared or rewound.
+	////////////////////////////////////////////////////////////////////////////
+
+	template< class T, class PoolSource, int alignment = 4 >
+	class SourcedPoolAllocator {
+	public:
 
-			used = reinterpret_cast< char* >( ptr ) - memory + required;
+		// Returns count default constructed objects, starting at the pool 
+		// alignment (or that of T, if greater). Like new T[ count ], POD 
+		// types are left uninitialized.
+		static T* alloc( size_t count ) {
+			T* ptr = allocRaw( count );
+			if ( ptr != NULL ) {
+				defaultConstruct( ptr, count );
+			}
 			return ptr;
-		};
+		}
 
 		inline static void free( T* ) { /* do nothing */ }
 		inline static void free( T* , size_t ) { /* do nothing */ }
 
-	private:
-		template< class U >
-		static U* allocIntegralType( size_t count ) {
-			// besides the requested space, we'll need to add some extra padding
-			// because "new" will return a pointer aligned with the requested type
-			// which might slightly shifted from "memory + used"
-			const size_t bytes = count * sizeof(T);
-			const size_t padding = bytes % alignment;
-			const size_t required = bytes + padding;
-			if ( used + required >= size ) {
-				return NULL; 
+		// Returns uninitialized storage for count objects.
+		static T* allocRaw( size_t count ) {
+			MemoryPool* pool = PoolSource::currentPool();
+			if ( pool == NULL ) {
+				return NULL;
 			}
-
-			T* ptr = reinterpret_cast< T* >( memory + used );
-			used += required;
-			return ptr;
+			return static_cast< T* >( pool->allocBytes( count * sizeof(T), ALIGNMENT ) );
 		}
+
+		inline static void freeRaw( T*, size_t ) { /* do nothing */ }
+
+		static const size_t ALIGNMENT = (size_t)alignment > std::alignment_of< T >::value ? (size_t)alignment : std::alignment_of< T >::value;
+
+	private:
+		static_assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0, "the alignment must be a power of two" );
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// class StaticMemoryPool
+	// Allocates from a single, process-wide MemoryPool. Allocations start at
+	// the given power of two alignment, or at the alignment of T if greater.
+	////////////////////////////////////////////////////////////////////////////
+
+	class StaticMemoryPoolBase {
+	public:
+		static void init( size_t poolSize ) { pool.init( poolSize ); }
+		static void destroy() { pool.destroy(); }
+		
+		static void clearMemory() { pool.clearMemory(); } // Wipes the memory chunk without freeing the memory and resets the allocator internal state. Call this before reusing the pool.
+
+		static MemoryPool& getPool() { return pool; }
+		static MemoryPool* currentPool() { return &pool; } // pool source for SourcedPoolAllocator
+		
+	protected:
+		static MemoryPool			pool;
+	};
+	
+	template< class T, int alignment = 4 >
+	class StaticMemoryPool : public SourcedPoolAllocator< T, StaticMemoryPoolBase, alignment > {
 	};
 
 } // namespace Memory
@@ -0,0 +1,107 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <mutex>
+#include <memory/alignment.h>
+#include <memory/slabPool.h>
+#include <memory/poolAllocator.h>
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// class ThreadCachingPool
+	// Thread safe, tcmalloc style size class allocator. Each thread keeps a 
+	// small magazine of free slots per size class and only reaches the 
+	// central pool (one lock per size class) to refill or return a batch of
+	// slots at once.
+	//
+	// Memory may be freed from any thread, not just the one which allocated
+	// it: the slot goes to the freeing thread's magazine, and eventually 
+	// back to the central pool, which owns every slab.
+	//
+	// The pool must outlive every thread allocating from it, as their caches
+	// are returned to it when they exit (or earlier, through flushThreadCache).
+	// Allocations above SizeClasses::MAX_SIZE are forwarded to the heap.
+	////////////////////////////////////////////////////////////////////////////
+
+	class ThreadCachingPool {
+	public:
+		struct ThreadCache;
+
+		explicit ThreadCachingPool( size_t slabSize = DEFAULT_SLAB_SIZE );
+		~ThreadCachingPool();
+
+		void* allocBytes( size_t bytes, size_t alignment );
+		void freeBytes( void* ptr, size_t bytes );
+
+		static const size_t MAX_ALIGNMENT = FixedSizePool::SLOT_ALIGNMENT;	// largest alignment allocBytes can serve
+
+		void flushThreadCache(); // returns the calling thread's cached slots to the central pool
+
+		static ThreadCachingPool& getDefault(); // pool shared by the default constructed ThreadCachingAllocators
+
+	private:
+		ThreadCachingPool( const ThreadCachingPool& );
+		ThreadCachingPool& operator=( const ThreadCachingPool& );
+
+		friend struct ThreadCacheRegistry;
+
+		ThreadCache* getThreadCache();
+		void releaseThreadCache( ThreadCache* cache );
+
+		size_t allocBatch( size_t classIndex, void** slots, size_t count );
+		void freeBatch( size_t classIndex, void** slots, size_t count );
+
+	private:
+		static const size_t DEFAULT_SLAB_SIZE = 64 * 1024;
+
+		// padded to its own cache line, so that threads hitting different
+		// classes don't contend
+		struct CentralClass {
+			std::mutex		mutex;
+			FixedSizePool*	pool;
+			char			padding[ CACHE_LINE_SIZE ];
+		};
+
+		size_t			slabSize;
+		CentralClass	classes[ SizeClasses::NUM_CLASSES ];
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	// ThreadCachingAllocator
+	//
+	// Allocator policy drawing from a ThreadCachingPool, the process-wide 
+	// default one unless given another. Lists using it can be created, grown
+	// and destroyed from any thread.
+	////////////////////////////////////////////////////////////////////////////
+	template< class T >
+	class ThreadCachingAllocator : public PoolAllocator< T, ThreadCachingPool > {
+	public:
+		ThreadCachingAllocator() : PoolAllocator< T, ThreadCachingPool >( ThreadCachingPool::getDefault() ) {}
+		ThreadCachingAllocator( ThreadCachingPool& pool ) : PoolAllocator< T, ThreadCachingPool >( pool ) {}
+	};
+
+} // namespace Memory
+} // namespace CoreLib
@@ -0,0 +1,93 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+
+namespace CoreLib {
+namespace Memory {
+
+	////////////////////////////////////////////////////////////////////////////
+	// class VirtualMemoryPool
+	// Bump allocator reserving a large address range up front, and 
+	// committing physical pages only as the used size advances, so a pool 
+	// sized for the worst case costs neither startup time nor RSS until 
+	// it's actually used.
+	//
+	// Optionally backed by huge pages to reduce TLB misses: transparent huge
+	// pages are a hint the kernel may ignore, explicit huge pages must be 
+	// preallocated by the system and are reserved for the whole range at 
+	// init (falling back to transparent ones if there aren't enough).
+	//
+	// clearMemory keeps up to releaseThreshold bytes committed, and returns 
+	// the pages above it to the system.
+	////////////////////////////////////////////////////////////////////////////
+
+	class VirtualMemoryPool {
+	public:
+		enum PageMode {
+			PAGES_DEFAULT,
+			PAGES_TRANSPARENT_HUGE,
+			PAGES_EXPLICIT_HUGE
+		};
+
+		VirtualMemoryPool();
+		explicit VirtualMemoryPool( size_t reserveSize, PageMode pageMode = PAGES_DEFAULT );
+		~VirtualMemoryPool();
+
+		void init( size_t reserveSize, PageMode pageMode = PAGES_DEFAULT );
+		void destroy();
+
+		void clearMemory(); // resets the allocator and releases the committed pages above the release threshold
+
+		void* allocBytes( size_t bytes, size_t alignment );
+		void freeBytes( void* /*ptr*/, size_t /*bytes*/ ) { /* do nothing */ }
+
+		void setReleaseThreshold( size_t bytes ) { releaseThreshold = bytes; }
+		size_t getReleaseThreshold() const { return releaseThreshold; }
+
+		size_t getSize() const { return size; }				// reserved bytes
+		size_t getUsed() const { return used; }
+		size_t getCommitted() const { return committed; }
+		PageMode getPageMode() const { return pageMode; }
+
+	private:
+		VirtualMemoryPool( const VirtualMemoryPool& );
+		VirtualMemoryPool& operator=( const VirtualMemoryPool& );
+
+		bool commit( size_t bytes );
+		void decommit( size_t bytes );
+
+	private:
+		char*		memory;
+		char*		mapping;			// start of the reserved range, before any huge page alignment
+		size_t		mappingSize;
+		size_t		size;
+		size_t		used;
+		size_t		committed;
+		size_t		commitGranularity;	// page size, or huge page size
+		size_t		releaseThreshold;
+		PageMode	pageMode;
+	};
+
+} // namespace Memory
+} // namespace CoreLib
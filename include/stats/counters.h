@@ -0,0 +1,101 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <typeinfo>
+
+//////////////////////////////////////////////////////////////////////////
+// Runtime statistics
+//
+// Allocators and containers keep counters of their memory behavior when
+// CORELIB_ENABLE_STATS is defined (see the CMake option of the same name). 
+// When it isn't, the instrumentation compiles out entirely. The counters 
+// are collected with Stats::snapshot or Stats::report (see stats.h).
+//////////////////////////////////////////////////////////////////////////
+
+#if CORELIB_ENABLE_STATS
+#define CORELIB_STAT( statement ) statement
+#else
+#define CORELIB_STAT( statement )
+#endif
+
+namespace CoreLib {
+namespace Stats {
+
+	class Snapshot;
+
+	// adds the samples of the given object to the snapshot, naming them 
+	// after the source name
+	typedef void ( *SampleCallback )( const void* object, const std::string& name, Snapshot& snapshot );
+
+	void addSource( const char* name, const void* object, SampleCallback callback );	// names are made unique by appending a number
+	void removeSource( const void* object );
+
+	std::string typeName( const std::type_info& type );	// human readable name of the type, where available
+
+	void sampleCounters( Snapshot& snapshot, const std::string& name, const char* const* counterNames, const std::atomic< uint64_t >* counters, size_t numCounters );
+
+	//////////////////////////////////////////////////////////////////////////
+	// class CounterGroup
+	//
+	// Named set of thread safe counters, registered as a statistics source 
+	// for as long as the group exists.
+	//////////////////////////////////////////////////////////////////////////
+	template< size_t N >
+	class CounterGroup {
+	public:
+		CounterGroup( const std::string& name, const char* const ( &counterNames )[ N ] ) : counterNames( counterNames ) {
+			for( size_t i = 0; i < N; i++ ) {
+				counters[ i ].store( 0, std::memory_order_relaxed );
+			}
+			addSource( name.c_str(), this, &CounterGroup::sample );
+		}
+
+		~CounterGroup() {
+			removeSource( this );
+		}
+
+		void add( size_t counter, uint64_t value ) { counters[ counter ].fetch_add( value, std::memory_order_relaxed ); }
+		void sub( size_t counter, uint64_t value ) { counters[ counter ].fetch_sub( value, std::memory_order_relaxed ); }
+
+		uint64_t get( size_t counter ) const { return counters[ counter ].load( std::memory_order_relaxed ); }
+
+	private:
+		CounterGroup( const CounterGroup& );
+		CounterGroup& operator=( const CounterGroup& );
+
+		static void sample( const void* object, const std::string& name, Snapshot& snapshot ) {
+			const CounterGroup* group = static_cast< const CounterGroup* >( object );
+			sampleCounters( snapshot, name, group->counterNames, group->counters, N );
+		}
+
+	private:
+		const char* const*			counterNames;
+		std::atomic< uint64_t >		counters[ N ];
+	};
+
+} // namespace Stats
+} // namespace CoreLib
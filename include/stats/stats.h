@@ -0,0 +1,69 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <ostream>
+#include <vector>
+#include <stats/counters.h>
+
+namespace CoreLib {
+namespace Stats {
+
+	//////////////////////////////////////////////////////////////////////////
+	// Sample
+	//
+	// Value of a single counter, named "<source>.<counter>", e.g. 
+	// "list.int.reallocations".
+	//////////////////////////////////////////////////////////////////////////
+	struct Sample {
+		std::string		name;
+		uint64_t		value;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// class Snapshot
+	//
+	// Values of every registered counter at a given point in time.
+	// Note the statistics layer sticks to std containers, so that it doesn't
+	// instrument (and reenter) itself.
+	//////////////////////////////////////////////////////////////////////////
+	class Snapshot {
+	public:
+		void add( const std::string& name, uint64_t value );
+		void clear() { samples.clear(); }
+
+		size_t size() const { return samples.size(); }
+		const Sample& operator[]( size_t index ) const { return samples[ index ]; }
+
+		const Sample* find( const std::string& name ) const; // NULL if there's no such sample
+
+	private:
+		std::vector< Sample > samples;
+	};
+
+	void snapshot( Snapshot& snapshot );	// samples every registered source
+	void report( std::ostream& out );		// writes a snapshot as "name value" lines
+
+} // namespace Stats
+} // namespace CoreLib
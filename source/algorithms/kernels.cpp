@@ -0,0 +1,358 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#include <algorithms/kernels.h>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define CORELIB_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+// compiled for AVX2 regardless of the build flags, used if the CPU supports it
+#define CORELIB_SIMD_AVX2 1
+#define CORELIB_SIMD_AVX2_RUNTIME_CHECK 1
+#include <immintrin.h>
+#elif defined( __AVX2__ )
+#define CORELIB_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+namespace CoreLib {
+namespace Algorithms {
+namespace Simd {
+
+namespace {
+
+	inline unsigned int lowestBit( int mask ) {
+#if defined( _MSC_VER )
+		unsigned long index;
+		_BitScanForward( &index, (unsigned long)mask );
+		return (unsigned int)index;
+#else
+		return (unsigned int)__builtin_ctz( (unsigned int)mask );
+#endif
+	}
+
+	// masks have at most 8 bits, counted without relying on popcnt support
+	inline size_t bitCount( int mask ) {
+		unsigned int bits = (unsigned int)mask;
+		bits = bits - ( ( bits >> 1 ) & 0x55 );
+		bits = ( bits & 0x33 ) + ( ( bits >> 2 ) & 0x33 );
+		return ( bits + ( bits >> 4 ) ) & 0x0F;
+	}
+
+	InstructionSet& activeInstructionSet() {
+		static InstructionSet instructionSet = getSupportedInstructionSet();
+		return instructionSet;
+	}
+}
+
+#if CORELIB_SIMD_SSE2
+////////////////////////////////////////////////////////////////////////////////
+// SSE2 kernels
+//
+// SSE2 lacks 32 bit integer min / max, which are built from comparisons, 
+// flipping the sign bit of unsigned values to compare them as signed.
+////////////////////////////////////////////////////////////////////////////////
+namespace Sse2 {
+
+	inline __m128i select( __m128i mask, __m128i a, __m128i b ) { // mask ? a : b
+		return _mm_or_si128( _mm_and_si128( mask, a ), _mm_andnot_si128( mask, b ) );
+	}
+
+	struct IntOps {
+		typedef int Scalar;
+		typedef __m128i Vector;
+		static const size_t LANES = 4;
+		static Vector load( const Scalar* p ) { return _mm_loadu_si128( (const __m128i*)p ); }
+		static Vector splat( Scalar value ) { return _mm_set1_epi32( value ); }
+		static void store( Scalar* p, Vector v ) { _mm_storeu_si128( (__m128i*)p, v ); }
+		static int equalMask( Vector a, Vector b ) { return _mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( a, b ) ) ); }
+		static Vector min( Vector acc, Vector v ) { return select( _mm_cmplt_epi32( v, acc ), v, acc ); }
+		static Vector max( Vector acc, Vector v ) { return select( _mm_cmplt_epi32( acc, v ), v, acc ); }
+	};
+
+	struct UnsignedOps {
+		typedef unsigned int Scalar;
+		typedef __m128i Vector;
+		static const size_t LANES = 4;
+		static Vector load( const Scalar* p ) { return _mm_loadu_si128( (const __m128i*)p ); }
+		static Vector splat( Scalar value ) { return _mm_set1_epi32( (int)value ); }
+		static void store( Scalar* p, Vector v ) { _mm_storeu_si128( (__m128i*)p, v ); }
+		static int equalMask( Vector a, Vector b ) { return _mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( a, b ) ) ); }
+		static Vector less( Vector a, Vector b ) {
+			const __m128i signBit = _mm_set1_epi32( (int)0x80000000u );
+			return _mm_cmplt_epi32( _mm_xor_si128( a, signBit ), _mm_xor_si128( b, signBit ) );
+		}
+		static Vector min( Vector acc, Vector v ) { return select( less( v, acc ), v, acc ); }
+		static Vector max( Vector acc, Vector v ) { return select( less( acc, v ), v, acc ); }
+	};
+
+	struct FloatOps {
+		typedef float Scalar;
+		typedef __m128 Vector;
+		static const size_t LANES = 4;
+		static Vector load( const Scalar* p ) { return _mm_loadu_ps( p ); }
+		static Vector splat( Scalar value ) { return _mm_set1_ps( value ); }
+		static void store( Scalar* p, Vector v ) { _mm_storeu_ps( p, v ); }
+		static int equalMask( Vector a, Vector b ) { return _mm_movemask_ps( _mm_cmpeq_ps( a, b ) ); }
+		static Vector min( Vector acc, Vector v ) { return _mm_min_ps( v, acc ); }
+		static Vector max( Vector acc, Vector v ) { return _mm_max_ps( v, acc ); }
+		static Vector zero() { return _mm_setzero_ps(); }
+		static Vector add( Vector a, Vector b ) { return _mm_add_ps( a, b ); }
+	};
+
+	struct DoubleOps {
+		typedef double Scalar;
+		typedef __m128d Vector;
+		static const size_t LANES = 2;
+		static Vector load( const Scalar* p ) { return _mm_loadu_pd( p ); }
+		static Vector splat( Scalar value ) { return _mm_set1_pd( value ); }
+		static void store( Scalar* p, Vector v ) { _mm_storeu_pd( p, v ); }
+		static int equalMask( Vector a, Vector b ) { return _mm_movemask_pd( _mm_cmpeq_pd( a, b ) ); }
+		static Vector min( Vector acc, Vector v ) { return _mm_min_pd( v, acc ); }
+		static Vector max( Vector acc, Vector v ) { return _mm_max_pd( v, acc ); }
+		static Vector zero() { return _mm_setzero_pd(); }
+		static Vector add( Vector a, Vector b ) { return _mm_add_pd( a, b ); }
+	};
+
+	#include "kernelsImpl.inl"
+
+	// sums into 64 bit lanes, extending each 32 bit value with its sign 
+	// (or zero) before adding it
+	template< bool Signed, typename T, typename Sum >
+	inline Sum intSumKernel( const T* data, size_t count ) {
+		__m128i acc = _mm_setzero_si128();
+		size_t i = 0;
+		for( ; i + 4 <= count; i += 4 ) {
+			__m128i v = _mm_loadu_si128( (const __m128i*)( data + i ) );
+			__m128i extension = Signed ? _mm_srai_epi32( v, 31 ) : _mm_setzero_si128();
+			acc = _mm_add_epi64( acc, _mm_unpacklo_epi32( v, extension ) );
+			acc = _mm_add_epi64( acc, _mm_unpackhi_epi32( v, extension ) );
+		}
+		Sum lanes[ 2 ];
+		_mm_storeu_si128( (__m128i*)lanes, acc );
+		Sum result = (Sum)( (uint64_t)lanes[ 0 ] + (uint64_t)lanes[ 1 ] );
+		for( ; i < count; i++ ) {
+			result += (Sum)data[ i ];
+		}
+		return result;
+	}
+
+	template<> inline int64_t sumKernel< IntOps >( const int* data, size_t count ) { return intSumKernel< true, int, int64_t >( data, count ); }
+	template<> inline uint64_t sumKernel< UnsignedOps >( const unsigned int* data, size_t count ) { return intSumKernel< false, unsigned int, uint64_t >( data, count ); }
+}
+#endif
+
+#if CORELIB_SIMD_AVX2
+////////////////////////////////////////////////////////////////////////////////
+// AVX2 kernels
+////////////////////////////////////////////////////////////////////////////////
+#if defined( __clang__ )
+#pragma clang attribute push( __attribute__( ( target( "avx2" ) ) ), apply_to = function )
+#elif defined( __GNUC__ )
+#pragma GCC push_options
+#pragma GCC target( "avx2" )
+#endif
+
+namespace Avx2 {
+
+	struct IntOps {
+		typedef int Scalar;
+		typedef __m256i Vector;
+		static const size_t LANES = 8;
+		static Vector load( const Scalar* p ) { return _mm256_loadu_si256( (const __m256i*)p ); }
+		static Vector splat( Scalar value ) { return _mm256_set1_epi32( value ); }
+		static void store( Scalar* p, Vector v ) { _mm256_storeu_si256( (__m256i*)p, v ); }
+		static int equalMask( Vector a, Vector b ) { return _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( a, b ) ) ); }
+		static Vector min( Vector acc, Vector v ) { return _mm256_min_epi32( acc, v ); }
+		static Vector max( Vector acc, Vector v ) { return _mm256_max_epi32( acc, v ); }
+	};
+
+	struct UnsignedOps {
+		typedef unsigned int Scalar;
+		typedef __m256i Vector;
+		static const size_t LANES = 8;
+		static Vector load( const Scalar* p ) { return _mm256_loadu_si256( (const __m256i*)p ); }
+		static Vector splat( Scalar value ) { return _mm256_set1_epi32( (int)value ); }
+		static void store( Scalar* p, Vector v ) { _mm256_storeu_si256( (__m256i*)p, v ); }
+		static int equalMask( Vector a, Vector b ) { return _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( a, b ) ) ); }
+		static Vector min( Vector acc, Vector v ) { return _mm256_min_epu32( acc, v ); }
+		static Vector max( Vector acc, Vector v ) { return _mm256_max_epu32( acc, v ); }
+	};
+
+	struct FloatOps {
+		typedef float Scalar;
+		typedef __m256 Vector;
+		static const size_t LANES = 8;
+		static Vector load( const Scalar* p ) { return _mm256_loadu_ps( p ); }
+		static Vector splat( Scalar value ) { return _mm256_set1_ps( value ); }
+		static void store( Scalar* p, Vector v ) { _mm256_storeu_ps( p, v ); }
+		static int equalMask( Vector a, Vector b ) { return _mm256_movemask_ps( _mm256_cmp_ps( a, b, _CMP_EQ_OQ ) ); }
+		static Vector min( Vector acc, Vector v ) { return _mm256_min_ps( v, acc ); }
+		static Vector max( Vector acc, Vector v ) { return _mm256_max_ps( v, acc ); }
+		static Vector zero() { return _mm256_setzero_ps(); }
+		static Vector add( Vector a, Vector b ) { return _mm256_add_ps( a, b ); }
+	};
+
+	struct DoubleOps {
+		typedef double Scalar;
+		typedef __m256d Vector;
+		static const size_t LANES = 4;
+		static Vector load( const Scalar* p ) { return _mm256_loadu_pd( p ); }
+		static Vector splat( Scalar value ) { return _mm256_set1_pd( value ); }
+		static void store( Scalar* p, Vector v ) { _mm256_storeu_pd( p, v ); }
+		static int equalMask( Vector a, Vector b ) { return _mm256_movemask_pd( _mm256_cmp_pd( a, b, _CMP_EQ_OQ ) ); }
+		static Vector min( Vector acc, Vector v ) { return _mm256_min_pd( v, acc ); }
+		static Vector max( Vector acc, Vector v ) { return _mm256_max_pd( v, acc ); }
+		static Vector zero() { return _mm256_setzero_pd(); }
+		static Vector add( Vector a, Vector b ) { return _mm256_add_pd( a, b ); }
+	};
+
+	#include "kernelsImpl.inl"
+
+	template< bool Signed, typename T, typename Sum >
+	inline Sum intSumKernel( const T* data, size_t count ) {
+		__m256i acc = _mm256_setzero_si256();
+		size_t i = 0;
+		for( ; i + 4 <= count; i += 4 ) {
+			__m128i v = _mm_loadu_si128( (const __m128i*)( data + i ) );
+			acc = _mm256_add_epi64( acc, Signed ? _mm256_cvtepi32_epi64( v ) : _mm256_cvtepu32_epi64( v ) );
+		}
+		Sum lanes[ 4 ];
+		_mm256_storeu_si256( (__m256i*)lanes, acc );
+		Sum result = (Sum)( (uint64_t)lanes[ 0 ] + (uint64_t)lanes[ 1 ] + (uint64_t)lanes[ 2 ] + (uint64_t)lanes[ 3 ] );
+		for( ; i < count; i++ ) {
+			result += (Sum)data[ i ];
+		}
+		return result;
+	}
+
+	template<> inline int64_t sumKernel< IntOps >( const int* data, size_t count ) { return intSumKernel< true, int, int64_t >( data, count ); }
+	template<> inline uint64_t sumKernel< UnsignedOps >( const unsigned int* data, size_t count ) { return intSumKernel< false, unsigned int, uint64_t >( data, count ); }
+}
+
+#if defined( __clang__ )
+#pragma clang attribute pop
+#elif defined( __GNUC__ )
+#pragma GCC pop_options
+#endif
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Instruction set selection
+////////////////////////////////////////////////////////////////////////////////
+InstructionSet getSupportedInstructionSet() {
+#if CORELIB_SIMD_AVX2
+#if CORELIB_SIMD_AVX2_RUNTIME_CHECK
+	__builtin_cpu_init();
+	if ( __builtin_cpu_supports( "avx2" ) ) {
+		return INSTRUCTIONS_AVX2;
+	}
+#else
+	return INSTRUCTIONS_AVX2;
+#endif
+#endif
+#if CORELIB_SIMD_SSE2
+	return INSTRUCTIONS_SSE2;
+#else
+	return INSTRUCTIONS_SCALAR;
+#endif
+}
+
+InstructionSet getInstructionSet() {
+	return activeInstructionSet();
+}
+
+void setInstructionSet( InstructionSet instructionSet ) {
+	InstructionSet supported = getSupportedInstructionSet();
+	activeInstructionSet() = instructionSet < supported ? instructionSet : supported;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Kernels
+//
+// Dispatch to the active instruction set.
+////////////////////////////////////////////////////////////////////////////////
+#if CORELIB_SIMD_AVX2
+#define CORELIB_CASE_AVX2( kernel, Ops, args ) case INSTRUCTIONS_AVX2: return Avx2::kernel< Avx2::Ops > args;
+#else
+#define CORELIB_CASE_AVX2( kernel, Ops, args )
+#endif
+#if CORELIB_SIMD_SSE2
+#define CORELIB_CASE_SSE2( kernel, Ops, args ) case INSTRUCTIONS_SSE2: return Sse2::kernel< Sse2::Ops > args;
+#else
+#define CORELIB_CASE_SSE2( kernel, Ops, args )
+#endif
+
+#define CORELIB_DEFINE_SIMD_KERNELS( T, Ops ) \
+	int findIndex( const T* data, size_t count, T value ) { \
+		switch( activeInstructionSet() ) { \
+			CORELIB_CASE_AVX2( findIndexKernel, Ops, ( data, count, value ) ) \
+			CORELIB_CASE_SSE2( findIndexKernel, Ops, ( data, count, value ) ) \
+			default: return Scalar::findIndex( data, count, value ); \
+		} \
+	} \
+	size_t count( const T* data, size_t count, T value ) { \
+		switch( activeInstructionSet() ) { \
+			CORELIB_CASE_AVX2( countKernel, Ops, ( data, count, value ) ) \
+			CORELIB_CASE_SSE2( countKernel, Ops, ( data, count, value ) ) \
+			default: return Scalar::count( data, count, value ); \
+		} \
+	} \
+	T min( const T* data, size_t count ) { \
+		assert( count > 0 ); \
+		switch( activeInstructionSet() ) { \
+			CORELIB_CASE_AVX2( minKernel, Ops, ( data, count ) ) \
+			CORELIB_CASE_SSE2( minKernel, Ops, ( data, count ) ) \
+			default: return Scalar::min( data, count ); \
+		} \
+	} \
+	T max( const T* data, size_t count ) { \
+		assert( count > 0 ); \
+		switch( activeInstructionSet() ) { \
+			CORELIB_CASE_AVX2( maxKernel, Ops, ( data, count ) ) \
+			CORELIB_CASE_SSE2( maxKernel, Ops, ( data, count ) ) \
+			default: return Scalar::max( data, count ); \
+		} \
+	} \
+	SumType< T >::type sum( const T* data, size_t count ) { \
+		switch( activeInstructionSet() ) { \
+			CORELIB_CASE_AVX2( sumKernel, Ops, ( data, count ) ) \
+			CORELIB_CASE_SSE2( sumKernel, Ops, ( data, count ) ) \
+			default: return Scalar::sum( data, count ); \
+		} \
+	}
+
+CORELIB_DEFINE_SIMD_KERNELS( int, IntOps )
+CORELIB_DEFINE_SIMD_KERNELS( unsigned int, UnsignedOps )
+CORELIB_DEFINE_SIMD_KERNELS( float, FloatOps )
+CORELIB_DEFINE_SIMD_KERNELS( double, DoubleOps )
+
+} // namespace Simd
+} // namespace Algorithms
+} // namespace CoreLib
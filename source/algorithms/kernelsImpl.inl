@@ -0,0 +1,138 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Vector kernels shared by every instruction set.
+//
+// Included by kernels.cpp once per instruction set, within a namespace 
+// defining the Ops structures and compiled for that instruction set. Ops 
+// expose:
+//
+//	Scalar, Vector, LANES
+//	Vector	load( const Scalar* )		unaligned load
+//	Vector	splat( Scalar )
+//	void	store( Scalar*, Vector )	unaligned store
+//	int		equalMask( a, b )			bit i set when lane i of a and b are equal
+//	Vector	min( acc, v ), max( acc, v )	lane wise, as Scalar::min / max would 
+//										update acc with v
+//	Vector	zero(), add( a, b )			floating point types only
+//////////////////////////////////////////////////////////////////////////
+
+template< class Ops >
+inline int findIndexKernel( const typename Ops::Scalar* data, size_t count, typename Ops::Scalar value ) {
+	const typename Ops::Vector target = Ops::splat( value );
+	size_t i = 0;
+	for( ; i + Ops::LANES <= count; i += Ops::LANES ) {
+		const int mask = Ops::equalMask( Ops::load( data + i ), target );
+		if ( mask != 0 ) {
+			return (int)( i + lowestBit( mask ) );
+		}
+	}
+	for( ; i < count; i++ ) {
+		if ( data[ i ] == value ) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+template< class Ops >
+inline size_t countKernel( const typename Ops::Scalar* data, size_t count, typename Ops::Scalar value ) {
+	const typename Ops::Vector target = Ops::splat( value );
+	size_t found = 0;
+	size_t i = 0;
+	for( ; i + Ops::LANES <= count; i += Ops::LANES ) {
+		found += bitCount( Ops::equalMask( Ops::load( data + i ), target ) );
+	}
+	for( ; i < count; i++ ) {
+		if ( data[ i ] == value ) {
+			found++;
+		}
+	}
+	return found;
+}
+
+// the tail is covered by a last load overlapping the previous one, which 
+// doesn't change the result of a min / max. Every lane starts from the 
+// first element, so that, as in Scalar::min / max, a NaN there is the 
+// result and NaNs anywhere else are skipped rather than sticking to their 
+// lane and hiding its other values.
+template< class Ops >
+inline typename Ops::Scalar minKernel( const typename Ops::Scalar* data, size_t count ) {
+	if ( count < Ops::LANES ) {
+		return Scalar::min( data, count );
+	}
+	typename Ops::Vector acc = Ops::splat( data[ 0 ] );
+	for( size_t i = 0; i + Ops::LANES <= count; i += Ops::LANES ) {
+		acc = Ops::min( acc, Ops::load( data + i ) );
+	}
+	acc = Ops::min( acc, Ops::load( data + count - Ops::LANES ) );
+
+	typename Ops::Scalar lanes[ Ops::LANES ];
+	Ops::store( lanes, acc );
+	return Scalar::min( lanes, Ops::LANES );
+}
+
+template< class Ops >
+inline typename Ops::Scalar maxKernel( const typename Ops::Scalar* data, size_t count ) {
+	if ( count < Ops::LANES ) {
+		return Scalar::max( data, count );
+	}
+	typename Ops::Vector acc = Ops::splat( data[ 0 ] );
+	for( size_t i = 0; i + Ops::LANES <= count; i += Ops::LANES ) {
+		acc = Ops::max( acc, Ops::load( data + i ) );
+	}
+	acc = Ops::max( acc, Ops::load( data + count - Ops::LANES ) );
+
+	typename Ops::Scalar lanes[ Ops::LANES ];
+	Ops::store( lanes, acc );
+	return Scalar::max( lanes, Ops::LANES );
+}
+
+// 8 interleaved partial sums, held in 8 / LANES vectors, reduced in the 
+// same order as Scalar::sum. Specialized for the integer types.
+template< class Ops >
+inline typename SumType< typename Ops::Scalar >::type sumKernel( const typename Ops::Scalar* data, size_t count ) {
+	typedef typename Ops::Scalar Scalar;
+	const size_t NUM_VECTORS = 8 / Ops::LANES;
+	typename Ops::Vector acc[ NUM_VECTORS ];
+	for( size_t k = 0; k < NUM_VECTORS; k++ ) {
+		acc[ k ] = Ops::zero();
+	}
+
+	size_t i = 0;
+	for( ; i + 8 <= count; i += 8 ) {
+		for( size_t k = 0; k < NUM_VECTORS; k++ ) {
+			acc[ k ] = Ops::add( acc[ k ], Ops::load( data + i + k * Ops::LANES ) );
+		}
+	}
+
+	Scalar partial[ 8 ];
+	for( size_t k = 0; k < NUM_VECTORS; k++ ) {
+		Ops::store( partial + k * Ops::LANES, acc[ k ] );
+	}
+	Scalar result = ( ( partial[ 0 ] + partial[ 4 ] ) + ( partial[ 2 ] + partial[ 6 ] ) ) + ( ( partial[ 1 ] + partial[ 5 ] ) + ( partial[ 3 ] + partial[ 7 ] ) );
+	for( ; i < count; i++ ) {
+		result = result + data[ i ];
+	}
+	return result;
+}
@@ -0,0 +1,316 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#include <containers/hashIndex/hashIndex.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <utility>
+
+namespace CoreLib {
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::HashIndex
+//
+// The memory is allocated on the first add. The hash size is rounded up to
+// a power of two.
+////////////////////////////////////////////////////////////////////////////////
+HashIndex::HashIndex( size_t initialHashSize, size_t initialIndexSize )
+	:	hash( NULL ),
+		indexChain( NULL ),
+		keys( NULL ),
+		hashSize( 1 ),
+		hashMask( 0 ),
+		indexSize( initialIndexSize ),
+		numEntries( 0 ) {
+	while( hashSize < initialHashSize ) {
+		hashSize <<= 1;
+	}
+	hashMask = hashSize - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::HashIndex( const HashIndex& )
+////////////////////////////////////////////////////////////////////////////////
+HashIndex::HashIndex( const HashIndex& other )
+	:	hash( NULL ),
+		indexChain( NULL ),
+		keys( NULL ),
+		hashSize( 1 ),
+		hashMask( 0 ),
+		indexSize( 0 ),
+		numEntries( 0 ) {
+	*this = other;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::HashIndex( HashIndex&& )
+//
+// Takes over the memory of the other index, which is left empty.
+////////////////////////////////////////////////////////////////////////////////
+HashIndex::HashIndex( HashIndex&& other )
+	:	hash( other.hash ),
+		indexChain( other.indexChain ),
+		keys( other.keys ),
+		hashSize( other.hashSize ),
+		hashMask( other.hashMask ),
+		indexSize( other.indexSize ),
+		numEntries( other.numEntries ) {
+	other.hash = NULL;
+	other.indexChain = NULL;
+	other.keys = NULL;
+	other.numEntries = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::~HashIndex
+////////////////////////////////////////////////////////////////////////////////
+HashIndex::~HashIndex() {
+	free();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::operator=( const HashIndex& )
+////////////////////////////////////////////////////////////////////////////////
+HashIndex& HashIndex::operator=( const HashIndex& other ) {
+	if ( this == &other ) {
+		return *this;
+	}
+	free();
+	hashSize = other.hashSize;
+	hashMask = other.hashMask;
+	indexSize = other.indexSize;
+	if ( other.hash == NULL ) {
+		return *this;
+	}
+
+	allocate();
+	if ( hash == NULL ) {
+		return *this;
+	}
+	memcpy( hash, other.hash, hashSize * sizeof( int ) );
+	memcpy( indexChain, other.indexChain, indexSize * sizeof( int ) );
+	memcpy( keys, other.keys, indexSize * sizeof( unsigned int ) );
+	numEntries = other.numEntries;
+	return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::operator=( HashIndex&& )
+////////////////////////////////////////////////////////////////////////////////
+HashIndex& HashIndex::operator=( HashIndex&& other ) {
+	if ( this != &other ) {
+		free();
+		swap( other );
+	}
+	return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::allocate
+////////////////////////////////////////////////////////////////////////////////
+void HashIndex::allocate() {
+	hash = (int*)malloc( hashSize * sizeof( int ) );
+	indexChain = (int*)malloc( indexSize * sizeof( int ) );
+	keys = (unsigned int*)malloc( indexSize * sizeof( unsigned int ) );
+	if ( hash == NULL || ( indexSize > 0 && ( indexChain == NULL || keys == NULL ) ) ) {
+		std::cerr << "HashIndex: out of memory" << std::endl;
+		assert( false );
+		free();
+		return;
+	}
+	// all bits set is -1
+	memset( hash, 0xFF, hashSize * sizeof( int ) );
+	memset( indexChain, 0xFF, indexSize * sizeof( int ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::add
+//
+// Links the index at the head of the bucket for the key. The index chain 
+// grows geometrically to accommodate the index, and the buckets double 
+// once there are as many entries as buckets.
+////////////////////////////////////////////////////////////////////////////////
+void HashIndex::add( unsigned int key, int index ) {
+	assert( index >= 0 );
+	if ( (size_t)index >= indexSize ) {
+		resizeIndex( (size_t)index + 1 > indexSize * 2 ? (size_t)index + 1 : indexSize * 2 );
+	}
+	if ( hash == NULL ) {
+		allocate();
+		if ( hash == NULL ) {
+			return;
+		}
+	}
+	if ( numEntries >= hashSize ) {
+		rehash( hashSize * 2 );
+	}
+
+	const size_t bucket = key & hashMask;
+	keys[ index ] = key;
+	indexChain[ index ] = hash[ bucket ];
+	hash[ bucket ] = index;
+	numEntries++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::remove
+//
+// Unlinks the index from the bucket of the key it was added with.
+////////////////////////////////////////////////////////////////////////////////
+void HashIndex::remove( int index ) {
+	assert( index >= 0 && (size_t)index < indexSize );
+	if ( hash == NULL ) {
+		return;
+	}
+
+	int* link = &hash[ keys[ index ] & hashMask ];
+	while( *link != index ) {
+		if ( *link == -1 ) {
+			// the index wasn't in the hash index
+			assert( false );
+			return;
+		}
+		link = &indexChain[ *link ];
+	}
+	*link = indexChain[ index ];
+	indexChain[ index ] = -1;
+	numEntries--;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::moveIndex
+//
+// Used when an element is moved within the indexed array, such as when 
+// the last element of a list fills the gap of a removed one.
+////////////////////////////////////////////////////////////////////////////////
+void HashIndex::moveIndex( int from, int to ) {
+	if ( from == to ) {
+		return;
+	}
+	const unsigned int key = keys[ from ];
+	remove( from );
+	add( key, to );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::rehash
+//
+// Relinks every entry into a new set of buckets.
+////////////////////////////////////////////////////////////////////////////////
+void HashIndex::rehash( size_t newHashSize ) {
+	int* newHash = (int*)malloc( newHashSize * sizeof( int ) );
+	if ( newHash == NULL ) {
+		// keep working with longer chains
+		assert( false );
+		return;
+	}
+	memset( newHash, 0xFF, newHashSize * sizeof( int ) );
+
+	const size_t newHashMask = newHashSize - 1;
+	for( size_t bucket = 0; bucket < hashSize; bucket++ ) {
+		int index = hash[ bucket ];
+		while( index != -1 ) {
+			const int nextIndex = indexChain[ index ];
+			const size_t newBucket = keys[ index ] & newHashMask;
+			indexChain[ index ] = newHash[ newBucket ];
+			newHash[ newBucket ] = index;
+			index = nextIndex;
+		}
+	}
+
+	::free( hash );
+	hash = newHash;
+	hashSize = newHashSize;
+	hashMask = newHashMask;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::resizeIndex
+////////////////////////////////////////////////////////////////////////////////
+void HashIndex::resizeIndex( size_t newIndexSize ) {
+	if ( newIndexSize <= indexSize ) {
+		return;
+	}
+	if ( hash == NULL ) {
+		// not allocated yet
+		indexSize = newIndexSize;
+		return;
+	}
+
+	int* newIndexChain = (int*)realloc( indexChain, newIndexSize * sizeof( int ) );
+	if ( newIndexChain == NULL ) {
+		std::cerr << "HashIndex: out of memory" << std::endl;
+		assert( false );
+		return;
+	}
+	indexChain = newIndexChain;
+	unsigned int* newKeys = (unsigned int*)realloc( keys, newIndexSize * sizeof( unsigned int ) );
+	if ( newKeys == NULL ) {
+		std::cerr << "HashIndex: out of memory" << std::endl;
+		assert( false );
+		return;
+	}
+	keys = newKeys;
+
+	memset( indexChain + indexSize, 0xFF, ( newIndexSize - indexSize ) * sizeof( int ) );
+	indexSize = newIndexSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::clear
+////////////////////////////////////////////////////////////////////////////////
+void HashIndex::clear() {
+	if ( hash != NULL ) {
+		memset( hash, 0xFF, hashSize * sizeof( int ) );
+		memset( indexChain, 0xFF, indexSize * sizeof( int ) );
+	}
+	numEntries = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::free
+////////////////////////////////////////////////////////////////////////////////
+void HashIndex::free() {
+	::free( hash );
+	::free( indexChain );
+	::free( keys );
+	hash = NULL;
+	indexChain = NULL;
+	keys = NULL;
+	numEntries = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HashIndex::swap
+////////////////////////////////////////////////////////////////////////////////
+void HashIndex::swap( HashIndex& other ) {
+	std::swap( hash, other.hash );
+	std::swap( indexChain, other.indexChain );
+	std::swap( keys, other.keys );
+	std::swap( hashSize, other.hashSize );
+	std::swap( hashMask, other.hashMask );
+	std::swap( indexSize, other.indexSize );
+	std::swap( numEntries, other.numEntries );
+}
+
+} // namespace CoreLib
@@ -0,0 +1,247 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#include <containers/list/listFile.h>
+#include <memory/alignment.h>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+
+namespace CoreLib {
+
+static const uint64_t CHECKSUM_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+
+static inline uint64_t checksumMix( uint64_t hash, uint64_t word ) {
+	hash = ( hash ^ word ) * CHECKSUM_MULTIPLIER;
+	return hash ^ ( hash >> 29 );
+}
+
+static inline size_t alignOffset( size_t offset, size_t alignment ) {
+	return ( offset + alignment - 1 ) & ~( alignment - 1 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// listFileChecksum
+////////////////////////////////////////////////////////////////////////////////
+uint64_t listFileChecksum( const void* data, size_t bytes ) {
+	ListFileChecksum checksum;
+	checksum.update( data, bytes );
+	return checksum.finish();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListFileChecksum::ListFileChecksum
+////////////////////////////////////////////////////////////////////////////////
+ListFileChecksum::ListFileChecksum()
+	:	pendingBytes( 0 ),
+		totalBytes( 0 ) {
+	lanes[ 0 ] = 1;
+	lanes[ 1 ] = 2;
+	lanes[ 2 ] = 3;
+	lanes[ 3 ] = 4;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListFileChecksum::update
+//
+// Mixes 32 byte blocks, as 8 byte words, into four independent lanes so 
+// that the multiplies overlap and large files are checked at memory speed.
+// Incomplete blocks are held back until more data comes in.
+////////////////////////////////////////////////////////////////////////////////
+void ListFileChecksum::update( const void* data, size_t bytes ) {
+	const unsigned char* src = static_cast< const unsigned char* >( data );
+	totalBytes += bytes;
+
+	if ( pendingBytes > 0 ) {
+		const size_t missing = sizeof( pending ) - pendingBytes;
+		const size_t taken = bytes < missing ? bytes : missing;
+		memcpy( pending + pendingBytes, src, taken );
+		pendingBytes += taken;
+		src += taken;
+		bytes -= taken;
+		if ( pendingBytes < sizeof( pending ) ) {
+			return;
+		}
+		uint64_t words[ 4 ];
+		memcpy( words, pending, sizeof( words ) );
+		for( size_t lane = 0; lane < 4; lane++ ) {
+			lanes[ lane ] = checksumMix( lanes[ lane ], words[ lane ] );
+		}
+		pendingBytes = 0;
+	}
+
+	size_t i = 0;
+	for( ; i + 32 <= bytes; i += 32 ) {
+		uint64_t words[ 4 ];
+		memcpy( words, src + i, sizeof( words ) );
+		lanes[ 0 ] = checksumMix( lanes[ 0 ], words[ 0 ] );
+		lanes[ 1 ] = checksumMix( lanes[ 1 ], words[ 1 ] );
+		lanes[ 2 ] = checksumMix( lanes[ 2 ], words[ 2 ] );
+		lanes[ 3 ] = checksumMix( lanes[ 3 ], words[ 3 ] );
+	}
+	memcpy( pending, src + i, bytes - i );
+	pendingBytes = bytes - i;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListFileChecksum::finish
+//
+// The last incomplete block is mixed in as zero padded words.
+////////////////////////////////////////////////////////////////////////////////
+uint64_t ListFileChecksum::finish() const {
+	uint64_t result[ 4 ] = { lanes[ 0 ], lanes[ 1 ], lanes[ 2 ], lanes[ 3 ] };
+	for( size_t i = 0, lane = 0; i < pendingBytes; i += 8, lane++ ) {
+		uint64_t word = 0;
+		memcpy( &word, pending + i, pendingBytes - i < 8 ? pendingBytes - i : 8 );
+		result[ lane ] = checksumMix( result[ lane ], word );
+	}
+
+	uint64_t hash = checksumMix( totalBytes, result[ 0 ] );
+	hash = checksumMix( hash, result[ 1 ] );
+	hash = checksumMix( hash, result[ 2 ] );
+	return checksumMix( hash, result[ 3 ] );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// listFileDataOffset
+//
+// The elements start on a multiple of their alignment and of the cache line
+// size.
+////////////////////////////////////////////////////////////////////////////////
+size_t listFileDataOffset( size_t elementAlignment ) {
+	const size_t alignment = elementAlignment > Memory::CACHE_LINE_SIZE ? elementAlignment : Memory::CACHE_LINE_SIZE;
+	return alignOffset( sizeof( ListFileHeader ), alignment );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// makeListFileHeader
+////////////////////////////////////////////////////////////////////////////////
+ListFileHeader makeListFileHeader( size_t count, size_t elementSize, size_t elementAlignment, uint32_t userVersion, uint64_t dataChecksum ) {
+	assert( elementSize > 0 );
+	assert( Memory::isPowerOfTwo( elementAlignment ) );
+
+	ListFileHeader header;
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.magic, LIST_FILE_MAGIC, sizeof( header.magic ) );
+	header.formatVersion	= LIST_FILE_VERSION;
+	header.byteOrder		= LIST_FILE_BYTE_ORDER;
+	header.elementSize		= elementSize;
+	header.elementAlignment	= elementAlignment;
+	header.count			= count;
+	header.dataOffset		= listFileDataOffset( elementAlignment );
+	header.userVersion		= userVersion;
+	header.dataChecksum		= dataChecksum;
+	header.headerChecksum	= listFileChecksum( &header, offsetof( ListFileHeader, headerChecksum ) );
+	return header;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// replaceFile
+////////////////////////////////////////////////////////////////////////////////
+bool replaceFile( const char* temporaryPath, const char* path ) {
+#if defined( _WIN32 )
+	// rename doesn't replace existing files on Windows
+	remove( path );
+#endif
+	if ( rename( temporaryPath, path ) != 0 ) {
+		std::cerr << "Failed to replace " << path << std::endl;
+		remove( temporaryPath );
+		return false;
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// writeListFile
+////////////////////////////////////////////////////////////////////////////////
+bool writeListFile( const char* path, const void* elements, size_t count, size_t elementSize, size_t elementAlignment, uint32_t userVersion ) {
+	const size_t dataBytes = count * elementSize;
+	const ListFileHeader header = makeListFileHeader( count, elementSize, elementAlignment, userVersion, listFileChecksum( elements, dataBytes ) );
+
+	const std::string temporaryPath = std::string( path ) + ".tmp";
+	FILE* file = fopen( temporaryPath.c_str(), "wb" );
+	if ( file == NULL ) {
+		std::cerr << "Failed to create " << temporaryPath << std::endl;
+		return false;
+	}
+
+	static const char padding[ Memory::CACHE_LINE_SIZE ] = {};
+	size_t paddingBytes = (size_t)header.dataOffset - sizeof( header );
+	bool written = fwrite( &header, sizeof( header ), 1, file ) == 1;
+	while( written && paddingBytes > 0 ) {
+		const size_t chunk = paddingBytes < sizeof( padding ) ? paddingBytes : sizeof( padding );
+		written = fwrite( padding, 1, chunk, file ) == chunk;
+		paddingBytes -= chunk;
+	}
+	written = written && ( dataBytes == 0 || fwrite( elements, 1, dataBytes, file ) == dataBytes );
+	written = fclose( file ) == 0 && written;
+	if ( !written ) {
+		std::cerr << "Failed to write " << temporaryPath << std::endl;
+		remove( temporaryPath.c_str() );
+		return false;
+	}
+
+	return replaceFile( temporaryPath.c_str(), path );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// validateListFile
+////////////////////////////////////////////////////////////////////////////////
+const ListFileHeader* validateListFile( const void* file, size_t fileSize, size_t elementSize, size_t elementAlignment, uint32_t userVersion, bool verifyChecksum ) {
+	if ( file == NULL || fileSize < sizeof( ListFileHeader ) ) {
+		std::cerr << "Invalid list file: too small" << std::endl;
+		return NULL;
+	}
+
+	const ListFileHeader* header = static_cast< const ListFileHeader* >( file );
+	if ( memcmp( header->magic, LIST_FILE_MAGIC, sizeof( header->magic ) ) != 0 ) {
+		std::cerr << "Invalid list file: bad magic" << std::endl;
+		return NULL;
+	}
+	if ( header->formatVersion != LIST_FILE_VERSION || header->byteOrder != LIST_FILE_BYTE_ORDER ) {
+		std::cerr << "Invalid list file: format version " << header->formatVersion << " or byte order not supported" << std::endl;
+		return NULL;
+	}
+	if ( header->headerChecksum != listFileChecksum( header, offsetof( ListFileHeader, headerChecksum ) ) ) {
+		std::cerr << "Invalid list file: corrupt header" << std::endl;
+		return NULL;
+	}
+	if ( header->elementSize != elementSize || header->elementAlignment != elementAlignment || header->userVersion != userVersion ) {
+		std::cerr << "List file doesn't match the element type: size " << header->elementSize << ", alignment " << header->elementAlignment << ", version " << header->userVersion 
+			<< " (expected " << elementSize << ", " << elementAlignment << ", " << userVersion << ")" << std::endl;
+		return NULL;
+	}
+	if ( header->dataOffset < sizeof( ListFileHeader ) || header->dataOffset % elementAlignment != 0 || header->dataOffset > fileSize ||
+		header->count > ( fileSize - header->dataOffset ) / elementSize ) {
+		std::cerr << "Invalid list file: truncated" << std::endl;
+		return NULL;
+	}
+	if ( verifyChecksum && header->dataChecksum != listFileChecksum( static_cast< const char* >( file ) + header->dataOffset, (size_t)( header->count * elementSize ) ) ) {
+		std::cerr << "Invalid list file: corrupt elements" << std::endl;
+		return NULL;
+	}
+	return header;
+}
+
+} // namespace CoreLib
@@ -0,0 +1,427 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#include <containers/list/listStream.h>
+#include <memory/alignment.h>
+#include <assert.h>
+#include <string.h>
+#include <iostream>
+
+#if defined( __linux__ )
+#include <fcntl.h>
+#endif
+
+namespace CoreLib {
+
+static inline size_t bufferAlignment( size_t elementAlignment ) {
+	return elementAlignment > Memory::CACHE_LINE_SIZE ? elementAlignment : Memory::CACHE_LINE_SIZE;
+}
+
+static inline size_t chunkElementsFor( size_t chunkBytes, size_t elementSize ) {
+	return chunkBytes >= elementSize ? chunkBytes / elementSize : 1;
+}
+
+// 64 bit file offsets, the files are expected to be larger than memory
+static bool seekFile( FILE* file, uint64_t offset ) {
+#if defined( _WIN32 )
+	return _fseeki64( file, (__int64)offset, SEEK_SET ) == 0;
+#else
+	return fseeko( file, (off_t)offset, SEEK_SET ) == 0;
+#endif
+}
+
+static bool getFileSize( FILE* file, uint64_t& size ) {
+#if defined( _WIN32 )
+	const bool found = _fseeki64( file, 0, SEEK_END ) == 0 && ( size = (uint64_t)_ftelli64( file ) ) != (uint64_t)-1;
+#else
+	const bool found = fseeko( file, 0, SEEK_END ) == 0 && ( size = (uint64_t)ftello( file ) ) != (uint64_t)-1;
+#endif
+	return found && seekFile( file, 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamWriterBase::ListStreamWriterBase
+////////////////////////////////////////////////////////////////////////////////
+ListStreamWriterBase::ListStreamWriterBase()
+	:	file( NULL ),
+		elementSize( 0 ),
+		elementAlignment( 0 ),
+		userVersion( 0 ),
+		chunkElements( 0 ),
+		fillBuffer( 0 ),
+		count( 0 ),
+		queued( NULL ),
+		queuedBytes( 0 ),
+		stopping( false ),
+		failed( false ) {
+	buffers[ 0 ] = buffers[ 1 ] = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamWriterBase::~ListStreamWriterBase
+//
+// The derived writer closes the stream, so there's nothing left to do here
+// but in the case of a stream abandoned halfway through.
+////////////////////////////////////////////////////////////////////////////////
+ListStreamWriterBase::~ListStreamWriterBase() {
+	if ( file != NULL ) {
+		closeStream( 0 );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamWriterBase::openStream
+//
+// Creates a temporary file next to path, leaving room for the header, 
+// which can only be written once the element count and checksum are known.
+////////////////////////////////////////////////////////////////////////////////
+void* ListStreamWriterBase::openStream( const char* newPath, size_t newElementSize, size_t newElementAlignment, uint32_t newUserVersion, size_t chunkBytes ) {
+	assert( file == NULL );
+	assert( newElementSize > 0 );
+
+	path				= newPath;
+	temporaryPath		= path + ".tmp";
+	elementSize			= newElementSize;
+	elementAlignment	= newElementAlignment;
+	userVersion			= newUserVersion;
+	chunkElements		= chunkElementsFor( chunkBytes, elementSize );
+
+	file = fopen( temporaryPath.c_str(), "wb" );
+	if ( file == NULL ) {
+		std::cerr << "Failed to create " << temporaryPath << std::endl;
+		return NULL;
+	}
+	// the chunks are large, skip the copy through the stdio buffer
+	setvbuf( file, NULL, _IONBF, 0 );
+
+	static const char zeros[ Memory::CACHE_LINE_SIZE * 2 ] = {};
+	const size_t dataOffset = listFileDataOffset( elementAlignment );
+	for( size_t written = 0; written < dataOffset; ) {
+		const size_t bytes = dataOffset - written < sizeof( zeros ) ? dataOffset - written : sizeof( zeros );
+		if ( fwrite( zeros, 1, bytes, file ) != bytes ) {
+			std::cerr << "Failed to write " << temporaryPath << std::endl;
+			fclose( file );
+			file = NULL;
+			remove( temporaryPath.c_str() );
+			return NULL;
+		}
+		written += bytes;
+	}
+
+	const size_t alignment = bufferAlignment( elementAlignment );
+	buffers[ 0 ] = Memory::alignedAlloc( chunkElements * elementSize, alignment );
+	buffers[ 1 ] = Memory::alignedAlloc( chunkElements * elementSize, alignment );
+	fillBuffer	= 0;
+	count		= 0;
+	queued		= NULL;
+	queuedBytes	= 0;
+	stopping	= false;
+	failed		= false;
+	checksum	= ListFileChecksum();
+
+	thread = std::thread( &ListStreamWriterBase::writeLoop, this );
+	return buffers[ fillBuffer ];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamWriterBase::submitChunk
+//
+// Hands the filled buffer over to the writing thread, once it's done with 
+// the previous one, and returns that previous buffer to be filled next.
+////////////////////////////////////////////////////////////////////////////////
+void* ListStreamWriterBase::submitChunk( size_t chunkCount ) {
+	assert( chunkCount <= chunkElements );
+	std::unique_lock< std::mutex > lock( mutex );
+	condition.wait( lock, [ this ]() { return queued == NULL; } );
+	queued		= buffers[ fillBuffer ];
+	queuedBytes	= chunkCount * elementSize;
+	count		+= chunkCount;
+	condition.notify_all();
+
+	fillBuffer ^= 1;
+	return buffers[ fillBuffer ];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamWriterBase::closeStream
+//
+// Writes the last chunk, waits for the writing thread to finish, and then 
+// completes the header and moves the file to its final path. On failure 
+// the temporary file is removed.
+////////////////////////////////////////////////////////////////////////////////
+bool ListStreamWriterBase::closeStream( size_t lastCount ) {
+	assert( file != NULL );
+	if ( lastCount > 0 ) {
+		submitChunk( lastCount );
+	}
+	{
+		std::unique_lock< std::mutex > lock( mutex );
+		stopping = true;
+		condition.notify_all();
+	}
+	thread.join();
+
+	bool written = !failed;
+	if ( written ) {
+		const ListFileHeader header = makeListFileHeader( (size_t)count, elementSize, elementAlignment, userVersion, checksum.finish() );
+		written = seekFile( file, 0 ) && fwrite( &header, sizeof( header ), 1, file ) == 1;
+	}
+	written = fclose( file ) == 0 && written;
+	file = NULL;
+
+	if ( written ) {
+		written = replaceFile( temporaryPath.c_str(), path.c_str() );
+	} else {
+		std::cerr << "Failed to write " << temporaryPath << std::endl;
+		remove( temporaryPath.c_str() );
+	}
+
+	releaseStream();
+	return written;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamWriterBase::releaseStream
+////////////////////////////////////////////////////////////////////////////////
+void ListStreamWriterBase::releaseStream() {
+	const size_t alignment = bufferAlignment( elementAlignment );
+	Memory::alignedFree( buffers[ 0 ], alignment );
+	Memory::alignedFree( buffers[ 1 ], alignment );
+	buffers[ 0 ] = buffers[ 1 ] = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamWriterBase::writeLoop
+//
+// Background thread: writes each queued buffer and accumulates the checksum
+// of the elements, until the stream is closed.
+////////////////////////////////////////////////////////////////////////////////
+void ListStreamWriterBase::writeLoop() {
+	std::unique_lock< std::mutex > lock( mutex );
+	for( ;; ) {
+		condition.wait( lock, [ this ]() { return queued != NULL || stopping; } );
+		if ( queued == NULL ) {
+			return;
+		}
+
+		const void* data = queued;
+		const size_t bytes = queuedBytes;
+		const bool skip = failed;
+		lock.unlock();
+
+		bool written = true;
+		if ( !skip ) {
+			written = fwrite( data, 1, bytes, file ) == bytes;
+			checksum.update( data, bytes );
+		}
+
+		lock.lock();
+		failed = failed || !written;
+		queued = NULL;
+		condition.notify_all();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamReaderBase::ListStreamReaderBase
+////////////////////////////////////////////////////////////////////////////////
+ListStreamReaderBase::ListStreamReaderBase()
+	:	file( NULL ),
+		chunkElements( 0 ),
+		numChunks( 0 ),
+		verifyChecksum( false ),
+		requested( 0 ),
+		filled( 0 ),
+		released( 0 ),
+		stopping( false ),
+		failed( false ) {
+	memset( &header, 0, sizeof( header ) );
+	buffers[ 0 ] = buffers[ 1 ] = NULL;
+	bufferCounts[ 0 ] = bufferCounts[ 1 ] = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamReaderBase::~ListStreamReaderBase
+////////////////////////////////////////////////////////////////////////////////
+ListStreamReaderBase::~ListStreamReaderBase() {
+	closeStream();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamReaderBase::openStream
+//
+// Reads and validates the header, and starts the thread reading ahead.
+////////////////////////////////////////////////////////////////////////////////
+bool ListStreamReaderBase::openStream( const char* path, size_t elementSize, size_t elementAlignment, uint32_t userVersion, size_t chunkBytes, bool verify ) {
+	closeStream();
+
+	file = fopen( path, "rb" );
+	if ( file == NULL ) {
+		std::cerr << "Failed to open " << path << std::endl;
+		return false;
+	}
+	setvbuf( file, NULL, _IONBF, 0 );
+#if defined( __linux__ )
+	posix_fadvise( fileno( file ), 0, 0, POSIX_FADV_SEQUENTIAL );
+#endif
+
+	// validate the header against the actual file size, so that truncated 
+	// files are refused up front
+	uint64_t fileSize = 0;
+	const bool valid = getFileSize( file, fileSize ) && fileSize >= sizeof( header ) && fread( &header, sizeof( header ), 1, file ) == 1 &&
+		validateListFile( &header, (size_t)fileSize, elementSize, elementAlignment, userVersion, false ) != NULL &&
+		seekFile( file, header.dataOffset );
+	if ( !valid ) {
+		std::cerr << "Can't stream " << path << std::endl;
+		fclose( file );
+		file = NULL;
+		memset( &header, 0, sizeof( header ) );
+		return false;
+	}
+
+	chunkElements	= chunkElementsFor( chunkBytes, elementSize );
+	numChunks		= (size_t)( ( header.count + chunkElements - 1 ) / chunkElements );
+	verifyChecksum	= verify;
+	requested		= 0;
+	filled			= 0;
+	released		= 0;
+	stopping		= false;
+	failed			= false;
+
+	const size_t alignment = bufferAlignment( elementAlignment );
+	buffers[ 0 ] = Memory::alignedAlloc( chunkElements * elementSize, alignment );
+	buffers[ 1 ] = Memory::alignedAlloc( chunkElements * elementSize, alignment );
+
+	thread = std::thread( &ListStreamReaderBase::readLoop, this );
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamReaderBase::closeStream
+//
+// Stops reading ahead and closes the file.
+////////////////////////////////////////////////////////////////////////////////
+void ListStreamReaderBase::closeStream() {
+	if ( file == NULL ) {
+		return;
+	}
+	{
+		std::unique_lock< std::mutex > lock( mutex );
+		stopping = true;
+		condition.notify_all();
+	}
+	thread.join();
+	fclose( file );
+	file = NULL;
+
+	const size_t alignment = bufferAlignment( (size_t)header.elementAlignment );
+	Memory::alignedFree( buffers[ 0 ], alignment );
+	Memory::alignedFree( buffers[ 1 ], alignment );
+	buffers[ 0 ] = buffers[ 1 ] = NULL;
+	memset( &header, 0, sizeof( header ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamReaderBase::nextChunk
+//
+// Releases the chunk handed out last, letting the reading thread reuse its
+// buffer, and waits for the next one.
+////////////////////////////////////////////////////////////////////////////////
+const void* ListStreamReaderBase::nextChunk( size_t& chunkCount ) {
+	chunkCount = 0;
+	if ( file == NULL ) {
+		return NULL;
+	}
+
+	std::unique_lock< std::mutex > lock( mutex );
+	released = requested;
+	condition.notify_all();
+	if ( requested == numChunks ) {
+		return NULL;
+	}
+
+	condition.wait( lock, [ this ]() { return filled > requested || failed; } );
+	if ( filled <= requested ) {
+		return NULL;
+	}
+
+	const size_t buffer = requested % 2;
+	chunkCount = bufferCounts[ buffer ];
+	requested++;
+	return buffers[ buffer ];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamReaderBase::hasStreamFailed
+////////////////////////////////////////////////////////////////////////////////
+bool ListStreamReaderBase::hasStreamFailed() {
+	std::unique_lock< std::mutex > lock( mutex );
+	return failed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ListStreamReaderBase::readLoop
+//
+// Background thread: reads the chunks in order, staying at most two chunks
+// ahead of the caller, one per buffer.
+////////////////////////////////////////////////////////////////////////////////
+void ListStreamReaderBase::readLoop() {
+	const size_t elementSize = (size_t)header.elementSize;
+	ListFileChecksum checksum;
+
+	for( size_t chunk = 0; chunk < numChunks; chunk++ ) {
+		{
+			std::unique_lock< std::mutex > lock( mutex );
+			condition.wait( lock, [ this, chunk ]() { return chunk < released + 2 || stopping; } );
+			if ( stopping ) {
+				return;
+			}
+		}
+
+		const uint64_t first = (uint64_t)chunk * chunkElements;
+		const size_t chunkCount = header.count - first < chunkElements ? (size_t)( header.count - first ) : chunkElements;
+		void* buffer = buffers[ chunk % 2 ];
+		bool valid = fread( buffer, elementSize, chunkCount, file ) == chunkCount;
+		if ( !valid ) {
+			std::cerr << "Failed to read list file chunk " << chunk << std::endl;
+		}
+		if ( valid && verifyChecksum ) {
+			checksum.update( buffer, chunkCount * elementSize );
+			if ( chunk + 1 == numChunks && checksum.finish() != header.dataChecksum ) {
+				std::cerr << "Invalid list file: corrupt elements" << std::endl;
+				valid = false;
+			}
+		}
+
+		std::unique_lock< std::mutex > lock( mutex );
+		if ( !valid ) {
+			failed = true;
+			condition.notify_all();
+			return;
+		}
+		bufferCounts[ chunk % 2 ] = chunkCount;
+		filled = chunk + 1;
+		condition.notify_all();
+	}
+}
+
+} // namespace CoreLib
@@ -0,0 +1,491 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#include <jobs/jobSystem.h>
+#include <memory/alignment.h>
+#include <memory/threadCachingPool.h>
+#include <stdint.h>
+#include <assert.h>
+
+namespace CoreLib {
+namespace Jobs {
+
+////////////////////////////////////////////////////////////////////////////////
+// JobDeque
+//
+// Fixed capacity Chase-Lev deque. The owning worker pushes and pops jobs at 
+// the bottom, any thread may steal them from the top. The seq_cst accesses
+// to top and bottom order the owner's pop against concurrent steals when a 
+// single job is left.
+////////////////////////////////////////////////////////////////////////////////
+class JobDeque {
+public:
+	static const int64_t CAPACITY = 4096;
+
+	JobDeque() : top( 0 ), bottom( 0 ) {
+		for( int64_t i = 0; i < CAPACITY; i++ ) {
+			slots[ i ].store( NULL, std::memory_order_relaxed );
+		}
+	}
+
+	// owner only, returns false if the deque is full
+	bool push( Job* job ) {
+		const int64_t b = bottom.load( std::memory_order_relaxed );
+		const int64_t t = top.load( std::memory_order_acquire );
+		if ( b - t >= CAPACITY ) {
+			return false;
+		}
+		slots[ b & ( CAPACITY - 1 ) ].store( job, std::memory_order_relaxed );
+		bottom.store( b + 1, std::memory_order_seq_cst );
+		return true;
+	}
+
+	// owner only, returns the newest job
+	Job* pop() {
+		const int64_t b = bottom.load( std::memory_order_relaxed ) - 1;
+		bottom.store( b, std::memory_order_seq_cst );
+		int64_t t = top.load( std::memory_order_seq_cst );
+		if ( t > b ) {
+			bottom.store( b + 1, std::memory_order_relaxed );
+			return NULL;
+		}
+		Job* job = slots[ b & ( CAPACITY - 1 ) ].load( std::memory_order_relaxed );
+		if ( t == b ) {
+			// last job, race the thieves for it
+			if ( !top.compare_exchange_strong( t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) ) {
+				job = NULL;
+			}
+			bottom.store( b + 1, std::memory_order_relaxed );
+		}
+		return job;
+	}
+
+	// any thread, returns the oldest job
+	Job* steal() {
+		int64_t t = top.load( std::memory_order_seq_cst );
+		const int64_t b = bottom.load( std::memory_order_seq_cst );
+		if ( t >= b ) {
+			return NULL;
+		}
+		Job* job = slots[ t & ( CAPACITY - 1 ) ].load( std::memory_order_relaxed );
+		if ( !top.compare_exchange_strong( t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) ) {
+			return NULL;
+		}
+		return job;
+	}
+
+	bool empty() const {
+		return top.load( std::memory_order_seq_cst ) >= bottom.load( std::memory_order_seq_cst );
+	}
+
+private:
+	// top is written by the thieves, bottom by the owner
+	std::atomic< int64_t >	top;
+	char					padding[ Memory::CACHE_LINE_SIZE ];
+	std::atomic< int64_t >	bottom;
+	std::atomic< Job* >		slots[ CAPACITY ];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::Worker
+////////////////////////////////////////////////////////////////////////////////
+struct JobSystem::Worker {
+	JobSystem*			system;
+	JobDeque			deque;
+	Memory::MemoryPool	scratch;
+	uint32_t			random;		// xorshift state picking the victims to steal from
+
+	Worker( JobSystem* system, size_t index, size_t scratchBytes )
+		:	system( system ),
+			scratch( scratchBytes ),
+			random( (uint32_t)index * 2654435761u + 1 ) {
+	}
+
+	uint32_t nextRandom() {
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+		return random;
+	}
+};
+
+// worker run by the calling thread
+static thread_local JobSystem::Worker* currentWorker = NULL;
+
+////////////////////////////////////////////////////////////////////////////////
+// JobCounter::~JobCounter
+//
+// The thread finishing the last job may still be releasing the counter's 
+// lock after it is seen done, wait for it before the mutex goes away.
+////////////////////////////////////////////////////////////////////////////////
+JobCounter::~JobCounter() {
+	std::lock_guard< std::mutex > lock( mutex );
+	assert( pending.load( std::memory_order_relaxed ) == 0 && continuations == NULL );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::JobSystem
+////////////////////////////////////////////////////////////////////////////////
+JobSystem::JobSystem( size_t numThreads, size_t scratchBytes )
+	:	numWorkers( numThreads > 0 ? numThreads : std::thread::hardware_concurrency() ),
+		workers( NULL ),
+		previousWorker( currentWorker ),
+		submittedHead( NULL ),
+		submittedTail( NULL ),
+		numSubmitted( 0 ),
+		numSleeping( 0 ),
+		stopping( false ),
+		numWaiting( 0 ) {
+	if ( numWorkers == 0 ) {
+		numWorkers = 1;
+	}
+
+	workers = new Worker*[ numWorkers ];
+	for( size_t i = 0; i < numWorkers; i++ ) {
+		workers[ i ] = new Worker( this, i, scratchBytes );
+	}
+
+	currentWorker = workers[ 0 ];
+	for( size_t i = 1; i < numWorkers; i++ ) {
+		threads.push_back( std::thread( &JobSystem::workerLoop, this, workers[ i ] ) );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::~JobSystem
+////////////////////////////////////////////////////////////////////////////////
+JobSystem::~JobSystem() {
+	assert( currentWorker == workers[ 0 ] );
+	{
+		std::lock_guard< std::mutex > lock( sleepMutex );
+		stopping = true;
+	}
+	sleepCondition.notify_all();
+	for( size_t i = 0; i < threads.size(); i++ ) {
+		threads[ i ].join();
+	}
+
+	assert( submittedHead == NULL );
+	for( size_t i = 0; i < numWorkers; i++ ) {
+		assert( workers[ i ]->deque.empty() );
+		delete workers[ i ];
+	}
+	delete[] workers;
+	currentWorker = previousWorker;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::wait
+//
+// Workers run jobs (their own first, then stolen ones) until the counter 
+// is done, so that waiting from inside a job never leaves its thread idle. 
+// Other threads block until the last job of the counter wakes them.
+////////////////////////////////////////////////////////////////////////////////
+void JobSystem::wait( JobCounter& counter ) {
+	Worker* worker = getCurrentWorker();
+	if ( worker != NULL ) {
+		while ( !counter.isDone() ) {
+			Job* job = findJob( worker );
+			if ( job != NULL ) {
+				execute( job, worker );
+			} else {
+				std::this_thread::yield();
+			}
+		}
+		return;
+	}
+
+	std::unique_lock< std::mutex > lock( waitMutex );
+	numWaiting.fetch_add( 1, std::memory_order_seq_cst );
+	while ( counter.pending.load( std::memory_order_seq_cst ) != 0 ) {
+		waitCondition.wait( lock );
+	}
+	numWaiting.fetch_sub( 1, std::memory_order_relaxed );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::autoGrain
+//
+// Splits count in a few pieces per worker, enough for the idle workers to 
+// balance uneven pieces by stealing, without splitting further than 
+// minGrain. A single worker runs the range in one piece.
+////////////////////////////////////////////////////////////////////////////////
+size_t JobSystem::autoGrain( size_t count, size_t minGrain ) const {
+	if ( numWorkers == 1 ) {
+		return count > 0 ? count : 1;
+	}
+	const size_t grain = ( count + numWorkers * GRAIN_PIECES_PER_WORKER - 1 ) / ( numWorkers * GRAIN_PIECES_PER_WORKER );
+	if ( minGrain == 0 ) {
+		minGrain = 1;
+	}
+	return grain > minGrain ? grain : minGrain;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::getScratchPool
+////////////////////////////////////////////////////////////////////////////////
+Memory::MemoryPool* JobSystem::getScratchPool() {
+	return currentWorker != NULL ? &currentWorker->scratch : NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::allocateJob
+//
+// Jobs come from the thread caching pool, as they are often released by a 
+// different thread than the one which started them.
+////////////////////////////////////////////////////////////////////////////////
+Job* JobSystem::allocateJob( JobCounter& counter ) {
+	Job* job = static_cast< Job* >( Memory::ThreadCachingPool::getDefault().allocBytes( sizeof( Job ), std::alignment_of< Job >::value ) );
+	assert( job != NULL );
+	job->counter = &counter;
+	job->next = NULL;
+	counter.pending.fetch_add( 1, std::memory_order_relaxed );
+	return job;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::submit
+//
+// Makes the job available to the workers. A worker whose deque is full runs
+// the job right away instead.
+////////////////////////////////////////////////////////////////////////////////
+void JobSystem::submit( Job* job ) {
+	Worker* worker = getCurrentWorker();
+	if ( worker != NULL ) {
+		if ( !worker->deque.push( job ) ) {
+			execute( job, worker );
+			return;
+		}
+	} else {
+		std::lock_guard< std::mutex > lock( submitMutex );
+		if ( submittedTail != NULL ) {
+			submittedTail->next = job;
+		} else {
+			submittedHead = job;
+		}
+		submittedTail = job;
+		numSubmitted.fetch_add( 1, std::memory_order_seq_cst );
+	}
+	wakeWorker();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::schedule
+//
+// Submits the job once the dependency is done. Continuations are added 
+// under the counter's lock, which is also held while the counter reaches 
+// zero, so they are either submitted here or by the last job of the 
+// dependency.
+////////////////////////////////////////////////////////////////////////////////
+void JobSystem::schedule( Job* job, JobCounter& dependency ) {
+	{
+		std::lock_guard< std::mutex > lock( dependency.mutex );
+		if ( dependency.pending.load( std::memory_order_acquire ) != 0 ) {
+			job->next = dependency.continuations;
+			dependency.continuations = job;
+			return;
+		}
+	}
+	submit( job );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::execute
+//
+// Runs the job, releasing the scratch memory it used, and signals its 
+// counter.
+////////////////////////////////////////////////////////////////////////////////
+void JobSystem::execute( Job* job, Worker* worker ) {
+	const size_t marker = worker->scratch.mark();
+	job->execute( job );
+	worker->scratch.rewind( marker );
+
+	JobCounter* counter = job->counter;
+	Memory::ThreadCachingPool::getDefault().freeBytes( job, sizeof( Job ) );
+	finish( counter );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::finish
+//
+// Decrements the counter of a completed job. Jobs other than the last one
+// of the counter only touch the pending count; the last one takes the lock
+// to submit the continuations, and wakes the threads blocked in wait. The 
+// counter may be destroyed as soon as it is released.
+////////////////////////////////////////////////////////////////////////////////
+void JobSystem::finish( JobCounter* counter ) {
+	size_t pending = counter->pending.load( std::memory_order_relaxed );
+	while ( pending > 1 ) {
+		if ( counter->pending.compare_exchange_weak( pending, pending - 1, std::memory_order_acq_rel, std::memory_order_relaxed ) ) {
+			return;
+		}
+	}
+
+	Job* ready;
+	{
+		std::lock_guard< std::mutex > lock( counter->mutex );
+		if ( counter->pending.fetch_sub( 1, std::memory_order_seq_cst ) != 1 ) {
+			return; // more jobs were started meanwhile
+		}
+		ready = counter->continuations;
+		counter->continuations = NULL;
+	}
+
+	if ( numWaiting.load( std::memory_order_seq_cst ) > 0 ) {
+		{
+			std::lock_guard< std::mutex > lock( waitMutex );
+		}
+		waitCondition.notify_all();
+	}
+
+	while ( ready != NULL ) {
+		Job* next = ready->next;
+		ready->next = NULL;
+		submit( ready );
+		ready = next;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::findJob
+//
+// The worker's own newest job, or else the oldest job of a random victim, 
+// or else one submitted from outside the workers.
+////////////////////////////////////////////////////////////////////////////////
+Job* JobSystem::findJob( Worker* worker ) {
+	Job* job = worker->deque.pop();
+	if ( job != NULL ) {
+		return job;
+	}
+
+	const size_t first = worker->nextRandom() % numWorkers;
+	for( size_t i = 0; i < numWorkers; i++ ) {
+		Worker* victim = workers[ ( first + i ) % numWorkers ];
+		if ( victim != worker ) {
+			job = victim->deque.steal();
+			if ( job != NULL ) {
+				return job;
+			}
+		}
+	}
+	return popSubmitted();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::popSubmitted
+////////////////////////////////////////////////////////////////////////////////
+Job* JobSystem::popSubmitted() {
+	if ( numSubmitted.load( std::memory_order_relaxed ) == 0 ) {
+		return NULL;
+	}
+	std::lock_guard< std::mutex > lock( submitMutex );
+	Job* job = submittedHead;
+	if ( job != NULL ) {
+		submittedHead = job->next;
+		if ( submittedHead == NULL ) {
+			submittedTail = NULL;
+		}
+		job->next = NULL;
+		numSubmitted.fetch_sub( 1, std::memory_order_relaxed );
+	}
+	return job;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::hasWork
+////////////////////////////////////////////////////////////////////////////////
+bool JobSystem::hasWork() const {
+	if ( numSubmitted.load( std::memory_order_seq_cst ) > 0 ) {
+		return true;
+	}
+	for( size_t i = 0; i < numWorkers; i++ ) {
+		if ( !workers[ i ]->deque.empty() ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::wakeWorker
+//
+// Wakes a sleeping worker after a job was made available. Sleepers check 
+// for work after announcing themselves and while holding the lock, so 
+// either they see the job or they are woken here.
+////////////////////////////////////////////////////////////////////////////////
+void JobSystem::wakeWorker() {
+	if ( numSleeping.load( std::memory_order_seq_cst ) == 0 ) {
+		return;
+	}
+	{
+		std::lock_guard< std::mutex > lock( sleepMutex );
+	}
+	sleepCondition.notify_one();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::workerLoop
+//
+// Runs jobs until the system is destroyed, spinning for a while when out of
+// work before going to sleep.
+////////////////////////////////////////////////////////////////////////////////
+void JobSystem::workerLoop( Worker* worker ) {
+	const size_t SPIN_ROUNDS = 64;
+
+	currentWorker = worker;
+	for( ;; ) {
+		Job* job = NULL;
+		for( size_t round = 0; round < SPIN_ROUNDS && job == NULL; round++ ) {
+			job = findJob( worker );
+			if ( job == NULL ) {
+				std::this_thread::yield();
+			}
+		}
+		if ( job != NULL ) {
+			execute( job, worker );
+			continue;
+		}
+
+		std::unique_lock< std::mutex > lock( sleepMutex );
+		if ( stopping ) {
+			break;
+		}
+		numSleeping.fetch_add( 1, std::memory_order_seq_cst );
+		if ( !hasWork() ) {
+			sleepCondition.wait( lock );
+		}
+		numSleeping.fetch_sub( 1, std::memory_order_relaxed );
+	}
+	currentWorker = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JobSystem::getCurrentWorker
+//
+// The calling thread's worker, NULL if it isn't one of this system.
+////////////////////////////////////////////////////////////////////////////////
+JobSystem::Worker* JobSystem::getCurrentWorker() const {
+	return currentWorker != NULL && currentWorker->system == this ? currentWorker : NULL;
+}
+
+} // namespace Jobs
+} // namespace CoreLib
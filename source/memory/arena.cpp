@@ -0,0 +1,221 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#include <memory/arena.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <new>
+
+namespace CoreLib {
+namespace Memory {
+
+// header stored at the beginning of every block, followed by the block data
+struct Arena::Block {
+	Block*	next;
+	size_t	size;	// bytes of data following the header
+	size_t	used;
+
+	static const size_t HEADER_SIZE = 32; // keeps the data 16 byte aligned
+
+	char* data() { return reinterpret_cast< char* >( this ) + HEADER_SIZE; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Arena::Arena
+////////////////////////////////////////////////////////////////////////////////
+Arena::Arena( size_t blockSize ) : blockSize( blockSize ), first( NULL ), current( NULL ) {
+	static_assert( sizeof( Block ) <= Block::HEADER_SIZE, "the block header doesn't fit" );
+	assert( blockSize > 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Arena::~Arena
+////////////////////////////////////////////////////////////////////////////////
+Arena::~Arena() {
+	destroy();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Arena::allocBytes
+//
+// Returns uninitialized memory starting at the given power of two alignment.
+// Chains a new block if the current one can't fit the allocation.
+////////////////////////////////////////////////////////////////////////////////
+void* Arena::allocBytes( size_t bytes, size_t alignment ) {
+	assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0 );
+
+	if ( current != NULL ) {
+		const size_t address = reinterpret_cast< size_t >( current->data() + current->used );
+		const size_t padding = ( alignment - ( address & ( alignment - 1 ) ) ) & ( alignment - 1 );
+		if ( current->used + padding + bytes <= current->size ) {
+			void* ptr = current->data() + current->used + padding;
+			current->used += padding + bytes;
+			return ptr;
+		}
+	}
+
+	// block data is 16 byte aligned, higher alignments may need padding
+	const size_t worstPadding = alignment > 16 ? alignment - 16 : 0;
+	current = nextBlock( bytes + worstPadding );
+	if ( current == NULL ) {
+		return NULL;
+	}
+
+	const size_t address = reinterpret_cast< size_t >( current->data() );
+	const size_t padding = ( alignment - ( address & ( alignment - 1 ) ) ) & ( alignment - 1 );
+	current->used = padding + bytes;
+	return current->data() + padding;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Arena::nextBlock
+//
+// Returns an empty block with room for minSize bytes following the current 
+// one, reusing the spare block after it if it's large enough. 
+////////////////////////////////////////////////////////////////////////////////
+Arena::Block* Arena::nextBlock( size_t minSize ) {
+	Block* spare = current != NULL ? current->next : first;
+	if ( spare != NULL && spare->size >= minSize ) {
+		spare->used = 0;
+		return spare;
+	}
+
+	// oversized allocations get a block of their own
+	const size_t size = minSize > blockSize ? minSize : blockSize;
+	void* memory = malloc( Block::HEADER_SIZE + size );
+	if ( memory == NULL ) {
+		assert( false );
+		return NULL;
+	}
+
+	Block* block = new( memory ) Block;
+	block->size = size;
+	block->used = 0;
+
+	// insert it after the current block, keeping any spare blocks after it 
+	block->next = spare;
+	if ( current != NULL ) {
+		current->next = block;
+	} else {
+		first = block;
+	}
+	return block;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Arena::mark
+//
+// Returns the current position in the arena, to be passed to rewind.
+////////////////////////////////////////////////////////////////////////////////
+Arena::Marker Arena::mark() const {
+	Marker marker;
+	marker.block = current;
+	marker.used = current != NULL ? current->used : 0;
+	return marker;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Arena::rewind
+//
+// Releases every allocation made after the marker was taken. The blocks 
+// chained since then are kept for reuse. Markers taken after this one, or 
+// before the arena was cleared, are invalidated.
+////////////////////////////////////////////////////////////////////////////////
+void Arena::rewind( const Marker& marker ) {
+	if ( marker.block == NULL ) {
+		// the arena was empty when marked
+		clearMemory();
+		return;
+	}
+	current = marker.block;
+	assert( marker.used <= current->used );
+	current->used = marker.used;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Arena::clearMemory
+//
+// Releases every allocation. Unless keepBlocks is false the blocks are 
+// kept, so that the next allocations don't hit the system allocator.
+////////////////////////////////////////////////////////////////////////////////
+void Arena::clearMemory( bool keepBlocks ) {
+	if ( !keepBlocks ) {
+		destroy();
+		return;
+	}
+	current = first;
+	if ( current != NULL ) {
+		current->used = 0;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Arena::destroy
+//
+// Releases every allocation and returns the blocks to the system.
+////////////////////////////////////////////////////////////////////////////////
+void Arena::destroy() {
+	Block* block = first;
+	while( block != NULL ) {
+		Block* next = block->next;
+		free( block );
+		block = next;
+	}
+	first = NULL;
+	current = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Arena::setBlockSize
+////////////////////////////////////////////////////////////////////////////////
+void Arena::setBlockSize( size_t newBlockSize ) {
+	assert( newBlockSize > 0 );
+	blockSize = newBlockSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Arena::getUsed
+////////////////////////////////////////////////////////////////////////////////
+size_t Arena::getUsed() const {
+	if ( current == NULL ) {
+		return 0;
+	}
+	size_t used = 0;
+	for( Block* block = first; block != current; block = block->next ) {
+		used += block->used;
+	}
+	return used + current->used;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Arena::getReserved
+////////////////////////////////////////////////////////////////////////////////
+size_t Arena::getReserved() const {
+	size_t reserved = 0;
+	for( Block* block = first; block != NULL; block = block->next ) {
+		reserved += block->size;
+	}
+	return reserved;
+}
+
+} // namespace Memory
+} // namespace CoreLib
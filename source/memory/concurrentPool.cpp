@@ -0,0 +1,148 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#include <memory/concurrentPool.h>
+#include <memory.h>
+#include <assert.h>
+
+namespace CoreLib {
+namespace Memory {
+
+////////////////////////////////////////////////////////////////////////////////
+// ConcurrentMemoryPool::ConcurrentMemoryPool
+////////////////////////////////////////////////////////////////////////////////
+ConcurrentMemoryPool::ConcurrentMemoryPool() : memory( NULL ), size( 0 ), used( 0 ) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ConcurrentMemoryPool::ConcurrentMemoryPool
+////////////////////////////////////////////////////////////////////////////////
+ConcurrentMemoryPool::ConcurrentMemoryPool( size_t poolSize ) : memory( NULL ), size( 0 ), used( 0 ) {
+	init( poolSize );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ConcurrentMemoryPool::~ConcurrentMemoryPool
+////////////////////////////////////////////////////////////////////////////////
+ConcurrentMemoryPool::~ConcurrentMemoryPool() {
+	destroy();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ConcurrentMemoryPool::init
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentMemoryPool::init( size_t poolSize ) {
+	assert( poolSize > 0 );
+	if ( memory != NULL ) {
+		destroy();
+	}
+	size = poolSize;
+	// malloc returns memory aligned for any fundamental type, which is at 
+	// least BASE_ALIGNMENT on the platforms we care about
+	memory = (char*)malloc( size );
+	assert( ( reinterpret_cast< size_t >( memory ) & ( BASE_ALIGNMENT - 1 ) ) == 0 );
+	used.store( 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ConcurrentMemoryPool::destroy
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentMemoryPool::destroy() {
+	clearMemory();
+	if ( memory != NULL ) {
+		free( memory );
+		memory = NULL;
+	}
+	size = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ConcurrentMemoryPool::clearMemory
+//
+// Wipes the memory chunk without freeing the memory and resets the 
+// allocator internal state. Call this before reusing the pool.
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentMemoryPool::clearMemory() {
+#if _DEBUG
+	if ( getUsed() > 0 ) {
+		memset( memory, 0xFF, getUsed() );
+	}
+#endif
+	used.store( 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ConcurrentMemoryPool::getUsed
+////////////////////////////////////////////////////////////////////////////////
+size_t ConcurrentMemoryPool::getUsed() const {
+	// failed allocations may leave the counter past the end of the pool
+	const size_t current = used.load( std::memory_order_relaxed );
+	return current < size ? current : size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ConcurrentMemoryPool::allocBytes
+//
+// Returns uninitialized memory starting at the given power of two alignment,
+// or NULL if the pool ran out of memory. Safe to call from any thread.
+////////////////////////////////////////////////////////////////////////////////
+void* ConcurrentMemoryPool::allocBytes( size_t bytes, size_t alignment ) {
+	assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0 );
+
+	// reserve enough room to align the allocation wherever it ends up, as 
+	// we can't know our offset before the fetch-add
+	size_t required = ( bytes + BASE_ALIGNMENT - 1 ) & ~( BASE_ALIGNMENT - 1 );
+	if ( alignment > BASE_ALIGNMENT ) {
+		required += alignment - BASE_ALIGNMENT;
+	}
+
+	const size_t offset = used.fetch_add( required, std::memory_order_relaxed );
+	if ( offset + required > size ) {
+		std::cerr << "Ran out of memory on concurrent pool allocator (size = " << size << " bytes)" << std::endl;
+		assert(false);
+		return NULL;
+	}
+
+	const size_t address = reinterpret_cast< size_t >( memory + offset );
+	const size_t padding = ( alignment - ( address & ( alignment - 1 ) ) ) & ( alignment - 1 );
+	return memory + offset + padding;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ConcurrentMemoryPool::carve
+//
+// Reserves a chunk of the given size and attaches the given pool to it, so 
+// that a single thread can allocate from the chunk without atomics. The 
+// chunk is reclaimed when this pool is cleared. Returns false if the pool 
+// ran out of memory.
+////////////////////////////////////////////////////////////////////////////////
+bool ConcurrentMemoryPool::carve( size_t bytes, MemoryPool& chunk ) {
+	void* buffer = allocBytes( bytes, BASE_ALIGNMENT );
+	if ( buffer == NULL ) {
+		return false;
+	}
+	chunk.attach( buffer, bytes );
+	return true;
+}
+
+} // namespace Memory
+} // namespace CoreLib
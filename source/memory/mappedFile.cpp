@@ -0,0 +1,177 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#include <memory/mappedFile.h>
+#include <assert.h>
+#include <iostream>
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CoreLib {
+namespace Memory {
+
+////////////////////////////////////////////////////////////////////////////////
+// MappedFile::MappedFile
+////////////////////////////////////////////////////////////////////////////////
+MappedFile::MappedFile()
+	:	data( NULL ),
+		size( 0 ),
+		access( ACCESS_READ_ONLY )
+#if defined( _WIN32 )
+		, mappingHandle( NULL )
+#endif
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MappedFile::~MappedFile
+////////////////////////////////////////////////////////////////////////////////
+MappedFile::~MappedFile() {
+	close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MappedFile::open
+//
+// Maps the whole file with the given access. Empty files can't be mapped.
+////////////////////////////////////////////////////////////////////////////////
+bool MappedFile::open( const char* path, Access newAccess ) {
+	close();
+
+#if defined( _WIN32 )
+	HANDLE file = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( file == INVALID_HANDLE_VALUE ) {
+		std::cerr << "Failed to open " << path << " for mapping" << std::endl;
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if ( !GetFileSizeEx( file, &fileSize ) || fileSize.QuadPart == 0 ) {
+		std::cerr << "Can't map " << path << ", the file is empty" << std::endl;
+		CloseHandle( file );
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA( file, NULL, newAccess == ACCESS_COPY_ON_WRITE ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL );
+	CloseHandle( file );
+	if ( mapping == NULL ) {
+		std::cerr << "Failed to map " << path << std::endl;
+		return false;
+	}
+	void* ptr = MapViewOfFile( mapping, newAccess == ACCESS_COPY_ON_WRITE ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0 );
+	if ( ptr == NULL ) {
+		std::cerr << "Failed to map " << path << std::endl;
+		CloseHandle( mapping );
+		return false;
+	}
+	mappingHandle = mapping;
+	size = (size_t)fileSize.QuadPart;
+#else
+	const int fd = ::open( path, O_RDONLY );
+	if ( fd < 0 ) {
+		std::cerr << "Failed to open " << path << " for mapping" << std::endl;
+		return false;
+	}
+	struct stat info;
+	if ( fstat( fd, &info ) != 0 || info.st_size == 0 ) {
+		std::cerr << "Can't map " << path << ", the file is empty" << std::endl;
+		::close( fd );
+		return false;
+	}
+	// private mappings of a read only descriptor can still be written to, 
+	// the written pages are copied and never reach the file
+	const int protection = newAccess == ACCESS_COPY_ON_WRITE ? PROT_READ | PROT_WRITE : PROT_READ;
+	void* ptr = mmap( NULL, (size_t)info.st_size, protection, MAP_PRIVATE, fd, 0 );
+	::close( fd );
+	if ( ptr == MAP_FAILED ) {
+		std::cerr << "Failed to map " << path << std::endl;
+		return false;
+	}
+	size = (size_t)info.st_size;
+#endif
+
+	data = ptr;
+	access = newAccess;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MappedFile::close
+//
+// Unmaps the file. Any pointer into the mapping becomes invalid.
+////////////////////////////////////////////////////////////////////////////////
+void MappedFile::close() {
+	if ( data != NULL ) {
+#if defined( _WIN32 )
+		UnmapViewOfFile( data );
+		CloseHandle( mappingHandle );
+		mappingHandle = NULL;
+#else
+		munmap( data, size );
+#endif
+	}
+	data = NULL;
+	size = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MappedFile::getMutableData
+////////////////////////////////////////////////////////////////////////////////
+void* MappedFile::getMutableData() {
+	assert( access == ACCESS_COPY_ON_WRITE );
+	return access == ACCESS_COPY_ON_WRITE ? data : NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MappedFile::willNeed
+//
+// Starts reading the range ahead, so that it can be accessed without 
+// stalling on page faults. 
+////////////////////////////////////////////////////////////////////////////////
+void MappedFile::willNeed( size_t offset, size_t bytes ) const {
+	if ( data == NULL || offset >= size ) {
+		return;
+	}
+	if ( bytes > size - offset ) {
+		bytes = size - offset;
+	}
+#if defined( _WIN32 )
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = static_cast< char* >( data ) + offset;
+	range.NumberOfBytes = bytes;
+	PrefetchVirtualMemory( GetCurrentProcess(), 1, &range, 0 );
+#else
+	// madvise needs a page aligned start
+	const size_t pageSize = (size_t)sysconf( _SC_PAGESIZE );
+	const size_t begin = offset & ~( pageSize - 1 );
+	madvise( static_cast< char* >( data ) + begin, bytes + ( offset - begin ), MADV_WILLNEED );
+#endif
+}
+
+} // namespace Memory
+} // namespace CoreLib
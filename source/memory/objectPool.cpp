@@ -0,0 +1,147 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#include <memory/objectPool.h>
+#include <stdlib.h>
+
+namespace CoreLib {
+namespace Memory {
+
+////////////////////////////////////////////////////////////////////////////////
+// FixedSizePool::FixedSizePool
+//
+// Slots are rounded up to keep them SLOT_ALIGNMENT aligned, and blocks are 
+// enlarged if needed to hold at least a few slots.
+////////////////////////////////////////////////////////////////////////////////
+FixedSizePool::FixedSizePool( size_t requestedSlotSize, size_t requestedBlockSize ) 
+	:	slotSize( 0 ),
+		blockSize( 0 ),
+		freeList( NULL ),
+		blocks( NULL ),
+		bumpCurrent( NULL ),
+		bumpEnd( NULL ) {
+	assert( requestedSlotSize > 0 );
+	slotSize = ( requestedSlotSize + SLOT_ALIGNMENT - 1 ) & ~( SLOT_ALIGNMENT - 1 );
+
+	const size_t minBlockSize = SLOT_ALIGNMENT + 8 * slotSize;
+	blockSize = requestedBlockSize > minBlockSize ? requestedBlockSize : minBlockSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FixedSizePool::~FixedSizePool
+////////////////////////////////////////////////////////////////////////////////
+FixedSizePool::~FixedSizePool() {
+	destroy();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FixedSizePool::allocFromNewBlock
+//
+// Allocates a new block, and hands out its first slot. The rest of the 
+// slots are handed out lazily by alloc.
+////////////////////////////////////////////////////////////////////////////////
+void* FixedSizePool::allocFromNewBlock() {
+	char* block = (char*)malloc( blockSize );
+	if ( block == NULL ) {
+		assert( false );
+		return NULL;
+	}
+
+	// the first SLOT_ALIGNMENT bytes link the blocks together
+	*reinterpret_cast< char** >( block ) = blocks;
+	blocks = block;
+
+	const size_t numSlots = ( blockSize - SLOT_ALIGNMENT ) / slotSize;
+	bumpCurrent = block + SLOT_ALIGNMENT + slotSize;
+	bumpEnd = block + SLOT_ALIGNMENT + numSlots * slotSize;
+	return block + SLOT_ALIGNMENT;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FixedSizePool::allocBytes
+//
+// Returns a slot if the request fits in one, otherwise forwards it to the 
+// heap.
+////////////////////////////////////////////////////////////////////////////////
+void* FixedSizePool::allocBytes( size_t bytes, size_t alignment ) {
+	assert( alignment <= SLOT_ALIGNMENT );
+	(void)alignment;
+	if ( bytes <= slotSize ) {
+		return alloc();
+	}
+	return malloc( bytes );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FixedSizePool::freeBytes
+//
+// Releases memory returned by allocBytes for the same number of bytes.
+////////////////////////////////////////////////////////////////////////////////
+void FixedSizePool::freeBytes( void* ptr, size_t bytes ) {
+	if ( ptr == NULL ) {
+		return;
+	}
+	if ( bytes <= slotSize ) {
+		free( ptr );
+	} else {
+		::free( ptr );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FixedSizePool::clearMemory
+//
+// Releases every slot at once. The newest block is kept to allocate from, 
+// the rest are returned to the system.
+////////////////////////////////////////////////////////////////////////////////
+void FixedSizePool::clearMemory() {
+	if ( blocks == NULL ) {
+		return;
+	}
+	char* newest = blocks;
+	blocks = *reinterpret_cast< char** >( newest );
+	destroy();
+
+	*reinterpret_cast< char** >( newest ) = NULL;
+	blocks = newest;
+	bumpCurrent = newest + SLOT_ALIGNMENT;
+	bumpEnd = newest + SLOT_ALIGNMENT + ( ( blockSize - SLOT_ALIGNMENT ) / slotSize ) * slotSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FixedSizePool::destroy
+//
+// Releases every slot and returns the blocks to the system.
+////////////////////////////////////////////////////////////////////////////////
+void FixedSizePool::destroy() {
+	while( blocks != NULL ) {
+		char* next = *reinterpret_cast< char** >( blocks );
+		::free( blocks );
+		blocks = next;
+	}
+	freeList = NULL;
+	bumpCurrent = NULL;
+	bumpEnd = NULL;
+}
+
+} // namespace Memory
+} // namespace CoreLib
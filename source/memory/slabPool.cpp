@@ -0,0 +1,110 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#include <memory/slabPool.h>
+#include <stdlib.h>
+#include <assert.h>
+
+namespace CoreLib {
+namespace Memory {
+
+////////////////////////////////////////////////////////////////////////////////
+// SlabPool::SlabPool
+////////////////////////////////////////////////////////////////////////////////
+SlabPool::SlabPool( size_t slabSize ) : slabSize( slabSize ) {
+	for( size_t i = 0; i < SizeClasses::NUM_CLASSES; i++ ) {
+		classes[ i ] = NULL;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SlabPool::~SlabPool
+////////////////////////////////////////////////////////////////////////////////
+SlabPool::~SlabPool() {
+	destroy();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SlabPool::allocBytes
+//
+// Returns uninitialized memory from the smallest size class fitting the 
+// request, or from the heap for large requests. Memory is 16 byte aligned.
+////////////////////////////////////////////////////////////////////////////////
+void* SlabPool::allocBytes( size_t bytes, size_t alignment ) {
+	assert( alignment <= FixedSizePool::SLOT_ALIGNMENT );
+	(void)alignment;
+	if ( bytes > SizeClasses::MAX_SIZE ) {
+		return malloc( bytes );
+	}
+
+	const size_t index = SizeClasses::classIndex( bytes );
+	if ( classes[ index ] == NULL ) {
+		classes[ index ] = new FixedSizePool( SizeClasses::classSize( index ), slabSize );
+	}
+	return classes[ index ]->alloc();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SlabPool::freeBytes
+//
+// Releases memory returned by allocBytes for the same number of bytes.
+////////////////////////////////////////////////////////////////////////////////
+void SlabPool::freeBytes( void* ptr, size_t bytes ) {
+	if ( ptr == NULL ) {
+		return;
+	}
+	if ( bytes > SizeClasses::MAX_SIZE ) {
+		free( ptr );
+		return;
+	}
+
+	const size_t index = SizeClasses::classIndex( bytes );
+	assert( classes[ index ] != NULL );
+	classes[ index ]->free( ptr );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SlabPool::clearMemory
+//
+// Releases every slab allocation at once. Large allocations, which went to 
+// the heap, must still be freed individually.
+////////////////////////////////////////////////////////////////////////////////
+void SlabPool::clearMemory() {
+	for( size_t i = 0; i < SizeClasses::NUM_CLASSES; i++ ) {
+		if ( classes[ i ] != NULL ) {
+			classes[ i ]->clearMemory();
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SlabPool::destroy
+////////////////////////////////////////////////////////////////////////////////
+void SlabPool::destroy() {
+	for( size_t i = 0; i < SizeClasses::NUM_CLASSES; i++ ) {
+		delete classes[ i ];
+		classes[ i ] = NULL;
+	}
+}
+
+} // namespace Memory
+} // namespace CoreLib
@@ -21,44 +21,95 @@
 */
 
 #include <memory/staticPool.h>
+#include <stats/stats.h>
 #include <memory.h>
 #include <assert.h>
 
 namespace CoreLib {
 namespace Memory {
 
-char*  StaticMemoryPoolBase::memory = NULL;
-size_t StaticMemoryPoolBase::size = 0;
-size_t StaticMemoryPoolBase::used = 0;
+MemoryPool StaticMemoryPoolBase::pool;
 
 ////////////////////////////////////////////////////////////////////////////////
-//StaticMemoryPool::init
+// MemoryPool::MemoryPool
 ////////////////////////////////////////////////////////////////////////////////
-void StaticMemoryPoolBase::init( size_t poolSize ) {
+MemoryPool::MemoryPool( size_t poolSize ) 
+	:	memory( NULL ), 
+		size( 0 ), 
+		used( 0 ), 
+		ownsMemory( false )
+#if CORELIB_ENABLE_STATS
+		, highWater( 0 ),
+		allocations( 0 ),
+		paddingBytes( 0 )
+#endif
+{
+	init( poolSize );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MemoryPool::~MemoryPool
+////////////////////////////////////////////////////////////////////////////////
+MemoryPool::~MemoryPool() {
+	destroy();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MemoryPool::init
+////////////////////////////////////////////////////////////////////////////////
+void MemoryPool::init( size_t poolSize ) {
 	assert( poolSize > 0 );
+	if ( memory != NULL ) {
+		destroy();
+	}
 	size = poolSize;
 	memory = (char*)malloc( size );
 	used = 0;
+	ownsMemory = true;
+	CORELIB_STAT( Stats::addSource( this == &StaticMemoryPoolBase::getPool() ? "staticMemoryPool" : "memoryPool", this, &MemoryPool::sampleStats ) );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// StaticMemoryPool::destroy
+// MemoryPool::attach
+//
+// Allocates from an externally provided buffer, e.g. a chunk carved from a 
+// ConcurrentMemoryPool. The buffer is not released by destroy.
+////////////////////////////////////////////////////////////////////////////////
+void MemoryPool::attach( void* buffer, size_t bufferSize ) {
+	assert( buffer != NULL );
+	if ( memory != NULL ) {
+		destroy();
+	}
+	size = bufferSize;
+	memory = (char*)buffer;
+	used = 0;
+	ownsMemory = false;
+	CORELIB_STAT( Stats::addSource( "memoryPool", this, &MemoryPool::sampleStats ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MemoryPool::destroy
 ////////////////////////////////////////////////////////////////////////////////
-void StaticMemoryPoolBase::destroy() {
+void MemoryPool::destroy() {
 	clearMemory();
 	if ( memory != NULL ) {
-		free( memory );
-		memory = NULL;
+		CORELIB_STAT( Stats::removeSource( this ) );
+		if ( ownsMemory ) {
+			free( memory );
+		}
 	}
+	memory = NULL;
+	size = 0;
+	ownsMemory = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// StaticMemoryPool::clearMemory
+// MemoryPool::clearMemory
 //
 // Wipes the memory chunk without freeing the memory and resets the 
 // allocator internal state. Call this before reusing the pool.
 ////////////////////////////////////////////////////////////////////////////////
-void StaticMemoryPoolBase::clearMemory() {
+void MemoryPool::clearMemory() {
 #if _DEBUG
 	if ( used > 0 ) {
 		memset( memory, 0xFF, used );
@@ -68,23 +119,70 @@ void StaticMemoryPoolBase::clearMemory() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-
-template<>
-int* /*static*/ StaticMemoryPool<int>::alloc( size_t count ) {
-	return allocIntegralType<int>( count );
+// MemoryPool::rewind
+//
+// Releases the allocations made since the marker was taken with mark(), 
+// which must be done in the reverse order the markers were taken.
+////////////////////////////////////////////////////////////////////////////////
+void MemoryPool::rewind( size_t marker ) {
+	assert( marker <= used );
+#if _DEBUG
+	if ( used > marker ) {
+		memset( memory + marker, 0xFF, used - marker );
+	}
+#endif
+	used = marker;
 }
-template<>
-float* /*static*/ StaticMemoryPool<float>::alloc( size_t count ) {
-	return allocIntegralType<float>( count );
+
+////////////////////////////////////////////////////////////////////////////////
+// MemoryPool::allocBytes
+//
+// Returns uninitialized memory starting at the given power of two alignment,
+// or NULL if the pool ran out of memory.
+////////////////////////////////////////////////////////////////////////////////
+void* MemoryPool::allocBytes( size_t bytes, size_t alignment ) {
+	assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0 );
+
+	const size_t address = reinterpret_cast< size_t >( memory + used );
+	const size_t padding = ( alignment - ( address & ( alignment - 1 ) ) ) & ( alignment - 1 );
+	const size_t required = padding + bytes;
+
+	if ( used + required > size ) {
+		std::cerr << "Ran out of memory on static pool allocator (size = " << size << " bytes)" << std::endl;
+		assert(false);
+		return NULL; 
+	}
+
+	void* ptr = memory + used + padding;
+	used += required;
+	CORELIB_STAT( recordAllocation( padding ) );
+	return ptr;
 }
-template<>
-double* /*static*/ StaticMemoryPool< double >::alloc( size_t count ) {
-	return allocIntegralType<double>( count );
+
+#if CORELIB_ENABLE_STATS
+////////////////////////////////////////////////////////////////////////////////
+// MemoryPool::recordAllocation
+////////////////////////////////////////////////////////////////////////////////
+void MemoryPool::recordAllocation( size_t padding ) {
+	allocations++;
+	paddingBytes += padding;
+	if ( used > highWater ) {
+		highWater = used;
+	}
 }
-template<>
-char* /*static*/ StaticMemoryPool< char >::alloc( size_t count ) {
-	return allocIntegralType<char>( count );
+
+////////////////////////////////////////////////////////////////////////////////
+// MemoryPool::sampleStats
+////////////////////////////////////////////////////////////////////////////////
+void MemoryPool::sampleStats( const void* object, const std::string& name, Stats::Snapshot& snapshot ) {
+	const MemoryPool* pool = static_cast< const MemoryPool* >( object );
+	snapshot.add( name + ".size", pool->size );
+	snapshot.add( name + ".used", pool->used );
+	snapshot.add( name + ".highWater", pool->highWater );
+	snapshot.add( name + ".allocations", pool->allocations );
+	snapshot.add( name + ".paddingBytes", pool->paddingBytes );
 }
+#endif
 
 } // namespace Memory
 } // namespace CoreLib
@@ -0,0 +1,307 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#include <memory/threadCachingPool.h>
+#include <containers/list/list.h>
+#include <stdlib.h>
+#include <assert.h>
+
+namespace CoreLib {
+namespace Memory {
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadCachingPool::ThreadCache
+//
+// Per thread magazines of free slots, one per size class.
+////////////////////////////////////////////////////////////////////////////////
+struct ThreadCachingPool::ThreadCache {
+	struct Magazine {
+		void**	slots;		// allocated on first use
+		size_t	count;
+		size_t	capacity;
+	};
+
+	Magazine magazines[ SizeClasses::NUM_CLASSES ];
+
+	ThreadCache() {
+		for( size_t i = 0; i < SizeClasses::NUM_CLASSES; i++ ) {
+			// keep about 32KB worth of slots per class
+			size_t capacity = 32 * 1024 / SizeClasses::classSize( i );
+			capacity = capacity < 8 ? 8 : ( capacity > 256 ? 256 : capacity );
+			magazines[ i ].slots = NULL;
+			magazines[ i ].count = 0;
+			magazines[ i ].capacity = capacity;
+		}
+	}
+
+	~ThreadCache() {
+		for( size_t i = 0; i < SizeClasses::NUM_CLASSES; i++ ) {
+			free( magazines[ i ].slots );
+		}
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadCacheRegistry
+//
+// Caches owned by the current thread, one per pool it has used. They are 
+// returned to their pools when the thread exits.
+////////////////////////////////////////////////////////////////////////////////
+struct ThreadCacheEntry {
+	ThreadCachingPool*				pool;
+	ThreadCachingPool::ThreadCache*	cache;
+};
+
+// last pool used by the thread, checked before searching the registry
+static thread_local ThreadCachingPool*				lastPool = NULL;
+static thread_local ThreadCachingPool::ThreadCache*	lastCache = NULL;
+
+// set once the thread is exiting, from then on the central pools are used 
+// directly (e.g. by static destructors running on the main thread)
+static thread_local bool							threadCachesReleased = false;
+
+struct ThreadCacheRegistry {
+	List< ThreadCacheEntry > entries;
+
+	~ThreadCacheRegistry() {
+		for( size_t i = 0; i < entries.size(); i++ ) {
+			entries[ i ].pool->releaseThreadCache( entries[ i ].cache );
+		}
+		entries.clear();
+		lastPool = NULL;
+		lastCache = NULL;
+		threadCachesReleased = true;
+	}
+};
+
+static thread_local ThreadCacheRegistry threadCaches;
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadCachingPool::ThreadCachingPool
+////////////////////////////////////////////////////////////////////////////////
+ThreadCachingPool::ThreadCachingPool( size_t slabSize ) : slabSize( slabSize ) {
+	for( size_t i = 0; i < SizeClasses::NUM_CLASSES; i++ ) {
+		classes[ i ].pool = NULL;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadCachingPool::~ThreadCachingPool
+////////////////////////////////////////////////////////////////////////////////
+ThreadCachingPool::~ThreadCachingPool() {
+	// caches of other threads must have been released by now
+	flushThreadCache();
+	for( size_t i = 0; i < SizeClasses::NUM_CLASSES; i++ ) {
+		delete classes[ i ].pool;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadCachingPool::allocBytes
+//
+// Returns uninitialized, 16 byte aligned memory. Safe to call from any 
+// thread.
+////////////////////////////////////////////////////////////////////////////////
+void* ThreadCachingPool::allocBytes( size_t bytes, size_t alignment ) {
+	assert( alignment <= FixedSizePool::SLOT_ALIGNMENT );
+	(void)alignment;
+	if ( bytes > SizeClasses::MAX_SIZE ) {
+		return malloc( bytes );
+	}
+
+	const size_t index = SizeClasses::classIndex( bytes );
+	ThreadCache* cache = getThreadCache();
+	if ( cache == NULL ) {
+		void* slot;
+		return allocBatch( index, &slot, 1 ) == 1 ? slot : NULL;
+	}
+
+	ThreadCache::Magazine& magazine = cache->magazines[ index ];
+	if ( magazine.count == 0 ) {
+		if ( magazine.slots == NULL ) {
+			magazine.slots = (void**)malloc( magazine.capacity * sizeof( void* ) );
+		}
+		magazine.count = allocBatch( index, magazine.slots, magazine.capacity / 2 );
+		if ( magazine.count == 0 ) {
+			return NULL;
+		}
+	}
+	return magazine.slots[ --magazine.count ];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadCachingPool::freeBytes
+//
+// Releases memory returned by allocBytes for the same number of bytes, 
+// possibly allocated by another thread.
+////////////////////////////////////////////////////////////////////////////////
+void ThreadCachingPool::freeBytes( void* ptr, size_t bytes ) {
+	if ( ptr == NULL ) {
+		return;
+	}
+	if ( bytes > SizeClasses::MAX_SIZE ) {
+		free( ptr );
+		return;
+	}
+
+	const size_t index = SizeClasses::classIndex( bytes );
+	ThreadCache* cache = getThreadCache();
+	if ( cache == NULL ) {
+		freeBatch( index, &ptr, 1 );
+		return;
+	}
+
+	ThreadCache::Magazine& magazine = cache->magazines[ index ];
+	if ( magazine.slots == NULL ) {
+		magazine.slots = (void**)malloc( magazine.capacity * sizeof( void* ) );
+	}
+	if ( magazine.count == magazine.capacity ) {
+		// return half of the magazine, keeping the most recently freed slots
+		const size_t batch = magazine.capacity / 2;
+		freeBatch( index, magazine.slots, batch );
+		for( size_t i = batch; i < magazine.count; i++ ) {
+			magazine.slots[ i - batch ] = magazine.slots[ i ];
+		}
+		magazine.count -= batch;
+	}
+	magazine.slots[ magazine.count++ ] = ptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadCachingPool::flushThreadCache
+//
+// Returns every slot cached by the calling thread to the central pool.
+////////////////////////////////////////////////////////////////////////////////
+void ThreadCachingPool::flushThreadCache() {
+	if ( threadCachesReleased ) {
+		return;
+	}
+
+	List< ThreadCacheEntry >& entries = threadCaches.entries;
+	for( size_t i = 0; i < entries.size(); i++ ) {
+		if ( entries[ i ].pool == this ) {
+			releaseThreadCache( entries[ i ].cache );
+			entries.removeIndexFast( i );
+			break;
+		}
+	}
+	if ( lastPool == this ) {
+		lastPool = NULL;
+		lastCache = NULL;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadCachingPool::getDefault
+////////////////////////////////////////////////////////////////////////////////
+ThreadCachingPool& ThreadCachingPool::getDefault() {
+	static ThreadCachingPool defaultPool;
+	return defaultPool;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadCachingPool::getThreadCache
+//
+// Returns the calling thread's cache for this pool, creating it on first use.
+// Returns NULL if the thread already released its caches.
+////////////////////////////////////////////////////////////////////////////////
+ThreadCachingPool::ThreadCache* ThreadCachingPool::getThreadCache() {
+	if ( lastPool == this ) {
+		return lastCache;
+	}
+	if ( threadCachesReleased ) {
+		return NULL;
+	}
+
+	List< ThreadCacheEntry >& entries = threadCaches.entries;
+	ThreadCache* cache = NULL;
+	for( size_t i = 0; i < entries.size(); i++ ) {
+		if ( entries[ i ].pool == this ) {
+			cache = entries[ i ].cache;
+			break;
+		}
+	}
+	if ( cache == NULL ) {
+		ThreadCacheEntry entry;
+		entry.pool = this;
+		entry.cache = new ThreadCache();
+		entries.append( entry );
+		cache = entry.cache;
+	}
+
+	lastPool = this;
+	lastCache = cache;
+	return cache;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadCachingPool::releaseThreadCache
+//
+// Returns every cached slot to the central pool and deletes the cache.
+////////////////////////////////////////////////////////////////////////////////
+void ThreadCachingPool::releaseThreadCache( ThreadCache* cache ) {
+	for( size_t i = 0; i < SizeClasses::NUM_CLASSES; i++ ) {
+		ThreadCache::Magazine& magazine = cache->magazines[ i ];
+		if ( magazine.count > 0 ) {
+			freeBatch( i, magazine.slots, magazine.count );
+		}
+	}
+	delete cache;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadCachingPool::allocBatch
+//
+// Takes up to count slots of the given class from the central pool. Returns
+// the number of slots taken.
+////////////////////////////////////////////////////////////////////////////////
+size_t ThreadCachingPool::allocBatch( size_t classIndex, void** slots, size_t count ) {
+	CentralClass& central = classes[ classIndex ];
+	std::lock_guard< std::mutex > lock( central.mutex );
+	if ( central.pool == NULL ) {
+		central.pool = new FixedSizePool( SizeClasses::classSize( classIndex ), slabSize );
+	}
+	for( size_t i = 0; i < count; i++ ) {
+		slots[ i ] = central.pool->alloc();
+		if ( slots[ i ] == NULL ) {
+			return i;
+		}
+	}
+	return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadCachingPool::freeBatch
+//
+// Returns count slots of the given class to the central pool.
+////////////////////////////////////////////////////////////////////////////////
+void ThreadCachingPool::freeBatch( size_t classIndex, void** slots, size_t count ) {
+	CentralClass& central = classes[ classIndex ];
+	std::lock_guard< std::mutex > lock( central.mutex );
+	assert( central.pool != NULL );
+	for( size_t i = 0; i < count; i++ ) {
+		central.pool->free( slots[ i ] );
+	}
+}
+
+} // namespace Memory
+} // namespace CoreLib
@@ -0,0 +1,262 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#include <memory/virtualMemoryPool.h>
+#include <assert.h>
+#include <iostream>
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace CoreLib {
+namespace Memory {
+
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+// VirtualMemoryPool::VirtualMemoryPool
+////////////////////////////////////////////////////////////////////////////////
+VirtualMemoryPool::VirtualMemoryPool() 
+	:	memory( NULL ),
+		mapping( NULL ),
+		mappingSize( 0 ),
+		size( 0 ),
+		used( 0 ),
+		committed( 0 ),
+		commitGranularity( 0 ),
+		releaseThreshold( 0 ),
+		pageMode( PAGES_DEFAULT ) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// VirtualMemoryPool::VirtualMemoryPool
+////////////////////////////////////////////////////////////////////////////////
+VirtualMemoryPool::VirtualMemoryPool( size_t reserveSize, PageMode mode ) 
+	:	memory( NULL ),
+		mapping( NULL ),
+		mappingSize( 0 ),
+		size( 0 ),
+		used( 0 ),
+		committed( 0 ),
+		commitGranularity( 0 ),
+		releaseThreshold( 0 ),
+		pageMode( PAGES_DEFAULT ) {
+	init( reserveSize, mode );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// VirtualMemoryPool::~VirtualMemoryPool
+////////////////////////////////////////////////////////////////////////////////
+VirtualMemoryPool::~VirtualMemoryPool() {
+	destroy();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// VirtualMemoryPool::init
+//
+// Reserves the address range, without committing any memory.
+////////////////////////////////////////////////////////////////////////////////
+void VirtualMemoryPool::init( size_t reserveSize, PageMode mode ) {
+	assert( reserveSize > 0 );
+	if ( mapping != NULL ) {
+		destroy();
+	}
+
+#if defined( _WIN32 )
+	// large pages need special privileges and can't be committed lazily
+	pageMode = PAGES_DEFAULT;
+	SYSTEM_INFO info;
+	GetSystemInfo( &info );
+	commitGranularity = info.dwPageSize;
+	size = ( reserveSize + commitGranularity - 1 ) & ~( commitGranularity - 1 );
+	mappingSize = size;
+	mapping = (char*)VirtualAlloc( NULL, mappingSize, MEM_RESERVE, PAGE_NOACCESS );
+	if ( mapping == NULL ) {
+		std::cerr << "Failed to reserve virtual memory pool (size = " << reserveSize << " bytes)" << std::endl;
+		assert( false );
+		return;
+	}
+	memory = mapping;
+#else
+	pageMode = mode;
+	commitGranularity = pageMode == PAGES_DEFAULT ? (size_t)sysconf( _SC_PAGESIZE ) : HUGE_PAGE_SIZE;
+	size = ( reserveSize + commitGranularity - 1 ) & ~( commitGranularity - 1 );
+
+	void* ptr = MAP_FAILED;
+#if defined( MAP_HUGETLB )
+	if ( pageMode == PAGES_EXPLICIT_HUGE ) {
+		// no MAP_NORESERVE here: huge pages come from a pool preallocated by 
+		// the system, and reserving them up front makes the mapping fail now
+		// rather than faulting with SIGBUS when the pool runs dry
+		mappingSize = size;
+		ptr = mmap( NULL, mappingSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+	}
+#endif
+	if ( ptr == MAP_FAILED ) {
+		if ( pageMode == PAGES_EXPLICIT_HUGE ) {
+			pageMode = PAGES_TRANSPARENT_HUGE;
+		}
+		// over-reserve so that the pool can start on a huge page boundary
+		mappingSize = pageMode == PAGES_DEFAULT ? size : size + HUGE_PAGE_SIZE;
+		ptr = mmap( NULL, mappingSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+	}
+	if ( ptr == MAP_FAILED ) {
+		std::cerr << "Failed to reserve virtual memory pool (size = " << reserveSize << " bytes)" << std::endl;
+		assert( false );
+		mappingSize = 0;
+		size = 0;
+		return;
+	}
+
+	mapping = (char*)ptr;
+	memory = mapping;
+	if ( pageMode == PAGES_TRANSPARENT_HUGE ) {
+		const size_t address = reinterpret_cast< size_t >( mapping );
+		memory = mapping + ( ( HUGE_PAGE_SIZE - ( address & ( HUGE_PAGE_SIZE - 1 ) ) ) & ( HUGE_PAGE_SIZE - 1 ) );
+#if defined( MADV_HUGEPAGE )
+		madvise( memory, size, MADV_HUGEPAGE );
+#endif
+	}
+#endif
+
+	used = 0;
+	committed = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// VirtualMemoryPool::destroy
+//
+// Releases the whole address range.
+////////////////////////////////////////////////////////////////////////////////
+void VirtualMemoryPool::destroy() {
+	if ( mapping != NULL ) {
+#if defined( _WIN32 )
+		VirtualFree( mapping, 0, MEM_RELEASE );
+#else
+		munmap( mapping, mappingSize );
+#endif
+	}
+	memory = NULL;
+	mapping = NULL;
+	mappingSize = 0;
+	size = 0;
+	used = 0;
+	committed = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// VirtualMemoryPool::clearMemory
+//
+// Resets the allocator internal state. The committed pages above the 
+// release threshold are returned to the system, the rest are kept so that
+// reusing the pool doesn't fault them in again.
+////////////////////////////////////////////////////////////////////////////////
+void VirtualMemoryPool::clearMemory() {
+	used = 0;
+	if ( committed > releaseThreshold ) {
+		decommit( releaseThreshold );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// VirtualMemoryPool::allocBytes
+//
+// Returns uninitialized memory starting at the given power of two alignment,
+// committing more pages if needed. Returns NULL if the reserved range is 
+// exhausted.
+////////////////////////////////////////////////////////////////////////////////
+void* VirtualMemoryPool::allocBytes( size_t bytes, size_t alignment ) {
+	assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0 );
+
+	const size_t address = reinterpret_cast< size_t >( memory + used );
+	const size_t padding = ( alignment - ( address & ( alignment - 1 ) ) ) & ( alignment - 1 );
+	const size_t required = padding + bytes;
+
+	if ( used + required > size ) {
+		std::cerr << "Ran out of memory on virtual memory pool (size = " << size << " bytes)" << std::endl;
+		assert(false);
+		return NULL; 
+	}
+
+	if ( used + required > committed && !commit( used + required ) ) {
+		std::cerr << "Failed to commit virtual memory pool pages" << std::endl;
+		assert(false);
+		return NULL;
+	}
+
+	void* ptr = memory + used + padding;
+	used += required;
+	return ptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// VirtualMemoryPool::commit
+//
+// Makes sure at least the given number of bytes are backed by memory.
+////////////////////////////////////////////////////////////////////////////////
+bool VirtualMemoryPool::commit( size_t bytes ) {
+	size_t newCommitted = ( bytes + commitGranularity - 1 ) & ~( commitGranularity - 1 );
+	if ( newCommitted > size ) {
+		newCommitted = size;
+	}
+	if ( newCommitted <= committed ) {
+		return true;
+	}
+#if defined( _WIN32 )
+	if ( VirtualAlloc( memory + committed, newCommitted - committed, MEM_COMMIT, PAGE_READWRITE ) == NULL ) {
+		return false;
+	}
+#else
+	if ( mprotect( memory + committed, newCommitted - committed, PROT_READ | PROT_WRITE ) != 0 ) {
+		return false;
+	}
+#endif
+	committed = newCommitted;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// VirtualMemoryPool::decommit
+//
+// Returns the pages beyond the given number of bytes to the system.
+////////////////////////////////////////////////////////////////////////////////
+void VirtualMemoryPool::decommit( size_t bytes ) {
+	const size_t newCommitted = ( bytes + commitGranularity - 1 ) & ~( commitGranularity - 1 );
+	if ( newCommitted >= committed ) {
+		return;
+	}
+#if defined( _WIN32 )
+	VirtualFree( memory + newCommitted, committed - newCommitted, MEM_DECOMMIT );
+#else
+	madvise( memory + newCommitted, committed - newCommitted, MADV_DONTNEED );
+	mprotect( memory + newCommitted, committed - newCommitted, PROT_NONE );
+#endif
+	committed = newCommitted;
+}
+
+} // namespace Memory
+} // namespace CoreLib
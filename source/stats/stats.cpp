@@ -0,0 +1,179 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#include <stats/stats.h>
+#include <stdio.h>
+#include <mutex>
+
+#if defined( __GNUC__ )
+#include <cxxabi.h>
+#include <stdlib.h>
+#endif
+
+namespace CoreLib {
+namespace Stats {
+
+struct Source {
+	std::string		name;
+	const void*		object;
+	SampleCallback	callback;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Registry
+//
+// Every registered statistics source.
+//////////////////////////////////////////////////////////////////////////
+struct Registry {
+	std::mutex				mutex;
+	std::vector< Source >	sources;
+
+	// never destroyed, as sources with static storage (e.g. the static 
+	// memory pool) may unregister after any function local static is gone
+	static Registry& get() {
+		static Registry* registry = new Registry();
+		return *registry;
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////
+// addSource
+//////////////////////////////////////////////////////////////////////////
+void addSource( const char* name, const void* object, SampleCallback callback ) {
+	Registry& registry = Registry::get();
+	std::lock_guard< std::mutex > lock( registry.mutex );
+
+	Source source;
+	source.name = name;
+	source.object = object;
+	source.callback = callback;
+
+	// keep names unique, so that the samples can be told apart
+	for( unsigned int suffix = 2; ; suffix++ ) {
+		bool unique = true;
+		for( size_t i = 0; i < registry.sources.size() && unique; i++ ) {
+			unique = registry.sources[ i ].name != source.name;
+		}
+		if ( unique ) {
+			break;
+		}
+		char buffer[ 16 ];
+		snprintf( buffer, sizeof( buffer ), "#%u", suffix );
+		source.name = std::string( name ) + buffer;
+	}
+
+	registry.sources.push_back( source );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// removeSource
+//////////////////////////////////////////////////////////////////////////
+void removeSource( const void* object ) {
+	Registry& registry = Registry::get();
+	std::lock_guard< std::mutex > lock( registry.mutex );
+	for( size_t i = 0; i < registry.sources.size(); i++ ) {
+		if ( registry.sources[ i ].object == object ) {
+			registry.sources[ i ] = registry.sources.back();
+			registry.sources.pop_back();
+			return;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// typeName
+//////////////////////////////////////////////////////////////////////////
+std::string typeName( const std::type_info& type ) {
+#if defined( __GNUC__ )
+	int status = 0;
+	char* demangled = abi::__cxa_demangle( type.name(), NULL, NULL, &status );
+	if ( demangled != NULL ) {
+		std::string name( demangled );
+		free( demangled );
+		return name;
+	}
+#endif
+	return type.name();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// sampleCounters
+//////////////////////////////////////////////////////////////////////////
+void sampleCounters( Snapshot& snapshot, const std::string& name, const char* const* counterNames, const std::atomic< uint64_t >* counters, size_t numCounters ) {
+	for( size_t i = 0; i < numCounters; i++ ) {
+		snapshot.add( name + "." + counterNames[ i ], counters[ i ].load( std::memory_order_relaxed ) );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Snapshot::add
+//////////////////////////////////////////////////////////////////////////
+void Snapshot::add( const std::string& name, uint64_t value ) {
+	Sample sample;
+	sample.name = name;
+	sample.value = value;
+	samples.push_back( sample );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Snapshot::find
+//////////////////////////////////////////////////////////////////////////
+const Sample* Snapshot::find( const std::string& name ) const {
+	for( size_t i = 0; i < samples.size(); i++ ) {
+		if ( samples[ i ].name == name ) {
+			return &samples[ i ];
+		}
+	}
+	return NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// snapshot
+//
+// Samples every registered source. Sources must not be registered or 
+// unregistered from their sampling callbacks.
+//////////////////////////////////////////////////////////////////////////
+void snapshot( Snapshot& snapshot ) {
+	Registry& registry = Registry::get();
+	std::lock_guard< std::mutex > lock( registry.mutex );
+	for( size_t i = 0; i < registry.sources.size(); i++ ) {
+		const Source& source = registry.sources[ i ];
+		source.callback( source.object, source.name, snapshot );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// report
+//
+// Writes every sample as a "name value" line.
+//////////////////////////////////////////////////////////////////////////
+void report( std::ostream& out ) {
+	Snapshot samples;
+	snapshot( samples );
+	for( size_t i = 0; i < samples.size(); i++ ) {
+		out << samples[ i ].name << " " << samples[ i ].value << "\n";
+	}
+	out.flush();
+}
+
+} // namespace Stats
+} // namespace CoreLib
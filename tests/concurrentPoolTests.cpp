@@ -0,0 +1,220 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Concurrent pool tests
+//
+// ConcurrentMemoryPool: aligned allocations within the pool, carving 
+// private chunks out of it, running out of memory, and threads allocating
+// and carving at once never being handed overlapping memory.
+//////////////////////////////////////////////////////////////////////////
+
+#include "testing.h"
+#include <memory/concurrentPool.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace CoreLib;
+using namespace CoreLib::Memory;
+using namespace CoreLib::Tests;
+
+namespace {
+
+	const size_t NUM_THREADS = 4;
+
+	struct Block {
+		uintptr_t	begin;
+		uintptr_t	end;
+		size_t		owner;
+
+		bool operator<( const Block& other ) const { return begin < other.begin; }
+	};
+
+	bool isAligned( const void* ptr, size_t alignment ) {
+		return ( reinterpret_cast< uintptr_t >( ptr ) & ( alignment - 1 ) ) == 0;
+	}
+
+	// sorts the blocks, and checks they don't overlap and lie within the 
+	// first allocation and the end of the pool
+	void checkDisjoint( std::vector< Block >& blocks, uintptr_t poolBegin, uintptr_t poolEnd ) {
+		std::sort( blocks.begin(), blocks.end() );
+		size_t overlapping = 0;
+		size_t outside = 0;
+		for( size_t i = 0; i < blocks.size(); i++ ) {
+			if ( blocks[ i ].begin < poolBegin || blocks[ i ].end > poolEnd ) {
+				outside++;
+			}
+			if ( i > 0 && blocks[ i ].begin < blocks[ i - 1 ].end ) {
+				overlapping++;
+			}
+		}
+		CORELIB_CHECK( overlapping == 0 );
+		CORELIB_CHECK( outside == 0 );
+	}
+
+	void testAlloc() {
+		const size_t poolSize = 64 * 1024;
+		ConcurrentMemoryPool pool( poolSize );
+		CORELIB_CHECK( pool.getSize() == poolSize );
+		CORELIB_CHECK( pool.getUsed() == 0 );
+
+		char* first = static_cast< char* >( pool.allocBytes( 1, 1 ) );
+		CORELIB_CHECK( first != NULL );
+		const size_t alignments[] = { 1, 2, 8, 16, 32, 64, 256 };
+		for( size_t i = 0; i < sizeof( alignments ) / sizeof( alignments[ 0 ] ); i++ ) {
+			const size_t usedBefore = pool.getUsed();
+			void* ptr = pool.allocBytes( 100, alignments[ i ] );
+			CORELIB_CHECK( ptr != NULL );
+			CORELIB_CHECK( isAligned( ptr, alignments[ i ] ) );
+			CORELIB_CHECK( static_cast< char* >( ptr ) >= first + usedBefore );
+			CORELIB_CHECK( static_cast< char* >( ptr ) + 100 <= first + pool.getUsed() );
+		}
+
+		pool.clearMemory();
+		CORELIB_CHECK( pool.getUsed() == 0 );
+		CORELIB_CHECK( pool.allocBytes( 1, 1 ) == first );
+	}
+
+	void testCarve() {
+		const size_t poolSize = 64 * 1024;
+		ConcurrentMemoryPool pool( poolSize );
+		char* base = static_cast< char* >( pool.allocBytes( 16, 16 ) );
+
+		MemoryPool chunk;
+		CORELIB_CHECK( pool.carve( 1000, chunk ) );
+		CORELIB_CHECK( chunk.getSize() == 1000 );
+		CORELIB_CHECK( chunk.getUsed() == 0 );
+		char* carved = static_cast< char* >( chunk.allocBytes( 1, 1 ) );
+		CORELIB_CHECK( carved >= base + 16 && carved + 1000 <= base + pool.getUsed() );
+		void* aligned = chunk.allocBytes( 64, 64 );
+		CORELIB_CHECK( aligned != NULL && isAligned( aligned, 64 ) );
+		CORELIB_CHECK( static_cast< char* >( aligned ) + 64 <= carved + 1000 );
+
+		// the next allocation from the pool comes after the whole chunk
+		char* after = static_cast< char* >( pool.allocBytes( 16, 16 ) );
+		CORELIB_CHECK( after >= carved + 1000 );
+	}
+
+	// running out returns NULL, asserting first in debug builds
+	void testExhaustion() {
+#if defined( NDEBUG )
+		const size_t poolSize = 1024;
+		ConcurrentMemoryPool pool( poolSize );
+		size_t allocations = 0;
+		while( pool.allocBytes( 64, 16 ) != NULL ) {
+			allocations++;
+		}
+		CORELIB_CHECK( allocations == poolSize / 64 );
+		CORELIB_CHECK( pool.allocBytes( 1, 1 ) == NULL );
+		CORELIB_CHECK( pool.getUsed() == poolSize );
+
+		MemoryPool chunk;
+		CORELIB_CHECK( !pool.carve( 16, chunk ) );
+
+		// failed allocations don't stop the pool from being reused
+		pool.clearMemory();
+		CORELIB_CHECK( pool.carve( poolSize, chunk ) );
+		CORELIB_CHECK( !pool.carve( 16, chunk ) );
+#endif
+	}
+
+	// every thread allocates from the shared pool, and carves chunks to 
+	// allocate from privately, filling its blocks with its own byte
+	void testConcurrent() {
+		const size_t allocationsPerThread = 20000;
+		const size_t chunksPerThread = 50;
+		const size_t chunkBytes = 4096;
+		ConcurrentMemoryPool pool( NUM_THREADS * ( allocationsPerThread * 160 + chunksPerThread * chunkBytes ) );
+		const uintptr_t poolBegin = reinterpret_cast< uintptr_t >( pool.allocBytes( 1, 1 ) );
+		const uintptr_t poolEnd = poolBegin + pool.getSize();
+
+		std::vector< std::vector< Block > > blocks( NUM_THREADS );
+		std::vector< std::vector< Block > > chunks( NUM_THREADS );
+		std::vector< size_t > failures( NUM_THREADS, 0 );
+		std::vector< std::thread > threads;
+		for( size_t t = 0; t < NUM_THREADS; t++ ) {
+			threads.push_back( std::thread( [ &, t ]() {
+				unsigned int seed = (unsigned int)t + 1;
+				for( size_t i = 0; i < allocationsPerThread; i++ ) {
+					seed = seed * 1664525u + 1013904223u;
+					const size_t bytes = 1 + ( seed >> 16 ) % 128;
+					const size_t alignment = (size_t)1 << ( ( seed >> 8 ) % 6 );
+					void* ptr = pool.allocBytes( bytes, alignment );
+					if ( ptr == NULL || !isAligned( ptr, alignment ) ) {
+						failures[ t ]++;
+						continue;
+					}
+					memset( ptr, (int)t, bytes );
+					Block block = { reinterpret_cast< uintptr_t >( ptr ), reinterpret_cast< uintptr_t >( ptr ) + bytes, t };
+					blocks[ t ].push_back( block );
+
+					if ( i % ( allocationsPerThread / chunksPerThread ) == 0 ) {
+						MemoryPool chunk;
+						if ( !pool.carve( chunkBytes, chunk ) ) {
+							failures[ t ]++;
+							continue;
+						}
+						void* carved = chunk.allocBytes( chunkBytes, 1 );
+						memset( carved, (int)t, chunkBytes );
+						Block chunkBlock = { reinterpret_cast< uintptr_t >( carved ), reinterpret_cast< uintptr_t >( carved ) + chunkBytes, t };
+						chunks[ t ].push_back( chunkBlock );
+					}
+				}
+			} ) );
+		}
+		for( size_t t = 0; t < NUM_THREADS; t++ ) {
+			threads[ t ].join();
+		}
+
+		std::vector< Block > all;
+		size_t failed = 0;
+		for( size_t t = 0; t < NUM_THREADS; t++ ) {
+			failed += failures[ t ];
+			all.insert( all.end(), blocks[ t ].begin(), blocks[ t ].end() );
+			all.insert( all.end(), chunks[ t ].begin(), chunks[ t ].end() );
+		}
+		CORELIB_CHECK( failed == 0 );
+		CORELIB_CHECK( all.size() == NUM_THREADS * ( allocationsPerThread + chunksPerThread ) );
+		checkDisjoint( all, poolBegin + 1, poolEnd );
+
+		// no thread wrote over the blocks of another
+		size_t overwritten = 0;
+		for( size_t i = 0; i < all.size(); i++ ) {
+			for( uintptr_t address = all[ i ].begin; address < all[ i ].end; address++ ) {
+				overwritten += *reinterpret_cast< const unsigned char* >( address ) == all[ i ].owner ? 0 : 1;
+			}
+		}
+		CORELIB_CHECK( overwritten == 0 );
+	}
+}
+
+int main() {
+	testAlloc();
+	testCarve();
+	testExhaustion();
+	testConcurrent();
+
+	return finishTests( "concurrentPool" );
+}
@@ -0,0 +1,217 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Job system tests
+//
+// JobSystem scheduling: continuations started against a dependency only 
+// running once it's done, parallelFor nested in jobs, parallelForRange 
+// and wait called from threads which aren't workers, the scratch memory 
+// being rewound after each job, and the results of the parallel List 
+// algorithms.
+//////////////////////////////////////////////////////////////////////////
+
+#include "testing.h"
+#include <algorithms/parallel.h>
+#include <containers/list/list.h>
+#include <jobs/jobSystem.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace CoreLib;
+using namespace CoreLib::Tests;
+
+namespace {
+
+	const size_t NUM_THREADS = 4;
+
+	void testDependencies( Jobs::JobSystem& jobs ) {
+		for( int round = 0; round < 20; round++ ) {
+			std::atomic< int > dependenciesDone( 0 );
+			std::atomic< int > continuationsRun( 0 );
+			std::atomic< int > earlyContinuations( 0 );
+			Jobs::JobCounter dependency;
+			Jobs::JobCounter continuations;
+			for( int i = 0; i < 4; i++ ) {
+				jobs.run( [ & ]() {
+					std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+					dependenciesDone++;
+				}, dependency );
+			}
+			for( int i = 0; i < 4; i++ ) {
+				jobs.run( [ & ]() {
+					if ( dependenciesDone != 4 ) {
+						earlyContinuations++;
+					}
+					continuationsRun++;
+				}, continuations, dependency );
+			}
+			jobs.wait( continuations );
+			CORELIB_CHECK( dependency.isDone() );
+			CORELIB_CHECK( continuationsRun == 4 );
+			CORELIB_CHECK( earlyContinuations == 0 );
+		}
+
+		// a dependency already done starts the job right away
+		Jobs::JobCounter done;
+		Jobs::JobCounter counter;
+		bool ran = false;
+		jobs.run( [ & ]() { ran = true; }, counter, done );
+		jobs.wait( counter );
+		CORELIB_CHECK( ran );
+	}
+
+	void testNestedParallelFor( Jobs::JobSystem& jobs ) {
+		const size_t outer = 16;
+		const size_t inner = 100;
+		std::vector< std::atomic< int > > hits( outer * inner );
+		for( size_t i = 0; i < hits.size(); i++ ) {
+			hits[ i ] = 0;
+		}
+		Jobs::JobCounter counter;
+		for( size_t o = 0; o < outer; o++ ) {
+			jobs.run( [ &, o ]() {
+				jobs.parallelFor( inner, [ & ]( size_t i ) {
+					hits[ o * inner + i ]++;
+				} );
+			}, counter );
+		}
+		jobs.wait( counter );
+		for( size_t i = 0; i < hits.size(); i++ ) {
+			CORELIB_CHECK( hits[ i ] == 1 );
+		}
+	}
+
+	void testExternalThread( Jobs::JobSystem& jobs ) {
+		std::thread external( [ & ]() {
+			CORELIB_CHECK( Jobs::JobSystem::getScratchPool() == NULL );
+
+			const size_t count = 100000;
+			std::vector< std::atomic< int > > hits( count );
+			for( size_t i = 0; i < count; i++ ) {
+				hits[ i ] = 0;
+			}
+			jobs.parallelForRange( 0, count, 1000, [ & ]( size_t first, size_t last ) {
+				CORELIB_CHECK( first < last && last - first <= 1000 );
+				for( size_t i = first; i < last; i++ ) {
+					hits[ i ]++;
+				}
+			} );
+			size_t wrong = 0;
+			for( size_t i = 0; i < count; i++ ) {
+				wrong += hits[ i ] == 1 ? 0 : 1;
+			}
+			CORELIB_CHECK( wrong == 0 );
+
+			std::atomic< int > ran( 0 );
+			Jobs::JobCounter counter;
+			for( int i = 0; i < 8; i++ ) {
+				jobs.run( [ & ]() { ran++; }, counter );
+			}
+			jobs.wait( counter );
+			CORELIB_CHECK( ran == 8 );
+		} );
+		external.join();
+	}
+
+	// every job allocates most of its worker's scratch pool, so the jobs 
+	// only fit if the pool is rewound after each of them
+	void testScratchRewind() {
+		const size_t scratchBytes = 16 * 1024;
+		Jobs::JobSystem jobs( NUM_THREADS, scratchBytes );
+		std::atomic< int > failedAllocations( 0 );
+		std::atomic< int > dirtyPools( 0 );
+		Jobs::JobCounter counter;
+		for( int i = 0; i < 1000; i++ ) {
+			jobs.run( [ & ]() {
+				Memory::MemoryPool* pool = Jobs::JobSystem::getScratchPool();
+				if ( pool == NULL || pool->getUsed() != 0 ) {
+					dirtyPools++;
+				}
+				char* bytes = Jobs::ScratchAllocator< char >::allocRaw( scratchBytes * 3 / 4 );
+				if ( bytes == NULL ) {
+					failedAllocations++;
+				} else {
+					bytes[ 0 ] = bytes[ scratchBytes * 3 / 4 - 1 ] = 1;
+				}
+			}, counter );
+		}
+		jobs.wait( counter );
+		CORELIB_CHECK( failedAllocations == 0 );
+		CORELIB_CHECK( dirtyPools == 0 );
+		CORELIB_CHECK( Jobs::JobSystem::getScratchPool()->getUsed() == 0 );
+	}
+
+	void testAlgorithms( Jobs::JobSystem& jobs ) {
+		const size_t sizes[] = { 0, 1, 1000, 100003 };
+		for( size_t s = 0; s < sizeof( sizes ) / sizeof( sizes[ 0 ] ); s++ ) {
+			const size_t n = sizes[ s ];
+			List< int > input;
+			for( size_t i = 0; i < n; i++ ) {
+				input.append( (int)( ( i * 2654435761u ) % 1000 ) - 500 );
+			}
+
+			List< long long > squares;
+			Algorithms::parallelTransform( jobs, input, squares, []( int x ) { return (long long)x * x; } );
+			CORELIB_CHECK( squares.size() == n );
+			size_t wrong = 0;
+			long long sumOfSquares = 0;
+			long long sum = 0;
+			int maximum = -1000;
+			for( size_t i = 0; i < n; i++ ) {
+				wrong += squares[ i ] == (long long)input[ i ] * input[ i ] ? 0 : 1;
+				sumOfSquares += squares[ i ];
+				sum += input[ i ];
+				maximum = input[ i ] > maximum ? input[ i ] : maximum;
+			}
+			CORELIB_CHECK( wrong == 0 );
+
+			for( size_t grain = 0; grain < 3000; grain += 777 ) {
+				CORELIB_CHECK( Algorithms::parallelReduce( jobs, squares, 0LL, []( long long a, long long b ) { return a + b; }, grain ) == sumOfSquares );
+				CORELIB_CHECK( Algorithms::parallelReduce( jobs, input, 0LL, []( long long a, int x ) { return a + x; }, []( long long a, long long b ) { return a + b; }, grain ) == sum );
+				CORELIB_CHECK( Algorithms::parallelReduce( jobs, input, -1000, []( int a, int b ) { return a > b ? a : b; }, grain ) == maximum );
+			}
+		}
+	}
+}
+
+int main() {
+	{
+		Jobs::JobSystem jobs( NUM_THREADS );
+		testDependencies( jobs );
+		testNestedParallelFor( jobs );
+		testExternalThread( jobs );
+		testAlgorithms( jobs );
+	}
+	{
+		// jobs only run while the creating thread waits
+		Jobs::JobSystem jobs( 1 );
+		testDependencies( jobs );
+		testNestedParallelFor( jobs );
+		testAlgorithms( jobs );
+	}
+	testScratchRewind();
+
+	return finishTests( "jobs" );
+}
@@ -0,0 +1,275 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Kernel tests
+//
+// Checks that the search and reduction kernels return the same results,
+// bit for bit, on every instruction set the CPU supports as the scalar 
+// versions do, over a range of sizes (covering the vector loop tails) and
+// over edge case values: NaNs at the start, middle and end of the data, 
+// signed zeros, infinities, the integer limits and integer sums 
+// overflowing 32 bits.
+//
+// As documented in kernels.h, floating point min / max over zeros of both
+// signs may return either zero, and NaN sums any NaN.
+//
+// Returns a non zero exit code, listing the mismatches, on failure.
+//////////////////////////////////////////////////////////////////////////
+
+#include "testing.h"
+#include <algorithms/kernels.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace CoreLib;
+using namespace CoreLib::Algorithms;
+using namespace CoreLib::Tests;
+
+namespace {
+
+	const char* instructionSetName( Simd::InstructionSet instructionSet ) {
+		switch( instructionSet ) {
+			case Simd::INSTRUCTIONS_AVX2: return "avx2";
+			case Simd::INSTRUCTIONS_SSE2: return "sse2";
+			default: return "scalar";
+		}
+	}
+
+	template< class T >
+	bool identical( const T& a, const T& b ) {
+		// bitwise, so floating point results must match exactly
+		return memcmp( &a, &b, sizeof( T ) ) == 0;
+	}
+
+	template< class T >
+	bool isNaN( const T& value ) {
+		return value != value;
+	}
+
+	// bitwise when exact, otherwise results compare equal, so that -0 and +0
+	// match, or are both NaN
+	template< class T >
+	bool matches( const T& a, const T& b, bool exact ) {
+		return exact ? identical( a, b ) : ( a == b || ( isNaN( a ) && isNaN( b ) ) );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Data sets
+	//
+	// Each one fills n values, which may be 0.
+	//////////////////////////////////////////////////////////////////////////
+
+	// values within a small range, so that searches find duplicates
+	template< class T >
+	void fillRandom( std::vector< T >& data, std::mt19937& random ) {
+		for( size_t i = 0; i < data.size(); i++ ) {
+			data[ i ] = (T)( (int)( random() % 2001 ) - 1000 ) / (T)( std::is_floating_point< T >::value ? 8 : 1 );
+		}
+	}
+
+	// the extremes of the type scattered over random values
+	template< class T >
+	void fillLimits( std::vector< T >& data, std::mt19937& random ) {
+		fillRandom( data, random );
+		for( size_t i = 0; i < data.size(); i += 3 ) {
+			data[ i ] = ( i / 3 ) % 2 == 0 ? std::numeric_limits< T >::max() : std::numeric_limits< T >::lowest();
+		}
+	}
+
+	// the largest value everywhere, so that the sum overflows T
+	template< class T >
+	void fillMax( std::vector< T >& data, std::mt19937& ) {
+		for( size_t i = 0; i < data.size(); i++ ) {
+			data[ i ] = std::numeric_limits< T >::max();
+		}
+	}
+
+	// the smallest value everywhere
+	template< class T >
+	void fillLowest( std::vector< T >& data, std::mt19937& ) {
+		for( size_t i = 0; i < data.size(); i++ ) {
+			data[ i ] = std::numeric_limits< T >::lowest();
+		}
+	}
+
+	// -0 and +0 alternating, in runs of different lengths
+	template< class T >
+	void fillSignedZeros( std::vector< T >& data, std::mt19937& random ) {
+		for( size_t i = 0; i < data.size(); i++ ) {
+			data[ i ] = random() % 2 == 0 ? T( -0.0 ) : T( 0.0 );
+		}
+		if ( !data.empty() ) {
+			data[ 0 ] = T( -0.0 );
+		}
+	}
+
+	template< class T, size_t Position >
+	void fillNaN( std::vector< T >& data, std::mt19937& random ) {
+		fillRandom( data, random );
+		if ( !data.empty() ) {
+			const size_t positions[] = { 0, data.size() / 2, data.size() - 1 };
+			data[ positions[ Position ] ] = std::numeric_limits< T >::quiet_NaN();
+		}
+	}
+
+	// infinities and NaNs mixed with values
+	template< class T >
+	void fillSpecials( std::vector< T >& data, std::mt19937& random ) {
+		const T specials[] = { std::numeric_limits< T >::infinity(), -std::numeric_limits< T >::infinity(), std::numeric_limits< T >::quiet_NaN(), T( -0.0 ), T( 0.0 ) };
+		fillRandom( data, random );
+		for( size_t i = 0; i < data.size(); i++ ) {
+			if ( random() % 4 == 0 ) {
+				data[ i ] = specials[ random() % 5 ];
+			}
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// checkKernels
+	//
+	// Compares every kernel against its scalar version on the data, min / max
+	// and sum bitwise unless the data mixes signed zeros and NaNs.
+	//////////////////////////////////////////////////////////////////////////
+	template< class T >
+	void checkKernels( const std::vector< T >& data, const std::vector< T >& searches, const std::string& name, bool exact ) {
+		const Simd::InstructionSet supported = Simd::getSupportedInstructionSet();
+		const T* p = data.data();
+		const size_t n = data.size();
+
+		for( int set = Simd::INSTRUCTIONS_SSE2; set <= supported; set++ ) {
+			Simd::setInstructionSet( (Simd::InstructionSet)set );
+			std::ostringstream where;
+			where << name << " " << instructionSetName( (Simd::InstructionSet)set ) << " n=" << n << ": ";
+
+			for( size_t v = 0; v < searches.size(); v++ ) {
+				if ( Simd::findIndex( p, n, searches[ v ] ) != Scalar::findIndex( p, n, searches[ v ] ) ) {
+					reportFailure( where.str() + "findIndex" );
+				}
+				if ( Simd::count( p, n, searches[ v ] ) != Scalar::count( p, n, searches[ v ] ) ) {
+					reportFailure( where.str() + "count" );
+				}
+				if ( Simd::contains( p, n, searches[ v ] ) != Scalar::contains( p, n, searches[ v ] ) ) {
+					reportFailure( where.str() + "contains" );
+				}
+			}
+			if ( n > 0 && !matches( Simd::min( p, n ), Scalar::min( p, n ), exact ) ) {
+				reportFailure( where.str() + "min" );
+			}
+			if ( n > 0 && !matches( Simd::max( p, n ), Scalar::max( p, n ), exact ) ) {
+				reportFailure( where.str() + "max" );
+			}
+			if ( !matches( Simd::sum( p, n ), Scalar::sum( p, n ), exact ) ) {
+				reportFailure( where.str() + "sum" );
+			}
+		}
+		Simd::setInstructionSet( supported );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// testDataSet
+	//
+	// Checks the kernels over the data set at every size up to a few vectors
+	// past the widest loop, plus larger ones.
+	//////////////////////////////////////////////////////////////////////////
+	template< class T >
+	void testDataSet( void ( *fill )( std::vector< T >&, std::mt19937& ), const std::string& name, const std::vector< T >& extraSearches, bool exact = true ) {
+		std::mt19937 random( 1234 );
+
+		std::vector< size_t > sizes;
+		for( size_t n = 0; n <= 70; n++ ) {
+			sizes.push_back( n );
+		}
+		sizes.push_back( 1000 );
+		sizes.push_back( 100003 );
+
+		for( size_t s = 0; s < sizes.size(); s++ ) {
+			const size_t n = sizes[ s ];
+			std::vector< T > data( n );
+			fill( data, random );
+
+			std::vector< T > searches( extraSearches );
+			searches.push_back( T( 5000 ) );
+			if ( n > 0 ) {
+				searches.push_back( data[ 0 ] );
+				searches.push_back( data[ n / 2 ] );
+				searches.push_back( data[ n - 1 ] );
+			}
+			checkKernels( data, searches, name, exact );
+		}
+	}
+
+	template< class T >
+	void testIntegers( const std::string& typeName ) {
+		std::vector< T > searches;
+		searches.push_back( std::numeric_limits< T >::max() );
+		searches.push_back( std::numeric_limits< T >::lowest() );
+
+		testDataSet< T >( fillRandom< T >, typeName + " random", searches );
+		testDataSet< T >( fillLimits< T >, typeName + " limits", searches );
+		testDataSet< T >( fillMax< T >, typeName + " max", searches );
+		testDataSet< T >( fillLowest< T >, typeName + " lowest", searches );
+	}
+
+	template< class T >
+	void testFloats( const std::string& typeName ) {
+		std::vector< T > searches;
+		searches.push_back( std::numeric_limits< T >::quiet_NaN() );
+		searches.push_back( T( -0.0 ) );
+		searches.push_back( T( 0.0 ) );
+		searches.push_back( std::numeric_limits< T >::infinity() );
+
+		testDataSet< T >( fillRandom< T >, typeName + " random", searches );
+		testDataSet< T >( fillNaN< T, 0 >, typeName + " NaN first", searches );
+		testDataSet< T >( fillNaN< T, 1 >, typeName + " NaN middle", searches );
+		testDataSet< T >( fillNaN< T, 2 >, typeName + " NaN last", searches );
+		testDataSet< T >( fillSignedZeros< T >, typeName + " signed zeros", searches, false );
+		testDataSet< T >( fillSpecials< T >, typeName + " specials", searches, false );
+		testDataSet< T >( fillLimits< T >, typeName + " limits", searches );
+		testDataSet< T >( fillMax< T >, typeName + " max", searches );
+	}
+}
+
+int main() {
+	const Simd::InstructionSet supported = Simd::getSupportedInstructionSet();
+	printf( "checking the %s kernels against the scalar ones\n", instructionSetName( supported ) );
+
+	testIntegers< int >( "int" );
+	testIntegers< unsigned int >( "unsigned int" );
+	testFloats< float >( "float" );
+	testFloats< double >( "double" );
+
+	// sums must not wrap around at 32 bits
+	const std::vector< int > overflow( 1000, INT_MAX );
+	CORELIB_CHECK( Algorithms::sum( overflow.data(), overflow.size() ) == 1000LL * INT_MAX );
+	const std::vector< unsigned int > overflowUnsigned( 1000, UINT_MAX );
+	CORELIB_CHECK( Algorithms::sum( overflowUnsigned.data(), overflowUnsigned.size() ) == 1000ULL * UINT_MAX );
+
+	return finishTests( "kernels" );
+}
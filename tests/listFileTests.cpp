@@ -0,0 +1,287 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// List file tests
+//
+// Lists written with writeListFile and opened in place through MappedList,
+// read only and copy on write, and the files MappedList must refuse: 
+// another userVersion, truncated files, corrupt headers and, when asked 
+// to verify the checksum, corrupt elements. Files streamed with 
+// ListStreamWriter, in chunks which don't divide the element count, must 
+// be the same as written at once, read back through ListStreamReader and
+// open through MappedList.
+//
+// The files are created in the working directory.
+//////////////////////////////////////////////////////////////////////////
+
+#include "testing.h"
+#include <containers/list/listFile.h>
+#include <containers/list/listStream.h>
+#include <containers/list/mappedList.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace CoreLib;
+using namespace CoreLib::Tests;
+
+namespace {
+
+	struct Record {
+		int		id;
+		float	value;
+		double	weight;
+	};
+
+	const uint32_t RECORD_VERSION = 3;
+	const char* LIST_PATH = "listFileTests.bin";
+	const char* DAMAGED_PATH = "listFileTestsDamaged.bin";
+	const char* STREAM_PATH = "listFileTestsStream.bin";
+
+	Record makeRecord( size_t i ) {
+		Record record;
+		record.id = (int)i;
+		record.value = (float)i * 0.5f;
+		record.weight = (double)( i % 97 );
+		return record;
+	}
+
+	bool sameRecord( const Record& a, const Record& b ) {
+		return a.id == b.id && a.value == b.value && a.weight == b.weight;
+	}
+
+	template< class Records >
+	bool matches( const Records& records, size_t count, size_t first = 0 ) {
+		if ( records.size() != count ) {
+			return false;
+		}
+		for( size_t i = first; i < count; i++ ) {
+			if ( !sameRecord( records[ i ], makeRecord( i ) ) ) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	List< Record > makeRecords( size_t count ) {
+		List< Record > records;
+		records.resize( count );
+		for( size_t i = 0; i < count; i++ ) {
+			records[ i ] = makeRecord( i );
+		}
+		return records;
+	}
+
+	std::vector< char > readFile( const char* path ) {
+		std::vector< char > bytes;
+		FILE* file = fopen( path, "rb" );
+		if ( file != NULL ) {
+			char buffer[ 4096 ];
+			size_t read;
+			while( ( read = fread( buffer, 1, sizeof( buffer ), file ) ) > 0 ) {
+				bytes.insert( bytes.end(), buffer, buffer + read );
+			}
+			fclose( file );
+		}
+		return bytes;
+	}
+
+	void writeFile( const char* path, const std::vector< char >& bytes ) {
+		FILE* file = fopen( path, "wb" );
+		if ( file != NULL ) {
+			fwrite( bytes.data(), 1, bytes.size(), file );
+			fclose( file );
+		}
+	}
+
+	void testRoundTrip( size_t count ) {
+		CORELIB_CHECK( writeListFile( LIST_PATH, makeRecords( count ), RECORD_VERSION ) );
+
+		MappedList< Record > view( LIST_PATH, MappedList< Record >::READ_ONLY, RECORD_VERSION, true );
+		CORELIB_CHECK( view.isOpen() );
+		CORELIB_CHECK( view.getMode() == MappedList< Record >::READ_ONLY );
+		CORELIB_CHECK( matches( view.getList(), count ) );
+		CORELIB_CHECK( view->size() == count );
+		if ( count > 0 ) {
+			CORELIB_CHECK( (size_t)view->begin() % std::alignment_of< Record >::value == 0 );
+		}
+
+		MappedList< Record > copy( LIST_PATH, MappedList< Record >::COPY_ON_WRITE, RECORD_VERSION );
+		CORELIB_CHECK( copy.isOpen() );
+		CORELIB_CHECK( matches( copy.getList(), count ) );
+		view.close();
+		CORELIB_CHECK( !view.isOpen() );
+	}
+
+	// writes to a copy on write view stay private, and growing it moves 
+	// the list off the mapping
+	void testCopyOnWrite( size_t count ) {
+		CORELIB_CHECK( writeListFile( LIST_PATH, makeRecords( count ), RECORD_VERSION ) );
+		{
+			MappedList< Record > copy( LIST_PATH, MappedList< Record >::COPY_ON_WRITE, RECORD_VERSION );
+			CORELIB_CHECK( copy.isOpen() );
+			MappedList< Record >::ListType& records = copy.getMutableList();
+			if ( count > 0 ) {
+				records[ 0 ].id = -1;
+			}
+			records.setGranularity( 1024 );
+			for( size_t i = count; i < count + 1000; i++ ) {
+				records.append( makeRecord( i ) );
+			}
+			CORELIB_CHECK( matches( records, count + 1000, count > 0 ? 1 : 0 ) );
+			CORELIB_CHECK( count == 0 || records[ 0 ].id == -1 );
+			CORELIB_CHECK( !records.getAllocator().isMapped( records.begin() ) );
+
+			records.resize( count / 2 );
+			CORELIB_CHECK( records.size() == count / 2 );
+		}
+
+		MappedList< Record > view( LIST_PATH, MappedList< Record >::READ_ONLY, RECORD_VERSION, true );
+		CORELIB_CHECK( view.isOpen() );
+		CORELIB_CHECK( matches( view.getList(), count ) );
+	}
+
+	void testRejected() {
+		const size_t count = 1000;
+		CORELIB_CHECK( writeListFile( LIST_PATH, makeRecords( count ), RECORD_VERSION ) );
+		const std::vector< char > bytes = readFile( LIST_PATH );
+		const size_t dataOffset = listFileDataOffset( std::alignment_of< Record >::value );
+		CORELIB_CHECK( bytes.size() == dataOffset + count * sizeof( Record ) );
+
+		MappedList< Record > view;
+		CORELIB_CHECK( view.open( LIST_PATH, MappedList< Record >::READ_ONLY, RECORD_VERSION, true ) );
+		CORELIB_CHECK( !view.open( LIST_PATH, MappedList< Record >::READ_ONLY, RECORD_VERSION + 1 ) );
+		CORELIB_CHECK( !view.isOpen() );
+		CORELIB_CHECK( !view.open( "listFileTestsMissing.bin" ) );
+
+		// another element type
+		MappedList< int > ints;
+		CORELIB_CHECK( !ints.open( LIST_PATH, MappedList< int >::READ_ONLY, RECORD_VERSION ) );
+
+		// truncated within the elements, and within the header
+		const size_t truncatedSizes[] = { bytes.size() - 1, dataOffset + sizeof( Record ) / 2, sizeof( ListFileHeader ) - 1, 0 };
+		for( size_t i = 0; i < sizeof( truncatedSizes ) / sizeof( truncatedSizes[ 0 ] ); i++ ) {
+			writeFile( DAMAGED_PATH, std::vector< char >( bytes.begin(), bytes.begin() + truncatedSizes[ i ] ) );
+			CORELIB_CHECK( !view.open( DAMAGED_PATH, MappedList< Record >::READ_ONLY, RECORD_VERSION ) );
+		}
+
+		// a corrupt element only shows up when verifying the checksum
+		std::vector< char > corrupt( bytes );
+		corrupt[ dataOffset + count * sizeof( Record ) / 2 ] ^= 0x10;
+		writeFile( DAMAGED_PATH, corrupt );
+		CORELIB_CHECK( !view.open( DAMAGED_PATH, MappedList< Record >::READ_ONLY, RECORD_VERSION, true ) );
+		CORELIB_CHECK( !view.open( DAMAGED_PATH, MappedList< Record >::COPY_ON_WRITE, RECORD_VERSION, true ) );
+		CORELIB_CHECK( view.open( DAMAGED_PATH, MappedList< Record >::READ_ONLY, RECORD_VERSION, false ) );
+		view.close();
+
+		// a corrupt header never opens
+		corrupt = bytes;
+		corrupt[ offsetof( ListFileHeader, count ) ] ^= 0x01;
+		writeFile( DAMAGED_PATH, corrupt );
+		CORELIB_CHECK( !view.open( DAMAGED_PATH, MappedList< Record >::READ_ONLY, RECORD_VERSION ) );
+		corrupt = bytes;
+		corrupt[ 0 ] = 'X';
+		writeFile( DAMAGED_PATH, corrupt );
+		CORELIB_CHECK( !view.open( DAMAGED_PATH, MappedList< Record >::READ_ONLY, RECORD_VERSION ) );
+
+		// validateListFile on memory
+		CORELIB_CHECK( validateListFile( bytes.data(), bytes.size(), sizeof( Record ), std::alignment_of< Record >::value, RECORD_VERSION, true ) != NULL );
+		CORELIB_CHECK( validateListFile( NULL, 0, sizeof( Record ), std::alignment_of< Record >::value, RECORD_VERSION, false ) == NULL );
+
+		remove( DAMAGED_PATH );
+	}
+	// the checksum fed in pieces of any size matches the one computed at once
+	void testIncrementalChecksum() {
+		std::vector< unsigned char > data( 1000 );
+		for( size_t i = 0; i < data.size(); i++ ) {
+			data[ i ] = (unsigned char)( i * 31 + 7 );
+		}
+		const size_t pieceSizes[] = { 1, 3, 8, 31, 32, 33, 100, 1000 };
+		for( size_t bytes = 0; bytes <= data.size(); bytes += 97 ) {
+			const uint64_t expected = listFileChecksum( data.data(), bytes );
+			for( size_t p = 0; p < sizeof( pieceSizes ) / sizeof( pieceSizes[ 0 ] ); p++ ) {
+				ListFileChecksum checksum;
+				for( size_t i = 0; i < bytes; i += pieceSizes[ p ] ) {
+					checksum.update( data.data() + i, bytes - i < pieceSizes[ p ] ? bytes - i : pieceSizes[ p ] );
+				}
+				CORELIB_CHECK( checksum.finish() == expected );
+			}
+		}
+	}
+
+	void testStream( size_t count ) {
+		// 7 elements per chunk written, 13 per chunk read
+		const size_t writeChunkBytes = 7 * sizeof( Record );
+		const size_t readChunkBytes = 13 * sizeof( Record );
+		const List< Record > records = makeRecords( count );
+
+		ListStreamWriter< Record > writer( STREAM_PATH, RECORD_VERSION, writeChunkBytes );
+		CORELIB_CHECK( writer.isOpen() );
+		const size_t single = count / 3;
+		for( size_t i = 0; i < single; i++ ) {
+			writer.append( records[ i ] );
+		}
+		writer.appendRange( records.begin() + single, count - single );
+		CORELIB_CHECK( writer.size() == count );
+		CORELIB_CHECK( writer.close() );
+
+		CORELIB_CHECK( writeListFile( LIST_PATH, records, RECORD_VERSION ) );
+		CORELIB_CHECK( readFile( STREAM_PATH ) == readFile( LIST_PATH ) );
+
+		ListStreamReader< Record > reader( STREAM_PATH, RECORD_VERSION, readChunkBytes, true );
+		CORELIB_CHECK( reader.isOpen() );
+		CORELIB_CHECK( reader.size() == count );
+		List< Record > read;
+		size_t numChunks = 0;
+		CORELIB_CHECK( reader.forEachChunk( [ & ]( Span< const Record > chunk ) {
+			read.appendRange( chunk.begin(), chunk.size() );
+			numChunks++;
+		} ) );
+		CORELIB_CHECK( !reader.hasFailed() );
+		CORELIB_CHECK( numChunks == ( count + 12 ) / 13 );
+		CORELIB_CHECK( matches( read, count ) );
+		reader.close();
+
+		MappedList< Record > view( STREAM_PATH, MappedList< Record >::READ_ONLY, RECORD_VERSION, true );
+		CORELIB_CHECK( view.isOpen() );
+		CORELIB_CHECK( matches( view.getList(), count ) );
+		view.close();
+
+		remove( STREAM_PATH );
+	}
+}
+
+int main() {
+	const size_t counts[] = { 0, 1, 3, 100000 };
+	for( size_t i = 0; i < sizeof( counts ) / sizeof( counts[ 0 ] ); i++ ) {
+		testRoundTrip( counts[ i ] );
+		testCopyOnWrite( counts[ i ] );
+		testStream( counts[ i ] );
+	}
+	testStream( 1000 );
+	testIncrementalChecksum();
+	testRejected();
+
+	remove( LIST_PATH );
+	return finishTests( "listFiles" );
+}
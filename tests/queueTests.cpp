@@ -0,0 +1,238 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+//////////////////////////////////////////////////////////////////////////
+// Queue tests
+//
+// SpscQueue and MpmcQueue: capacity rounding, push / pop failing on a 
+// full or empty queue, FIFO order, partial pushRange / popRange across 
+// the point where the ring wraps around, destruction of the elements 
+// left in the queue, and no element lost or duplicated between several 
+// producer and consumer threads.
+//////////////////////////////////////////////////////////////////////////
+
+#include "testing.h"
+#include <containers/queue/mpmcQueue.h>
+#include <containers/queue/spscQueue.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CoreLib;
+using namespace CoreLib::Tests;
+
+namespace {
+
+	// counts the live instances, to check every element gets destroyed
+	struct Tracked {
+		static std::atomic< int > live;
+
+		Tracked() : value( 0 ) { live++; }
+		explicit Tracked( int value ) : value( value ) { live++; }
+		Tracked( const Tracked& other ) : value( other.value ) { live++; }
+		Tracked& operator=( const Tracked& other ) { value = other.value; return *this; }
+		~Tracked() { live--; }
+
+		int value;
+	};
+	std::atomic< int > Tracked::live( 0 );
+
+	template< class Queue >
+	void testCapacity() {
+		CORELIB_CHECK( Queue( 1 ).capacity() == 1 );
+		CORELIB_CHECK( Queue( 2 ).capacity() == 2 );
+		CORELIB_CHECK( Queue( 5 ).capacity() == 8 );
+		CORELIB_CHECK( Queue( 1000 ).capacity() == 1024 );
+		CORELIB_CHECK( Queue( 1024 ).capacity() == 1024 );
+	}
+
+	template< class Queue >
+	void testFullAndEmpty() {
+		Queue queue( 6 );
+		int value = -1;
+		CORELIB_CHECK( queue.empty() );
+		CORELIB_CHECK( !queue.pop( value ) );
+		CORELIB_CHECK( value == -1 );
+
+		for( int i = 0; i < 8; i++ ) {
+			CORELIB_CHECK( queue.push( i ) );
+		}
+		CORELIB_CHECK( queue.size() == 8 );
+		CORELIB_CHECK( !queue.push( 8 ) );
+		CORELIB_CHECK( !queue.emplace( 8 ) );
+		const int more[] = { 8, 9 };
+		CORELIB_CHECK( queue.pushRange( more, 2 ) == 0 );
+
+		for( int i = 0; i < 8; i++ ) {
+			CORELIB_CHECK( queue.pop( value ) );
+			CORELIB_CHECK( value == i );
+		}
+		CORELIB_CHECK( !queue.pop( value ) );
+		CORELIB_CHECK( queue.popRange( &value, 1 ) == 0 );
+		CORELIB_CHECK( queue.empty() );
+	}
+
+	// pushRange and popRange taking part of what they're asked for, with 
+	// the runs crossing the end of the ring
+	template< class Queue >
+	void testRangesAcrossWrap() {
+		Queue queue( 8 );
+		int value;
+		for( int i = 0; i < 5; i++ ) {
+			queue.push( i );
+			queue.pop( value );
+		}
+
+		int in[ 12 ];
+		for( int i = 0; i < 12; i++ ) {
+			in[ i ] = 100 + i;
+		}
+		CORELIB_CHECK( queue.pushRange( in, 12 ) == 8 );
+		CORELIB_CHECK( queue.size() == 8 );
+
+		int out[ 12 ] = { 0 };
+		CORELIB_CHECK( queue.popRange( out, 2 ) == 2 );
+		CORELIB_CHECK( out[ 0 ] == 100 && out[ 1 ] == 101 );
+		CORELIB_CHECK( queue.pushRange( in + 8, 4 ) == 2 );
+		CORELIB_CHECK( queue.popRange( out, 12 ) == 8 );
+		for( int i = 0; i < 8; i++ ) {
+			CORELIB_CHECK( out[ i ] == 102 + i );
+		}
+		CORELIB_CHECK( queue.empty() );
+	}
+
+	template< class Queue >
+	void testLeftoverDestruction() {
+		{
+			Queue queue( 4 );
+			Tracked element;
+			for( int i = 0; i < 3; i++ ) {
+				queue.push( Tracked( i ) );
+				queue.pop( element );
+			}
+			// wrapped around, two elements left
+			queue.push( Tracked( 10 ) );
+			queue.push( Tracked( 11 ) );
+			queue.push( Tracked( 12 ) );
+			queue.pop( element );
+			CORELIB_CHECK( element.value == 10 );
+			CORELIB_CHECK( Tracked::live == 3 );
+		}
+		CORELIB_CHECK( Tracked::live == 0 );
+
+		{
+			Queue queue( 4 );
+			const Tracked batch[ 3 ] = { Tracked( 1 ), Tracked( 2 ), Tracked( 3 ) };
+			queue.pushRange( batch, 3 );
+			CORELIB_CHECK( Tracked::live == 6 );
+		}
+		CORELIB_CHECK( Tracked::live == 0 );
+	}
+
+	// each producer pushes its share of [0, n), each consumer pops its share
+	template< class Queue >
+	void testTransfer( size_t producers, size_t consumers, bool batched ) {
+		const size_t n = 200000;
+		const size_t batch = 16;
+		Queue queue( 64 );
+		std::atomic< unsigned long long > total( 0 );
+		std::atomic< size_t > count( 0 );
+		std::vector< std::thread > threads;
+		for( size_t p = 0; p < producers; p++ ) {
+			threads.push_back( std::thread( [ &, p ]() {
+				const size_t end = n * ( p + 1 ) / producers;
+				size_t values[ batch ];
+				for( size_t i = n * p / producers; i < end; ) {
+					size_t pushed;
+					if ( batched ) {
+						const size_t wanted = end - i < batch ? end - i : batch;
+						for( size_t j = 0; j < wanted; j++ ) {
+							values[ j ] = i + j;
+						}
+						pushed = queue.pushRange( values, wanted );
+					} else {
+						pushed = queue.push( i ) ? 1 : 0;
+					}
+					if ( pushed == 0 ) {
+						std::this_thread::yield();
+					}
+					i += pushed;
+				}
+			} ) );
+		}
+		for( size_t c = 0; c < consumers; c++ ) {
+			threads.push_back( std::thread( [ &, c ]() {
+				const size_t quota = n * ( c + 1 ) / consumers - n * c / consumers;
+				unsigned long long sum = 0;
+				size_t values[ batch ];
+				size_t received = 0;
+				while( received < quota ) {
+					size_t popped;
+					if ( batched ) {
+						popped = queue.popRange( values, quota - received < batch ? quota - received : batch );
+					} else {
+						popped = queue.pop( values[ 0 ] ) ? 1 : 0;
+					}
+					if ( popped == 0 ) {
+						std::this_thread::yield();
+					}
+					for( size_t j = 0; j < popped; j++ ) {
+						sum += values[ j ];
+					}
+					received += popped;
+				}
+				total += sum;
+				count += received;
+			} ) );
+		}
+		for( size_t i = 0; i < threads.size(); i++ ) {
+			threads[ i ].join();
+		}
+		CORELIB_CHECK( count == n );
+		CORELIB_CHECK( total == (unsigned long long)n * ( n - 1 ) / 2 );
+		CORELIB_CHECK( queue.empty() );
+	}
+
+	template< class IntQueue, class TrackedQueue >
+	void testQueue() {
+		testCapacity< IntQueue >();
+		testFullAndEmpty< IntQueue >();
+		testRangesAcrossWrap< IntQueue >();
+		testLeftoverDestruction< TrackedQueue >();
+	}
+}
+
+int main() {
+	testQueue< SpscQueue< int >, SpscQueue< Tracked > >();
+	testTransfer< SpscQueue< size_t > >( 1, 1, false );
+	testTransfer< SpscQueue< size_t > >( 1, 1, true );
+
+	testQueue< MpmcQueue< int >, MpmcQueue< Tracked > >();
+	for( int batched = 0; batched < 2; batched++ ) {
+		testTransfer< MpmcQueue< size_t > >( 4, 1, batched != 0 );
+		testTransfer< MpmcQueue< size_t > >( 1, 4, batched != 0 );
+		testTransfer< MpmcQueue< size_t > >( 4, 4, batched != 0 );
+	}
+
+	return finishTests( "queues" );
+}
@@ -0,0 +1,68 @@
+/*
+	================================================================================
+	This software is released under the LGPL-3.0 license: http://www.opensource.org/licenses/lgpl-3.0.html
+
+	Copyright (c) 2012, Jose Esteve. http://www.joesfer.com
+
+	This library is free software; you can redistribute it and/or
+	modify it under the terms of the GNU Lesser General Public
+	License as published by the Free Software Foundation; either
+	version 3.0 of the License, or (at your option) any later version.
+
+	This library is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+	Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public
+	License along with this library; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+	================================================================================
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+#include <atomic>
+#include <string>
+
+namespace CoreLib {
+namespace Tests {
+
+	//////////////////////////////////////////////////////////////////////////
+	// Test helpers
+	//
+	// Every test is an executable registered with ctest, checking its 
+	// conditions with CORELIB_CHECK (which reports the failed expression and
+	// carries on) and returning finishTests() from main, which is non zero 
+	// if any check failed. Checks may fail from any thread.
+	//////////////////////////////////////////////////////////////////////////
+	inline std::atomic< size_t >& failureCount() {
+		static std::atomic< size_t > failures( 0 );
+		return failures;
+	}
+
+	inline void reportFailure( const std::string& message ) {
+		fprintf( stderr, "FAILED: %s\n", message.c_str() );
+		failureCount()++;
+	}
+
+	inline int finishTests( const char* name ) {
+		const size_t failures = failureCount();
+		if ( failures > 0 ) {
+			fprintf( stderr, "%s: %u checks failed\n", name, (unsigned int)failures );
+			return 1;
+		}
+		printf( "%s: all checks passed\n", name );
+		return 0;
+	}
+
+} // namespace Tests
+} // namespace CoreLib
+
+#define CORELIB_CHECK( condition ) \
+	do { \
+		if ( !( condition ) ) { \
+			CoreLib::Tests::reportFailure( std::string( __FILE__ ) + ":" + std::to_string( __LINE__ ) + ": " #condition ); \
+		} \
+	} while( false )